@@ -42,10 +42,12 @@
 
 #include <QDebug>
 #include <QBuffer>
+#include <QMutex>
 
 #include "applicationinfo.h"
 #include "exception.h"
 #include "installationreport.h"
+#include "logging.h"
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -118,13 +120,26 @@ bool AbstractApplicationInfo::isValidIcon(const QString &icon, QString &errorStr
 }
 
 //TODO Make this really unique
-static int uniqueCounter = 0;
+// atomic, since the manifest scanning creates ApplicationInfo objects in multiple threads
+static QAtomicInt uniqueCounter;
 static int nextUniqueNumber() {
-    uniqueCounter++;
-    if (uniqueCounter > 999)
-        uniqueCounter = 0;
+    int current, next;
+    do {
+        current = uniqueCounter.loadAcquire();
+        next = (current >= 999) ? 0 : current + 1;
+    } while (!uniqueCounter.testAndSetOrdered(current, next));
 
-    return uniqueCounter;
+    return next;
+}
+
+static void reserveUniqueNumber(int uniqueNumber)
+{
+    int current;
+    do {
+        current = uniqueCounter.loadAcquire();
+        if (current >= uniqueNumber)
+            return;
+    } while (!uniqueCounter.testAndSetOrdered(current, uniqueNumber));
 }
 
 AbstractApplicationInfo::AbstractApplicationInfo()
@@ -132,6 +147,11 @@ AbstractApplicationInfo::AbstractApplicationInfo()
 {
 }
 
+AbstractApplicationInfo::~AbstractApplicationInfo()
+{
+    delete m_deferredLoad.loadAcquire();
+}
+
 QString AbstractApplicationInfo::id() const
 {
     return m_id;
@@ -144,31 +164,37 @@ int AbstractApplicationInfo::uniqueNumber() const
 
 QMap<QString, QString> AbstractApplicationInfo::names() const
 {
+    ensureLoaded();
     return m_name;
 }
 
 QString AbstractApplicationInfo::name(const QString &language) const
 {
+    ensureLoaded();
     return m_name.value(language);
 }
 
 QString AbstractApplicationInfo::icon() const
 {
+    ensureLoaded();
     return m_icon;
 }
 
 QString AbstractApplicationInfo::documentUrl() const
 {
+    ensureLoaded();
     return m_documentUrl;
 }
 
 QVariantMap AbstractApplicationInfo::applicationProperties() const
 {
+    ensureLoaded();
     return m_sysAppProperties;
 }
 
 QVariantMap AbstractApplicationInfo::allAppProperties() const
 {
+    ensureLoaded();
     return m_allAppProperties;
 }
 
@@ -201,11 +227,12 @@ void AbstractApplicationInfo::read(QDataStream &ds)
        >> m_sysAppProperties
        >> m_allAppProperties;
 
-    uniqueCounter = qMax(uniqueCounter, m_uniqueNumber);
+    reserveUniqueNumber(m_uniqueNumber);
 }
 
 void AbstractApplicationInfo::writeToDataStream(QDataStream &ds) const
 {
+    ensureLoaded();
     ds << isAlias()
        << m_id
        << m_uniqueNumber
@@ -233,6 +260,67 @@ AbstractApplicationInfo *AbstractApplicationInfo::readFromDataStream(QDataStream
     return app.take();
 }
 
+AbstractApplicationInfo *AbstractApplicationInfo::createDeferred(bool isAlias, const QString &id,
+                                                                 int uniqueNumber, bool builtIn,
+                                                                 const QByteArray &data,
+                                                                 const QSharedPointer<const void> &dataOwner)
+{
+    QScopedPointer<AbstractApplicationInfo> app;
+
+    if (isAlias) {
+        app.reset(new ApplicationAliasInfo);
+    } else {
+        auto appInfo = new ApplicationInfo;
+        appInfo->m_builtIn = builtIn;
+        app.reset(appInfo);
+    }
+
+    app->m_id = id;
+    app->m_uniqueNumber = uniqueNumber;
+    reserveUniqueNumber(uniqueNumber);
+
+    app->m_deferredLoad.storeRelease(new DeferredLoad { data, dataOwner });
+    return app.take();
+}
+
+int AbstractApplicationInfo::uniqueNumberCounter()
+{
+    return uniqueCounter.loadAcquire();
+}
+
+void AbstractApplicationInfo::renumber(const QVector<AbstractApplicationInfo *> &infos, int counter)
+{
+    uniqueCounter.storeRelease(counter);
+    for (AbstractApplicationInfo *info : infos)
+        info->m_uniqueNumber = nextUniqueNumber();
+}
+
+bool AbstractApplicationInfo::isDeferred() const
+{
+    return m_deferredLoad.loadAcquire();
+}
+
+void AbstractApplicationInfo::undefer() const
+{
+    // the installer might access objects from its worker threads
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+
+    QScopedPointer<DeferredLoad> deferredLoad(m_deferredLoad.loadAcquire());
+    if (!deferredLoad)
+        return;
+
+    QDataStream ds(deferredLoad->data);
+    bool isAlias;
+    ds >> isAlias;
+    const_cast<AbstractApplicationInfo *>(this)->read(ds);
+
+    if ((ds.status() != QDataStream::Ok) || (isAlias != this->isAlias()))
+        qCWarning(LogSystem) << "Failed to load the deferred meta-data of application" << m_id;
+
+    m_deferredLoad.storeRelease(nullptr);
+}
+
 void AbstractApplicationInfo::toVariantMapHelper(QVariantMap &map) const
 {
     //TODO: check if we can find a better method to keep this as similar as possible to
@@ -240,6 +328,8 @@ void AbstractApplicationInfo::toVariantMapHelper(QVariantMap &map) const
     //      This is used for RuntimeInterface::startApplication(), ContainerInterface and
     //      ApplicationInstaller::taskRequestingInstallationAcknowledge.
 
+    ensureLoaded();
+
     map[qSL("id")] = m_id;
     map[qSL("uniqueNumber")] = m_uniqueNumber;
 
@@ -282,22 +372,26 @@ void ApplicationInfo::validate() const Q_DECL_NOEXCEPT_EXPR(false)
 
 QString ApplicationInfo::absoluteCodeFilePath() const
 {
+    ensureLoaded();
     QString code = m_codeFilePath;
     return code.isEmpty() ? QString() : QDir(codeDir()).absoluteFilePath(code);
 }
 
 QString ApplicationInfo::codeFilePath() const
 {
+    ensureLoaded();
     return m_codeFilePath;
 }
 
 QString ApplicationInfo::runtimeName() const
 {
+    ensureLoaded();
     return m_runtimeName;
 }
 
 QVariantMap ApplicationInfo::runtimeParameters() const
 {
+    ensureLoaded();
     return m_runtimeParameters;
 }
 
@@ -308,41 +402,49 @@ bool ApplicationInfo::isBuiltIn() const
 
 QStringList ApplicationInfo::capabilities() const
 {
+    ensureLoaded();
     return m_capabilities;
 }
 
 QStringList ApplicationInfo::supportedMimeTypes() const
 {
+    ensureLoaded();
     return m_mimeTypes;
 }
 
 QStringList ApplicationInfo::categories() const
 {
+    ensureLoaded();
     return m_categories;
 }
 
 QString ApplicationInfo::version() const
 {
+    ensureLoaded();
     return m_version;
 }
 
 QVariantMap ApplicationInfo::openGLConfiguration() const
 {
+    ensureLoaded();
     return m_openGLConfiguration;
 }
 
 QVariantList ApplicationInfo::intents() const
 {
+    ensureLoaded();
     return m_intents;
 }
 
 void ApplicationInfo::setBuiltIn(bool builtIn)
 {
+    ensureLoaded();
     m_builtIn = builtIn;
 }
 
 void ApplicationInfo::setSupportsApplicationInterface(bool supportsAppInterface)
 {
+    ensureLoaded();
     m_supportsApplicationInterface = supportsAppInterface;
 }
 
@@ -377,6 +479,7 @@ void ApplicationInfo::writeToDataStream(QDataStream &ds) const
 
 bool ApplicationInfo::supportsApplicationInterface() const
 {
+    ensureLoaded();
     return m_supportsApplicationInterface;
 }
 
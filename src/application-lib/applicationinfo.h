@@ -45,9 +45,12 @@
 #include <QDataStream>
 #include <QDir>
 #include <QMap>
+#include <QSharedPointer>
+#include <QAtomicPointer>
 #include <QString>
 #include <QStringList>
 #include <QVariantMap>
+#include <QVector>
 
 #include <QtAppManCommon/global.h>
 #include <QtAppManApplication/installationreport.h>
@@ -61,7 +64,7 @@ class AbstractApplicationInfo
 {
 public:
     AbstractApplicationInfo();
-    virtual ~AbstractApplicationInfo() {}
+    virtual ~AbstractApplicationInfo();
 
     QString id() const;
     int uniqueNumber() const;
@@ -83,8 +86,27 @@ public:
     static bool isValidIcon(const QString &icon, QString &errorString);
     static AbstractApplicationInfo *readFromDataStream(QDataStream &ds);
 
+    // Creates an info object that only knows its id, uniqueNumber and built-in state: all other
+    // fields are deserialized from data (as written by writeToDataStream) on first access.
+    // The memory referenced by data is kept alive via dataOwner until that happens.
+    static AbstractApplicationInfo *createDeferred(bool isAlias, const QString &id, int uniqueNumber,
+                                                   bool builtIn, const QByteArray &data,
+                                                   const QSharedPointer<const void> &dataOwner);
+    bool isDeferred() const;
+    void undefer() const;
+
+    // uniqueNumbers are handed out on construction, so objects that were created concurrently
+    // have to be renumbered in a deterministic order, starting after a saved uniqueNumberCounter()
+    static int uniqueNumberCounter();
+    static void renumber(const QVector<AbstractApplicationInfo *> &infos, int counter);
+
 protected:
     virtual void read(QDataStream &ds);
+    inline void ensureLoaded() const
+    {
+        if (Q_UNLIKELY(m_deferredLoad.loadAcquire()))
+            undefer();
+    }
 
     // static part from info.json
     QString m_id;
@@ -96,7 +118,16 @@ protected:
     QVariantMap m_sysAppProperties;
     QVariantMap m_allAppProperties;
 
+private:
+    struct DeferredLoad
+    {
+        QByteArray data; // raw data, not owned
+        QSharedPointer<const void> dataOwner;
+    };
+    mutable QAtomicPointer<DeferredLoad> m_deferredLoad;
+
     friend class YamlApplicationScanner;
+    friend class ApplicationDatabasePrivate; // needed to serialize deferred objects without loading them
 };
 
 class ApplicationAliasInfo : public AbstractApplicationInfo
@@ -114,12 +145,12 @@ public:
     void writeToDataStream(QDataStream &ds) const override;
     void validate() const Q_DECL_NOEXCEPT_EXPR(false) override;
 
-    const QDir &codeDir() const { return m_codeDir; }
+    const QDir &codeDir() const { ensureLoaded(); return m_codeDir; }
     QString absoluteCodeFilePath() const;
     QString codeFilePath() const;
     QString runtimeName() const;
     QVariantMap runtimeParameters() const;
-    QVariantMap environmentVariables() const { return m_environmentVariables; }
+    QVariantMap environmentVariables() const { ensureLoaded(); return m_environmentVariables; }
     bool isBuiltIn() const;
     QStringList capabilities() const;
     QStringList supportedMimeTypes() const;
@@ -132,12 +163,12 @@ public:
     void setSupportsApplicationInterface(bool supportsAppInterface);
     void setBuiltIn(bool builtIn);
 
-    const InstallationReport *installationReport() const { return m_installationReport.data(); }
-    void setInstallationReport(InstallationReport *report) { m_installationReport.reset(report); }
-    QString manifestDir() const { return m_manifestDir.absolutePath(); }
-    uint uid() const { return m_uid; }
-    void setManifestDir(const QString &path) { m_manifestDir = path; }
-    void setCodeDir(const QString &path) { m_codeDir = path; }
+    const InstallationReport *installationReport() const { ensureLoaded(); return m_installationReport.data(); }
+    void setInstallationReport(InstallationReport *report) { ensureLoaded(); m_installationReport.reset(report); }
+    QString manifestDir() const { ensureLoaded(); return m_manifestDir.absolutePath(); }
+    uint uid() const { ensureLoaded(); return m_uid; }
+    void setManifestDir(const QString &path) { ensureLoaded(); m_manifestDir = path; }
+    void setCodeDir(const QString &path) { ensureLoaded(); m_codeDir = path; }
 
     void toVariantMapHelper(QVariantMap &map) const override;
 
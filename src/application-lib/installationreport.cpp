@@ -181,67 +181,88 @@ bool InstallationReport::deserialize(QIODevice *from)
     m_digest.clear();
     m_files.clear();
 
-    QtYaml::ParseError error;
-    QVector<QVariant> docs = QtYaml::variantDocumentsFromYaml(from->readAll(), &error);
-
-    if (error.error != QJsonParseError::NoError)
-        return false;
-
     try {
-        checkYamlFormat(docs, 3 /*number of expected docs*/, { "am-installation-report" }, 1);
-    } catch (const Exception &) {
-        return false;
-    }
+        YamlParser p(from->readAll());
+        p.checkHeader({ "am-installation-report" }, 1);
 
-    const QVariantMap &root = docs.at(1).toMap();
+        if (!p.nextDocument())
+            throw false;
+
+        QString applicationId;
+        QString digest;
+        QString developerSignature;
+        QString storeSignature;
+        QVariantMap extra;
+        QVariantMap extraSigned;
+        bool hasExtra = false;
+        bool hasExtraSigned = false;
+
+        p.parseFields({
+            { "applicationId", true, YamlParser::Scalar, [&applicationId](YamlParser *p) {
+                applicationId = p->parseString(); } },
+            { "installationLocationId", false, YamlParser::Scalar, [this](YamlParser *p) {
+                m_installationLocationId = p->parseString(); } },
+            { "diskSpaceUsed", false, YamlParser::Scalar, [this](YamlParser *p) {
+                m_diskSpaceUsed = p->parseScalar().toULongLong(); } },
+            { "digest", true, YamlParser::Scalar, [&digest](YamlParser *p) {
+                digest = p->parseString(); } },
+            { "developerSignature", false, YamlParser::Scalar, [this](YamlParser *p) {
+                m_developerSignature = QByteArray::fromBase64(p->parseString().toLatin1());
+                if (m_developerSignature.isEmpty())
+                    throw false;
+            } },
+            { "storeSignature", false, YamlParser::Scalar, [this](YamlParser *p) {
+                m_storeSignature = QByteArray::fromBase64(p->parseString().toLatin1());
+                if (m_storeSignature.isEmpty())
+                    throw false;
+            } },
+            { "extra", false, YamlParser::Map, [this](YamlParser *p) {
+                m_extraMetaData = p->parseMap();
+                if (m_extraMetaData.isEmpty())
+                    throw false;
+            } },
+            { "extraSigned", false, YamlParser::Map, [this](YamlParser *p) {
+                m_extraSignedMetaData = p->parseMap();
+                if (m_extraSignedMetaData.isEmpty())
+                    throw false;
+            } },
+            { "files", true, YamlParser::List, [this](YamlParser *p) {
+                p->parseList([this](YamlParser *p) {
+                    m_files.append(p->parseString());
+                });
+            } }
+        });
 
-    try {
         if (m_applicationId.isEmpty()) {
-            m_applicationId = root[qSL("applicationId")].toString();
+            m_applicationId = applicationId;
             if (m_applicationId.isEmpty())
                 throw false;
-        } else if (root[qSL("applicationId")].toString() != m_applicationId) {
+        } else if (applicationId != m_applicationId) {
             throw false;
         }
 
-        m_installationLocationId = root[qSL("installationLocationId")].toString();
-        m_diskSpaceUsed = root[qSL("diskSpaceUsed")].toULongLong();
-        m_digest = QByteArray::fromHex(root[qSL("digest")].toString().toLatin1());
+        m_digest = QByteArray::fromHex(digest.toLatin1());
         if (m_digest.isEmpty())
             throw false;
-
-        auto devSig = root.find(qSL("developerSignature"));
-        if (devSig != root.end()) {
-            m_developerSignature = QByteArray::fromBase64(devSig.value().toString().toLatin1());
-            if (m_developerSignature.isEmpty())
-                throw false;
-        }
-        auto storeSig = root.find(qSL("storeSignature"));
-        if (storeSig != root.end()) {
-            m_storeSignature = QByteArray::fromBase64(storeSig.value().toString().toLatin1());
-            if (m_storeSignature.isEmpty())
-                throw false;
-        }
-        auto extra = root.find(qSL("extra"));
-        if (extra != root.end()) {
-            m_extraMetaData = extra.value().toMap();
-            if (m_extraMetaData.isEmpty())
-                throw false;
-        }
-        auto extraSigned = root.find(qSL("extraSigned"));
-        if (extraSigned != root.end()) {
-            m_extraSignedMetaData = extraSigned.value().toMap();
-            if (m_extraSignedMetaData.isEmpty())
-                throw false;
-        }
-        m_files = root[qSL("files")].toStringList();
         if (m_files.isEmpty())
             throw false;
 
-        // see if the file has been tampered with by checking the hmac
-        QByteArray hmacFile = QByteArray::fromHex(docs[2].toMap().value(qSL("hmac")).toString().toLatin1());
+        if (!p.nextDocument())
+            throw false;
+
+        QByteArray hmacFile;
+        p.parseFields({
+            { "hmac", true, YamlParser::Scalar, [&hmacFile](YamlParser *p) {
+                hmacFile = QByteArray::fromHex(p->parseString().toLatin1()); } }
+        });
+
+        if (p.nextDocument())
+            throw false;
+
+        // see if the file has been tampered with by checking the hmac: the signed documents are
+        // re-generated from the parsed values, exactly like serialize() does it
         QByteArray hmacKey = QByteArray::fromRawData((const char *) privateHmacKeyData, sizeof(privateHmacKeyData));
-        QByteArray hmacCalc= QMessageAuthenticationCode::hash(QtYaml::yamlFromVariantDocuments({ docs[0], docs[1] }, QtYaml::BlockStyle),
+        QByteArray hmacCalc= QMessageAuthenticationCode::hash(QtYaml::yamlFromVariantDocuments(signedDocuments(), QtYaml::BlockStyle),
                                                               hmacKey,
                                                               QCryptographicHash::Sha256);
 
@@ -249,20 +270,19 @@ bool InstallationReport::deserialize(QIODevice *from)
             throw false;
 
         return true;
+    } catch (const Exception &) {
     } catch (bool) {
-        m_digest.clear();
-        m_diskSpaceUsed = 0;
-        m_files.clear();
-
-        return false;
     }
+
+    m_digest.clear();
+    m_diskSpaceUsed = 0;
+    m_files.clear();
+
+    return false;
 }
 
-bool InstallationReport::serialize(QIODevice *to) const
+QVector<QVariant> InstallationReport::signedDocuments() const
 {
-    if (!isValid() || !to || !to->isWritable())
-        return false;
-
     QVariantMap header {
         { "formatVersion", 1 },
         { "formatType", "am-installation-report" }
@@ -284,13 +304,19 @@ bool InstallationReport::serialize(QIODevice *to) const
 
     root[qSL("files")] = files();
 
-    QVector<QVariant> docs;
-    docs << header;
-    docs << root;
+    return { header, root };
+}
+
+bool InstallationReport::serialize(QIODevice *to) const
+{
+    if (!isValid() || !to || !to->isWritable())
+        return false;
+
+    QVector<QVariant> docs = signedDocuments();
 
     // generate hmac to prevent tampering
     QByteArray hmacKey = QByteArray::fromRawData((const char *) privateHmacKeyData, sizeof(privateHmacKeyData));
-    QByteArray hmacCalc= QMessageAuthenticationCode::hash(QtYaml::yamlFromVariantDocuments({ docs[0], docs[1] }, QtYaml::BlockStyle),
+    QByteArray hmacCalc= QMessageAuthenticationCode::hash(QtYaml::yamlFromVariantDocuments(docs, QtYaml::BlockStyle),
                                                           hmacKey,
                                                           QCryptographicHash::Sha256);
 
@@ -46,6 +46,7 @@
 #include <QStringList>
 #include <QByteArray>
 #include <QVariantMap>
+#include <QVector>
 #include <QtAppManCommon/global.h>
 
 QT_FORWARD_DECLARE_CLASS(QIODevice)
@@ -90,6 +91,8 @@ public:
     bool serialize(QIODevice *to) const;
 
 private:
+    QVector<QVariant> signedDocuments() const;
+
     QString m_applicationId;
     QString m_installationLocationId;
     QByteArray m_digest;
@@ -57,7 +57,8 @@
 
 QT_BEGIN_NAMESPACE_AM
 
-YamlApplicationScanner::YamlApplicationScanner()
+YamlApplicationScanner::YamlApplicationScanner(YamlParser::CacheMode cacheMode)
+    : m_cacheMode(cacheMode)
 { }
 
 ApplicationInfo *YamlApplicationScanner::scan(const QString &filePath) Q_DECL_NOEXCEPT_EXPR(false)
@@ -82,23 +83,16 @@ AbstractApplicationInfo *YamlApplicationScanner::scanInternal(const QString &fil
         if (!f.open(QIODevice::ReadOnly))
             throw Exception(f, "could not open file for reading");
 
-        QtYaml::ParseError parseError;
-        QVector<QVariant> docs = QtYaml::variantDocumentsFromYaml(f.readAll(), &parseError);
-
-        if (parseError.error != QJsonParseError::NoError) {
-            throw Exception(Error::IO, "YAML parse error at line %1, column %2: %3")
-                    .arg(parseError.line).arg(parseError.column).arg(parseError.errorString());
-        }
-
+        YamlParser p(f.readAll(), filePath, m_cacheMode);
+        QString formatType;
         try {
-            checkYamlFormat(docs, 2 /*number of expected docs*/, { "am-application", "am-application-alias" }, 1);
+            formatType = p.checkHeader({ "am-application", "am-application-alias" }, 1);
         } catch (const Exception &e) {
             throw Exception(Error::Parse, "not a valid YAML application meta-data file: %1").arg(e.errorString());
         }
 
-        const auto header = docs.constFirst().toMap();
-        bool isApp = (header.value(qSL("formatType")).toString() == qL1S("am-application"));
-        bool isAlias = (header.value(qSL("formatType")).toString() == qL1S("am-application-alias"));
+        bool isApp = (formatType == qL1S("am-application"));
+        bool isAlias = (formatType == qL1S("am-application-alias"));
 
         if (!isApp && !isAlias)
             throw Exception(Error::Parse, "not a valid YAML application manifest");
@@ -117,102 +111,116 @@ AbstractApplicationInfo *YamlApplicationScanner::scanInternal(const QString &fil
             appInfo->m_codeDir = appInfo->manifestDir();
         }
 
-        QVariantMap yaml = docs.at(1).toMap();
-        for (auto it = yaml.constBegin(); it != yaml.constEnd(); ++it) {
-            QByteArray field = it.key().toLatin1();
-            bool unknownField = false;
-            const QVariant &v = it.value();
-
-            if ((!isAlias && (field == "id"))
-                    || (isAlias && (field == "aliasId"))) {
-                app->m_id = v.toString();
-                if (isAlias) {
-                    int sepPos = app->m_id.indexOf(qL1C('@'));
-                    if (sepPos < 0 || sepPos == (app->m_id.size() - 1))
-                        throw Exception(Error::Parse, "malformed aliasId '%1'").arg(app->m_id);
-                    QString realId = app->m_id.left(sepPos);
-                    if (application->id() != realId) {
-                        throw Exception(Error::Parse, "aliasId '%1' does not match base application id '%2'")
-                                .arg(app->m_id, application->id());
+        if (!p.nextDocument())
+            throw Exception(Error::Parse, "not a valid YAML application meta-data file: wrong number of YAML documents: expected 2, got 1");
+
+        // the fields are parsed directly from the YAML event stream, without building a
+        // QVariantMap for the whole document first
+        std::vector<YamlParser::Field> fields;
+        fields.emplace_back(isAlias ? "aliasId" : "id", false, YamlParser::Scalar, [&app, isAlias, application](YamlParser *p) {
+            app->m_id = p->parseString();
+            if (isAlias) {
+                int sepPos = app->m_id.indexOf(qL1C('@'));
+                if (sepPos < 0 || sepPos == (app->m_id.size() - 1))
+                    throw Exception(Error::Parse, "malformed aliasId '%1'").arg(app->m_id);
+                QString realId = app->m_id.left(sepPos);
+                if (application->id() != realId) {
+                    throw Exception(Error::Parse, "aliasId '%1' does not match base application id '%2'")
+                            .arg(app->m_id, application->id());
+                }
+            }
+        });
+        fields.emplace_back("icon", false, YamlParser::Scalar, [&app](YamlParser *p) {
+            app->m_icon = p->parseString();
+        });
+        fields.emplace_back("name", false, YamlParser::Map, [&app](YamlParser *p) {
+            auto nameMap = p->parseMap();
+            for (auto it = nameMap.constBegin(); it != nameMap.constEnd(); ++it)
+                app->m_name.insert(it.key(), it.value().toString());
+        });
+        fields.emplace_back("documentUrl", false, YamlParser::Scalar, [&app](YamlParser *p) {
+            app->m_documentUrl = p->parseString();
+        });
+
+        if (!isAlias) {
+            auto *appInfo = static_cast<ApplicationInfo*>(app.data());
+
+            fields.emplace_back("code", false, YamlParser::Scalar, [appInfo](YamlParser *p) {
+                appInfo->m_codeFilePath = p->parseString();
+            });
+            fields.emplace_back("runtime", false, YamlParser::Scalar, [appInfo](YamlParser *p) {
+                appInfo->m_runtimeName = p->parseString();
+            });
+            fields.emplace_back("runtimeParameters", false, YamlParser::Map, [appInfo](YamlParser *p) {
+                appInfo->m_runtimeParameters = p->parseMap();
+            });
+            fields.emplace_back("supportsApplicationInterface", false, YamlParser::Scalar, [appInfo](YamlParser *p) {
+                appInfo->m_supportsApplicationInterface = p->parseScalar().toBool();
+            });
+            fields.emplace_back("capabilities", false, YamlParser::Scalar | YamlParser::List, [appInfo](YamlParser *p) {
+                appInfo->m_capabilities = p->parseStringOrStringList();
+                appInfo->m_capabilities.sort();
+            });
+            fields.emplace_back("categories", false, YamlParser::Scalar | YamlParser::List, [appInfo](YamlParser *p) {
+                appInfo->m_categories = p->parseStringOrStringList();
+                appInfo->m_categories.sort();
+            });
+            fields.emplace_back("mimeTypes", false, YamlParser::Scalar | YamlParser::List, [appInfo](YamlParser *p) {
+                appInfo->m_mimeTypes = p->parseStringOrStringList();
+                appInfo->m_mimeTypes.sort();
+            });
+            fields.emplace_back("applicationProperties", false, YamlParser::Map, [appInfo](YamlParser *p) {
+                const QVariantMap rawMap = p->parseMap();
+                appInfo->m_sysAppProperties = rawMap.value(qSL("protected")).toMap();
+                appInfo->m_allAppProperties = appInfo->m_sysAppProperties;
+                const QVariantMap pri = rawMap.value(qSL("private")).toMap();
+                for (auto it = pri.cbegin(); it != pri.cend(); ++it)
+                    appInfo->m_allAppProperties.insert(it.key(), it.value());
+            });
+            fields.emplace_back("version", false, YamlParser::Scalar, [appInfo](YamlParser *p) {
+                appInfo->m_version = p->parseString();
+            });
+            fields.emplace_back("opengl", false, YamlParser::Map, [appInfo](YamlParser *p) {
+                appInfo->m_openGLConfiguration = p->parseMap();
+
+                // sanity check
+                static QStringList validKeys = {
+                    qSL("desktopProfile"),
+                    qSL("esMajorVersion"),
+                    qSL("esMinorVersion")
+                };
+                for (auto it = appInfo->m_openGLConfiguration.cbegin();
+                          it != appInfo->m_openGLConfiguration.cend(); ++it) {
+                    if (!validKeys.contains(it.key())) {
+                        throw Exception(Error::Parse, "the 'opengl' object contains the unsupported key '%1'")
+                                                      .arg(it.key());
                     }
                 }
-            } else if (field == "icon") {
-                app->m_icon = v.toString();
-            } else if (field == "name") {
-                auto nameMap = v.toMap();
-                for (auto it = nameMap.constBegin(); it != nameMap.constEnd(); ++it)
-                    app->m_name.insert(it.key(), it.value().toString());
-            } else if (field == "documentUrl") {
-                app->m_documentUrl = v.toString();
-            } else if (!isAlias) {
-                auto *appInfo = static_cast<ApplicationInfo*>(app.data());
-                if (field == "code") {
-                    appInfo->m_codeFilePath = v.toString();
-                } else if (field == "runtime") {
-                    appInfo->m_runtimeName = v.toString();
-                } else if (field == "runtimeParameters") {
-                    appInfo->m_runtimeParameters = v.toMap();
-                }  else if (field == "supportsApplicationInterface") {
-                    appInfo->m_supportsApplicationInterface = v.toBool();
-                } else if (field == "capabilities") {
-                    appInfo->m_capabilities = variantToStringList(v);
-                    appInfo->m_capabilities.sort();
-                } else if (field == "categories") {
-                    appInfo->m_categories = variantToStringList(v);
-                    appInfo->m_categories.sort();
-                } else if (field == "mimeTypes") {
-                    appInfo->m_mimeTypes = variantToStringList(v);
-                    appInfo->m_mimeTypes.sort();
-                } else if (field == "applicationProperties") {
-                    const QVariantMap rawMap = v.toMap();
-                    appInfo->m_sysAppProperties = rawMap.value(qSL("protected")).toMap();
-                    appInfo->m_allAppProperties = appInfo->m_sysAppProperties;
-                    const QVariantMap pri = rawMap.value(qSL("private")).toMap();
-                    for (auto it = pri.cbegin(); it != pri.cend(); ++it)
-                        appInfo->m_allAppProperties.insert(it.key(), it.value());
-                } else if (field == "version") {
-                    appInfo->m_version = v.toString();
-                } else if (field == "opengl") {
-                    appInfo->m_openGLConfiguration = v.toMap();
+            });
+            fields.emplace_back("logging", false, YamlParser::Map, [appInfo](YamlParser *p) {
+                const QVariantMap logging = p->parseMap();
+                if (!logging.isEmpty()) {
+                    if (logging.size() > 1 || logging.firstKey() != qSL("dlt"))
+                        throw Exception(Error::Parse, "'logging' only supports the 'dlt' key");
+                    appInfo->m_dlt = logging.value(qSL("dlt")).toMap();
 
                     // sanity check
-                    static QStringList validKeys = {
-                        qSL("desktopProfile"),
-                        qSL("esMajorVersion"),
-                        qSL("esMinorVersion")
-                    };
-                    for (auto it = appInfo->m_openGLConfiguration.cbegin();
-                              it != appInfo->m_openGLConfiguration.cend(); ++it) {
-                        if (!validKeys.contains(it.key())) {
-                            throw Exception(Error::Parse, "the 'opengl' object contains the unsupported key '%1'")
-                                                          .arg(it.key());
-                        }
+                    for (auto it = appInfo->m_dlt.cbegin(); it != appInfo->m_dlt.cend(); ++it) {
+                        if (it.key() != qSL("id") && it.key() != qSL("description"))
+                            throw Exception(Error::Parse, "unsupported key in 'logging/dlt'");
                     }
-                } else if (field == "logging") {
-                    const QVariantMap logging = v.toMap();
-                    if (!logging.isEmpty()) {
-                        if (logging.size() > 1 || logging.firstKey() != qSL("dlt"))
-                            throw Exception(Error::Parse, "'logging' only supports the 'dlt' key");
-                        appInfo->m_dlt = logging.value(qSL("dlt")).toMap();
-
-                        // sanity check
-                        for (auto it = appInfo->m_dlt.cbegin(); it != appInfo->m_dlt.cend(); ++it) {
-                            if (it.key() != qSL("id") && it.key() != qSL("description"))
-                                throw Exception(Error::Parse, "unsupported key in 'logging/dlt'");
-                        }
-                     }
-                } else if (field == "intents") {
-                    appInfo->m_intents = v.toList();
-                } else {
-                    unknownField = true;
-                }
-            } else {
-                unknownField = true;
-            }
-            if (unknownField)
-                throw Exception(Error::Parse, "contains unsupported field: '%1'").arg(field);
+                 }
+            });
+            fields.emplace_back("intents", false, YamlParser::List, [appInfo](YamlParser *p) {
+                appInfo->m_intents = p->parseList();
+            });
         }
 
+        p.parseFields(fields);
+
+        if (p.nextDocument())
+            throw Exception(Error::Parse, "not a valid YAML application meta-data file: wrong number of YAML documents: expected 2, got more");
+
         app->validate();
         return app.take();
     } catch (const Exception &e) {
@@ -43,6 +43,7 @@
 #pragma once
 
 #include <QtAppManApplication/applicationscanner.h>
+#include <QtAppManCommon/qtyaml.h>
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -51,7 +52,7 @@ class AbstractApplicationInfo;
 class YamlApplicationScanner : public ApplicationScanner
 {
 public:
-    YamlApplicationScanner();
+    YamlApplicationScanner(YamlParser::CacheMode cacheMode = YamlParser::UseCache);
 
     ApplicationInfo *scan(const QString &filePath) Q_DECL_NOEXCEPT_EXPR(false) override;
     ApplicationAliasInfo *scanAlias(const QString &filePath,
@@ -62,6 +63,8 @@ public:
 private:
     AbstractApplicationInfo *scanInternal(const QString &filePath, bool scanAlias,
                                           const ApplicationInfo *application) Q_DECL_NOEXCEPT_EXPR(false);
+
+    YamlParser::CacheMode m_cacheMode;
 };
 
 QT_END_NAMESPACE_AM
@@ -43,7 +43,8 @@ HEADERS += \
     unixsignalhandler.h \
     processtitle.h \
     crashhandler.h \
-    logging.h
+    logging.h \
+    zygoteprotocol.h
 
 qtHaveModule(qml):HEADERS += \
     qml-utilities.h \
@@ -40,20 +40,245 @@
 **
 ****************************************************************************/
 
+#include <algorithm>
+
 #include <QVariant>
-#include <QRegExp>
+#include <QVarLengthArray>
 #include <QDebug>
 #include <QtNumeric>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QAtomicInt>
 
 #include <yaml.h>
 
 #include "global.h"
 #include "qtyaml.h"
+#include "exception.h"
+#include "utilities.h"
 
 QT_BEGIN_NAMESPACE
 
 namespace QtYaml {
 
+static inline bool isYamlDigit(char c, int base)
+{
+    switch (base) {
+    case 2:  return (c == '0') || (c == '1');
+    case 8:  return (c >= '0') && (c <= '7');
+    case 10: return (c >= '0') && (c <= '9');
+    case 16: return ((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f')) || ((c >= 'A') && (c <= 'F'));
+    default: return false;
+    }
+}
+
+// all characters are either digits or the _ grouping separator
+static inline bool isYamlDigitSequence(const char *begin, const char *end, int base)
+{
+    if (begin == end)
+        return false;
+    for (const char *p = begin; p != end; ++p) {
+        if ((*p != '_') && !isYamlDigit(*p, base))
+            return false;
+    }
+    return true;
+}
+
+// ([0-9][0-9_]*)?\.[0-9.]*([eE][-+][0-9]+)?
+static bool isYamlFloat(const char *p, const char *end)
+{
+    if ((p != end) && isYamlDigit(*p, 10)) {
+        while ((++p != end) && ((*p == '_') || isYamlDigit(*p, 10)))
+            ;
+    }
+    if ((p == end) || (*p != '.'))
+        return false;
+    while ((++p != end) && ((*p == '.') || isYamlDigit(*p, 10)))
+        ;
+    if (p == end)
+        return true;
+    if ((*p != 'e' && *p != 'E') || (++p == end) || (*p != '-' && *p != '+') || (++p == end))
+        return false;
+    for ( ; p != end; ++p) {
+        if (!isYamlDigit(*p, 10))
+            return false;
+    }
+    return true;
+}
+
+// Converts YAML 1.1 numbers: integers in binary (0b), octal (0), decimal and hexadecimal (0x)
+// notation and floats, all with an optional sign and _ as grouping separator. The special float
+// values (.inf, .nan) have already been handled by the caller.
+// Integers are returned as the smallest fitting type (qint32, qint64 or quint64). An invalid
+// QVariant is returned for everything that is not a number or that cannot be represented, in
+// which case the scalar is treated as a string.
+static QVariant numberFromYamlScalar(const char *begin, const char *end)
+{
+    const char *p = begin;
+    bool negative = false;
+    if ((p != end) && (*p == '+' || *p == '-'))
+        negative = (*p++ == '-');
+    if (p == end)
+        return QVariant();
+
+    int base = 0;
+    const char *digits = p;
+
+    if ((*p == '0') && ((end - p) > 1)) {
+        if (p[1] == 'b' && isYamlDigitSequence(p + 2, end, 2)) {
+            base = 2;
+            digits = p + 2;
+        } else if (p[1] == 'x' && isYamlDigitSequence(p + 2, end, 16)) {
+            base = 16;
+            digits = p + 2;
+        } else if (isYamlDigitSequence(p + 1, end, 8)) {
+            base = 8;
+        }
+    } else if ((*p == '0') || ((*p != '_') && isYamlDigitSequence(p, end, 10))) {
+        base = 10;
+    }
+
+    if (base) {
+        quint64 value = 0;
+        bool hasDigits = false;
+
+        for (const char *d = digits; d != end; ++d) {
+            if (*d == '_')
+                continue;
+            int digit = (*d <= '9') ? (*d - '0') : ((*d | 0x20) - 'a' + 10);
+            if (value > ((std::numeric_limits<quint64>::max() - quint64(digit)) / quint64(base)))
+                return QVariant(); // overflow
+            value = value * quint64(base) + quint64(digit);
+            hasDigits = true;
+        }
+        if (!hasDigits)
+            return QVariant();
+
+        if (negative) {
+            const quint64 minValue = quint64(std::numeric_limits<qint64>::max()) + 1;
+            if (value > minValue)
+                return QVariant();
+            qint64 s64 = (value == minValue) ? std::numeric_limits<qint64>::min() : -qint64(value);
+            return qint32(s64);
+        } else if (value <= quint64(std::numeric_limits<qint32>::max())) {
+            return qint32(value);
+        } else if (value <= quint64(std::numeric_limits<qint64>::max())) {
+            return qint64(value);
+        } else {
+            return value;
+        }
+    }
+
+    if (isYamlFloat(p, end)) {
+        // strip the grouping separators, but avoid any allocations for the typical short numbers
+        QVarLengthArray<char, 64> number;
+        for (const char *c = begin; c != end; ++c) {
+            if (*c != '_')
+                number.append(*c);
+        }
+        bool ok = false;
+        double d = QByteArray::fromRawData(number.constData(), number.size()).toDouble(&ok);
+        if (ok)
+            return d;
+    }
+    return QVariant();
+}
+
+// converts a plain or quoted scalar according to the YAML 1.1 rules (the data must be
+// 0-terminated, which libyaml guarantees)
+static QVariant convertYamlScalar(const QByteArray &ba, bool quoted)
+{
+    if (quoted)
+        return QString::fromUtf8(ba);
+
+    enum ValueIndex {
+        ValueNull,
+        ValueTrue,
+        ValueFalse,
+        ValueNaN,
+        ValueInf
+    };
+
+    struct StaticMapping
+    {
+        const char *text;
+        ValueIndex index;
+    };
+
+    static QVariant staticValues[] = {
+        QVariant(),                    // ValueNull
+        QVariant(true),                // ValueTrue
+        QVariant(false),               // ValueFalse
+        QVariant(qQNaN()),             // ValueNaN
+        QVariant(qInf()),              // ValueInf
+    };
+
+    static const StaticMapping staticMappings[] = { // keep this sorted for bsearch !!
+        { "",      ValueNull },
+        { ".INF",  ValueInf },
+        { ".Inf",  ValueInf },
+        { ".NAN",  ValueNaN },
+        { ".NaN",  ValueNaN },
+        { ".inf",  ValueInf },
+        { ".nan",  ValueNaN },
+        { "FALSE", ValueFalse },
+        { "False", ValueFalse },
+        { "N",     ValueFalse },
+        { "NO",    ValueFalse },
+        { "NULL",  ValueNull },
+        { "No",    ValueFalse },
+        { "Null",  ValueNull },
+        { "OFF",   ValueFalse },
+        { "Off",   ValueFalse },
+        { "ON",    ValueTrue },
+        { "On",    ValueTrue },
+        { "TRUE",  ValueTrue },
+        { "True",  ValueTrue },
+        { "Y",     ValueTrue },
+        { "YES",   ValueTrue },
+        { "Yes",   ValueTrue },
+        { "false", ValueFalse },
+        { "n",     ValueFalse },
+        { "no",    ValueFalse },
+        { "null",  ValueNull },
+        { "off",   ValueFalse },
+        { "on",    ValueTrue },
+        { "true",  ValueTrue },
+        { "y",     ValueTrue },
+        { "yes",   ValueTrue },
+        { "~",     ValueNull }
+    };
+
+    static const char *firstCharStaticMappings = ".FNOTYfnoty~";
+    char firstChar = ba.isEmpty() ? 0 : ba.at(0);
+
+    if (strchr(firstCharStaticMappings, firstChar)) { // cheap check to avoid expensive bsearch
+        StaticMapping key { ba.constData(), ValueNull };
+        auto found = bsearch(&key,
+                             staticMappings,
+                             sizeof(staticMappings)/sizeof(staticMappings[0]),
+                sizeof(staticMappings[0]),
+                [](const void *m1, const void *m2) {
+            return strcmp(static_cast<const StaticMapping *>(m1)->text,
+                          static_cast<const StaticMapping *>(m2)->text); });
+
+        if (found)
+            return staticValues[static_cast<StaticMapping *>(found)->index];
+    }
+
+    if ((firstChar >= '0' && firstChar <= '9')   // cheap check to avoid the number parser
+            || firstChar == '+' || firstChar == '-' || firstChar == '.') {
+        QVariant number = numberFromYamlScalar(ba.constData(), ba.constData() + ba.size());
+        if (number.isValid())
+            return number;
+    }
+    return QString::fromUtf8(ba);
+}
+
 static QVariant convertYamlNodeToVariant(yaml_document_t *doc, yaml_node_t *node, std::function<QVariant (const QVariant &)> &filter)
 {
     QVariant result;
@@ -64,151 +289,12 @@ static QVariant convertYamlNodeToVariant(yaml_document_t *doc, yaml_node_t *node
         return result;
 
     switch (node->type) {
-    case YAML_SCALAR_NODE: {
-        const QByteArray ba = QByteArray::fromRawData(reinterpret_cast<const char *>(node->data.scalar.value),
-                                                int(node->data.scalar.length));
-
-        if (node->data.scalar.style == YAML_SINGLE_QUOTED_SCALAR_STYLE
-                || node->data.scalar.style == YAML_DOUBLE_QUOTED_SCALAR_STYLE) {
-            result = QString::fromUtf8(ba);
-            break;
-        }
-
-        enum ValueIndex {
-            ValueNull,
-            ValueTrue,
-            ValueFalse,
-            ValueNaN,
-            ValueInf
-        };
-
-        struct StaticMapping
-        {
-            const char *text;
-            ValueIndex index;
-        };
-
-        static QVariant staticValues[] = {
-            QVariant(),                    // ValueNull
-            QVariant(true),                // ValueTrue
-            QVariant(false),               // ValueFalse
-            QVariant(qQNaN()),             // ValueNaN
-            QVariant(qInf()),              // ValueInf
-        };
-
-        static const StaticMapping staticMappings[] = { // keep this sorted for bsearch !!
-            { "",      ValueNull },
-            { ".INF",  ValueInf },
-            { ".Inf",  ValueInf },
-            { ".NAN",  ValueNaN },
-            { ".NaN",  ValueNaN },
-            { ".inf",  ValueInf },
-            { ".nan",  ValueNaN },
-            { "FALSE", ValueFalse },
-            { "False", ValueFalse },
-            { "N",     ValueFalse },
-            { "NO",    ValueFalse },
-            { "NULL",  ValueNull },
-            { "No",    ValueFalse },
-            { "Null",  ValueNull },
-            { "OFF",   ValueFalse },
-            { "Off",   ValueFalse },
-            { "ON",    ValueTrue },
-            { "On",    ValueTrue },
-            { "TRUE",  ValueTrue },
-            { "True",  ValueTrue },
-            { "Y",     ValueTrue },
-            { "YES",   ValueTrue },
-            { "Yes",   ValueTrue },
-            { "false", ValueFalse },
-            { "n",     ValueFalse },
-            { "no",    ValueFalse },
-            { "null",  ValueNull },
-            { "off",   ValueFalse },
-            { "on",    ValueTrue },
-            { "true",  ValueTrue },
-            { "y",     ValueTrue },
-            { "yes",   ValueTrue },
-            { "~",     ValueNull }
-        };
-
-        static const char *firstCharStaticMappings = ".FNOTYfnoty~";
-        char firstChar = ba.isEmpty() ? 0 : ba.at(0);
-
-        if (strchr(firstCharStaticMappings, firstChar)) { // cheap check to avoid expensive bsearch
-            StaticMapping key { ba.constData(), ValueNull };
-            auto found = bsearch(&key,
-                                 staticMappings,
-                                 sizeof(staticMappings)/sizeof(staticMappings[0]),
-                    sizeof(staticMappings[0]),
-                    [](const void *m1, const void *m2) {
-                return strcmp(static_cast<const StaticMapping *>(m1)->text,
-                              static_cast<const StaticMapping *>(m2)->text); });
-
-            if (found) {
-                result = staticValues[static_cast<StaticMapping *>(found)->index];
-                break;
-            }
-        }
-
-        QString str = QString::fromUtf8(ba);
-        result = str;
-
-        if ((firstChar >= '0' && firstChar <= '9')   // cheap check to avoid expensive regexps
-                || firstChar == '+' || firstChar == '-' || firstChar == '.') {
-            static const QRegExp numberRegExps[] = {
-                QRegExp(qSL("[-+]?0b[0-1_]+")),        // binary
-                QRegExp(qSL("[-+]?0x[0-9a-fA-F_]+")),  // hexadecimal
-                QRegExp(qSL("[-+]?0[0-7_]+")),         // octal
-                QRegExp(qSL("[-+]?(0|[1-9][0-9_]*)")), // decimal
-                QRegExp(qSL("[-+]?([0-9][0-9_]*)?\\.[0-9.]*([eE][-+][0-9]+)?")), // float
-                QRegExp()
-            };
-
-            for (int numberIndex = 0; !numberRegExps[numberIndex].isEmpty(); ++numberIndex) {
-                if (numberRegExps[numberIndex].exactMatch(str)) {
-                    bool ok = false;
-                    QVariant val;
-
-                    // YAML allows _ as a grouping separator
-                    if (str.contains(qL1C('_')))
-                        str = str.replace(qL1C('_'), qSL(""));
-
-                    if (numberIndex == 4) {
-                        val = str.toDouble(&ok);
-                    } else {
-                        int base = 10;
-
-                        switch (numberIndex) {
-                        case 0: base = 2; str.replace(qSL("0b"), qSL("")); break; // Qt chokes on 0b
-                        case 1: base = 16; break;
-                        case 2: base = 8; break;
-                        case 3: base = 10; break;
-                        }
-
-                        qint64 s64 = str.toLongLong(&ok, base);
-                        if (ok && (s64 <= std::numeric_limits<qint32>::max())) {
-                            val = qint32(s64);
-                        } else if (ok) {
-                            val = s64;
-                        } else {
-                            quint64 u64 = str.toULongLong(&ok, base);
-
-                            if (ok && (u64 <= std::numeric_limits<quint32>::max()))
-                                val = quint32(u64);
-                            else if (ok)
-                                val = u64;
-                        }
-                    }
-                    if (ok) {
-                        result = val;
-                        break;
-                    }
-                }
-            }
-        }
+    case YAML_SCALAR_NODE:
+        result = convertYamlScalar(QByteArray::fromRawData(reinterpret_cast<const char *>(node->data.scalar.value),
+                                                           int(node->data.scalar.length)),
+                                   node->data.scalar.style == YAML_SINGLE_QUOTED_SCALAR_STYLE
+                                   || node->data.scalar.style == YAML_DOUBLE_QUOTED_SCALAR_STYLE);
         break;
-    }
     case YAML_SEQUENCE_NODE: {
         QVariantList array;
         for (auto seq = node->data.sequence.items.start; seq < node->data.sequence.items.top; ++seq) {
@@ -421,3 +507,572 @@ QByteArray yamlFromVariantDocuments(const QVector<QVariant> &documents, YamlStyl
 } // namespace QtYaml
 
 QT_END_NAMESPACE
+
+QT_BEGIN_NAMESPACE_AM
+
+// the cache entries start with this magic: change it, whenever the format of the entries changes
+static const char YamlCacheMagic[] = "qtam-yaml-events-2";
+
+static QString yamlCacheDirectory()
+{
+    // the cache is shared between all processes of the same user: all entries are immutable,
+    // since their file names are derived from the content they were parsed from. Nobody else
+    // is allowed to write to it, since the replayed events are trusted just like the content.
+    static const QString dir = []() -> QString {
+        if (qEnvironmentVariableIsSet("AM_NO_YAML_CACHE"))
+            return QString();
+        const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+        if (cacheLocation.isEmpty())
+            return QString();
+        QDir d(cacheLocation + qSL("/qtapplicationmanager/yaml"));
+        if (!d.mkpath(qSL(".")))
+            return QString();
+        // this fails, if the directory is owned by someone else
+        const auto ownerOnly = QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner;
+        if (!QFile::setPermissions(d.absolutePath(), ownerOnly))
+            return QString();
+        return d.absolutePath() + qL1C('/');
+    }();
+    return dir;
+}
+
+// The cache is bounded, since it can see a lot of different content over time (e.g. after every
+// update of an application). The modification time of an entry is refreshed when it is used,
+// so the least recently used entries are removed first.
+static const int YamlCacheMaxAgeDays = 30;
+static const qint64 YamlCacheMaxSize = 32 * 1024 * 1024;
+// protection against "billion laughs" style documents built from nested aliases
+static const int YamlMaxAliasExpansionSize = 16 * 1024 * 1024;
+
+static void pruneYamlCache()
+{
+    // once per process is enough: this is only called before adding a new entry
+    static QAtomicInt pruned;
+    if (!pruned.testAndSetRelaxed(0, 1))
+        return;
+
+    const QDateTime oldest = QDateTime::currentDateTimeUtc().addDays(-YamlCacheMaxAgeDays);
+    qint64 size = 0;
+
+    const QFileInfoList entries = QDir(yamlCacheDirectory()).entryInfoList(QDir::Files, QDir::Time);
+    for (const QFileInfo &fi : entries) { // most recently used first
+        size += fi.size();
+        if ((size > YamlCacheMaxSize) || (fi.lastModified() < oldest))
+            QFile::remove(fi.absoluteFilePath());
+    }
+}
+
+static inline void appendVarInt(QByteArray &ba, quint32 value)
+{
+    while (value >= 0x80) {
+        ba.append(char(value | 0x80));
+        value >>= 7;
+    }
+    ba.append(char(value));
+}
+
+static inline bool readVarInt(const char *&pos, const char *end, quint32 &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        if (pos == end)
+            return false;
+        uchar c = uchar(*pos++);
+        value |= quint32(c & 0x7f) << shift;
+        if (!(c & 0x80))
+            return true;
+    }
+    return false;
+}
+
+class YamlParserPrivate
+{
+public:
+    QByteArray data;
+    QString sourcePath;
+    bool initError = false;
+
+    // the events either come from libyaml ...
+    bool parserInitialized = false;
+    yaml_parser_t parser;
+    yaml_event_t event;
+    bool hasEvent = false;
+
+    // ... or they are replayed from a cache entry
+    QByteArray cachedEvents;
+    const char *replayPos = nullptr;
+    const char *replayEnd = nullptr;
+
+    // aliases are resolved by replaying the recorded events of the anchored node
+    struct AnchorRecording
+    {
+        QByteArray name;
+        QByteArray events;
+        int depth;
+    };
+    QVector<AnchorRecording> activeAnchors;
+    QHash<QByteArray, QByteArray> anchors;
+    QByteArray aliasEvents;
+    const char *aliasPos = nullptr;
+    const char *aliasEnd = nullptr;
+    int aliasExpansionSize = 0;
+
+    // the events coming from libyaml are recorded for the cache (with all aliases resolved)
+    bool recording = false;
+    QByteArray recordedEvents;
+    QString cacheFilePath;
+
+    // the current event
+    int type = YAML_NO_EVENT;
+    QByteArray scalar; // always 0-terminated
+    bool quoted = false;
+    int line = -1;
+    int column = -1;
+
+    // Each event is stored as its type, line and column, followed by the quoting flag, the
+    // length and the 0-terminated data in case of a scalar.
+    void encodeEvent(QByteArray &ba) const
+    {
+        ba.append(char(type));
+        appendVarInt(ba, quint32(line));
+        appendVarInt(ba, quint32(column));
+        if (type == YAML_SCALAR_EVENT) {
+            ba.append(char(quoted ? 1 : 0));
+            appendVarInt(ba, quint32(scalar.size()));
+            ba.append(scalar.constData(), scalar.size() + 1);
+        }
+    }
+
+    // adds the current event to all anchored nodes that are still open
+    void recordAnchoredEvent()
+    {
+        for (int i = activeAnchors.size() - 1; i >= 0; --i) {
+            AnchorRecording &ar = activeAnchors[i];
+            encodeEvent(ar.events);
+
+            if ((type == YAML_SEQUENCE_START_EVENT) || (type == YAML_MAPPING_START_EVENT))
+                ++ar.depth;
+            else if ((type == YAML_SEQUENCE_END_EVENT) || (type == YAML_MAPPING_END_EVENT))
+                --ar.depth;
+
+            if (ar.depth == 0) { // only the innermost anchors can be complete
+                anchors.insert(ar.name, ar.events);
+                activeAnchors.removeAt(i);
+            }
+        }
+    }
+
+    static bool decodeEvent(const char *&pos, const char *end, int &type, QByteArray &scalar,
+                            bool &quoted, int &line, int &column)
+    {
+        quint32 l, c;
+        if ((pos == end) || (*pos <= YAML_NO_EVENT) || (*pos > YAML_MAPPING_END_EVENT))
+            return false;
+        type = *pos++;
+        if (!readVarInt(pos, end, l) || !readVarInt(pos, end, c))
+            return false;
+        line = int(l);
+        column = int(c);
+        if (type == YAML_SCALAR_EVENT) {
+            quint32 size;
+            if (pos == end)
+                return false;
+            quoted = (*pos++ != 0);
+            if (!readVarInt(pos, end, size))
+                return false;
+            if ((quint32(end - pos) <= size) || (pos[size] != 0))
+                return false;
+            scalar = QByteArray::fromRawData(pos, int(size));
+            pos += size + 1;
+        }
+        return true;
+    }
+};
+
+
+YamlParser::YamlParser(const QByteArray &data, const QString &sourcePath, CacheMode cacheMode)
+    : d(new YamlParserPrivate)
+{
+    d->data = data;
+    d->sourcePath = sourcePath;
+
+    const QString cacheDir = (cacheMode == UseCache) ? yamlCacheDirectory() : QString();
+    if (!cacheDir.isEmpty()) {
+        const QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+        d->cacheFilePath = cacheDir + QString::fromLatin1(hash.toHex());
+
+        // the entry starts with the magic and the hash of the content it was parsed from
+        QByteArray header(YamlCacheMagic, sizeof(YamlCacheMagic));
+        header.append(hash);
+
+        QFile cacheFile(d->cacheFilePath);
+        if (cacheFile.open(QIODevice::ReadOnly)) {
+            QByteArray cachedEvents = cacheFile.readAll();
+
+            // verify the complete entry upfront: we cannot fall back to libyaml mid-stream
+            if (cachedEvents.startsWith(header)) {
+                const char *begin = cachedEvents.constData() + header.size();
+                const char *end = cachedEvents.constData() + cachedEvents.size();
+                const char *pos = begin;
+                int type = YAML_NO_EVENT;
+                QByteArray scalar;
+                bool quoted;
+                int line, column;
+
+                while ((type != YAML_STREAM_END_EVENT)
+                       && YamlParserPrivate::decodeEvent(pos, end, type, scalar, quoted, line, column)) {
+                }
+                if ((type == YAML_STREAM_END_EVENT) && (pos == end)) {
+                    const QDateTime now = QDateTime::currentDateTimeUtc();
+                    if (cacheFile.fileTime(QFileDevice::FileModificationTime).daysTo(now) > 0)
+                        cacheFile.setFileTime(now, QFileDevice::FileModificationTime);
+
+                    d->cachedEvents = cachedEvents;
+                    d->replayPos = begin;
+                    d->replayEnd = end;
+                    return;
+                }
+            }
+        }
+        d->recording = true;
+        d->recordedEvents.reserve(data.size() + header.size());
+        d->recordedEvents.append(header);
+    }
+
+    if (yaml_parser_initialize(&d->parser)) {
+        d->parserInitialized = true;
+        yaml_parser_set_input_string(&d->parser, reinterpret_cast<const uchar *>(d->data.constData()),
+                                     static_cast<size_t>(d->data.size()));
+    } else {
+        d->initError = true;
+    }
+}
+
+YamlParser::~YamlParser()
+{
+    if (d->hasEvent)
+        yaml_event_delete(&d->event);
+    if (d->parserInitialized)
+        yaml_parser_delete(&d->parser);
+    delete d;
+}
+
+QString YamlParser::sourcePath() const
+{
+    return d->sourcePath;
+}
+
+QPair<QString, int> YamlParser::parseHeader()
+{
+    if (!nextDocument())
+        throw Exception("wrong number of YAML documents: expected at least 1, got 0");
+
+    // be as lenient as checkYamlFormat() regarding additional fields in the header
+    const QVariantMap header = parseMap();
+    return qMakePair(header.value(qSL("formatType")).toString(),
+                     header.value(qSL("formatVersion")).toInt());
+}
+
+QString YamlParser::checkHeader(const QVector<QByteArray> &formatTypes, int formatVersion)
+{
+    auto header = parseHeader();
+
+    if (!formatTypes.contains(header.first.toUtf8())) {
+        throw Exception("wrong formatType header: expected %1, got %2")
+            .arg(QString::fromUtf8(formatTypes.toList().join(", or ")), header.first);
+    }
+    if (header.second != formatVersion) {
+        throw Exception("wrong formatVersion header: expected %1, got %2")
+                .arg(formatVersion).arg(header.second);
+    }
+    return header.first;
+}
+
+bool YamlParser::nextDocument()
+{
+    while (d->type != YAML_STREAM_END_EVENT) {
+        nextEvent();
+        if (d->type == YAML_DOCUMENT_START_EVENT) {
+            nextEvent(); // the root node
+            return true;
+        }
+    }
+    return false;
+}
+
+void YamlParser::nextEvent()
+{
+    if (d->type == YAML_STREAM_END_EVENT)
+        throwParseError(qSL("unexpected end of the YAML stream"));
+
+    if (d->replayPos) {
+        // the entry has been verified in the constructor already
+        YamlParserPrivate::decodeEvent(d->replayPos, d->replayEnd, d->type, d->scalar, d->quoted,
+                                       d->line, d->column);
+        return;
+    }
+
+    if (d->aliasPos) {
+        // the anchored events have been encoded by ourselves, so they are always valid
+        YamlParserPrivate::decodeEvent(d->aliasPos, d->aliasEnd, d->type, d->scalar, d->quoted,
+                                       d->line, d->column);
+        if (d->aliasPos == d->aliasEnd)
+            d->aliasPos = d->aliasEnd = nullptr;
+    } else {
+        if (d->initError)
+            throw Exception(Error::Parse, "could not initialize YAML parser");
+
+        if (d->hasEvent) {
+            yaml_event_delete(&d->event);
+            d->hasEvent = false;
+        }
+        if (!yaml_parser_parse(&d->parser, &d->event)) {
+            if (d->parser.error == YAML_READER_ERROR) {
+                throw Exception(Error::Parse, "YAML parse error at offset %1: %2")
+                        .arg(qulonglong(d->parser.problem_offset)).arg(QString::fromLocal8Bit(d->parser.problem));
+            } else {
+                throw Exception(Error::Parse, "YAML parse error at line %1, column %2: %3")
+                        .arg(d->parser.problem_mark.line + 1).arg(d->parser.problem_mark.column)
+                        .arg(QString::fromLocal8Bit(d->parser.problem));
+            }
+        }
+        d->hasEvent = true;
+        d->type = d->event.type;
+        d->line = int(d->event.start_mark.line) + 1;
+        d->column = int(d->event.start_mark.column);
+
+        const yaml_char_t *anchor = nullptr;
+
+        switch (d->type) {
+        case YAML_DOCUMENT_START_EVENT:
+            // anchors are scoped to their document
+            d->anchors.clear();
+            break;
+        case YAML_SCALAR_EVENT:
+            // libyaml 0-terminates all scalars
+            d->scalar = QByteArray::fromRawData(reinterpret_cast<const char *>(d->event.data.scalar.value),
+                                                int(d->event.data.scalar.length));
+            d->quoted = (d->event.data.scalar.style == YAML_SINGLE_QUOTED_SCALAR_STYLE)
+                    || (d->event.data.scalar.style == YAML_DOUBLE_QUOTED_SCALAR_STYLE);
+            anchor = d->event.data.scalar.anchor;
+            break;
+        case YAML_SEQUENCE_START_EVENT:
+            anchor = d->event.data.sequence_start.anchor;
+            break;
+        case YAML_MAPPING_START_EVENT:
+            anchor = d->event.data.mapping_start.anchor;
+            break;
+        case YAML_ALIAS_EVENT: {
+            const QByteArray name(reinterpret_cast<const char *>(d->event.data.alias.anchor));
+            auto it = d->anchors.constFind(name);
+            if (it == d->anchors.cend())
+                throwParseError(qSL("unknown YAML alias '%1'").arg(QString::fromUtf8(name)));
+
+            d->aliasExpansionSize += it->size();
+            if (d->aliasExpansionSize > YamlMaxAliasExpansionSize)
+                throwParseError(qSL("YAML aliases expand to more than %1 bytes").arg(YamlMaxAliasExpansionSize));
+
+            // replace the alias with the first event of the anchored node and queue the rest
+            d->aliasEvents = *it;
+            d->aliasPos = d->aliasEvents.constData();
+            d->aliasEnd = d->aliasPos + d->aliasEvents.size();
+            nextEvent();
+            return;
+        }
+        default:
+            break;
+        }
+
+        if (anchor) {
+            d->activeAnchors.append({ QByteArray(reinterpret_cast<const char *>(anchor)),
+                                      QByteArray(), 0 });
+        }
+    }
+
+    if (!d->activeAnchors.isEmpty())
+        d->recordAnchoredEvent();
+
+    if (d->recording) {
+        d->encodeEvent(d->recordedEvents);
+
+        // only complete, error-free streams end up in the cache. Errors are not fatal here:
+        // the next parser will just have to use libyaml again
+        if (d->type == YAML_STREAM_END_EVENT) {
+            pruneYamlCache();
+
+            QSaveFile sf(d->cacheFilePath);
+            if (sf.open(QIODevice::WriteOnly) && (sf.write(d->recordedEvents) == d->recordedEvents.size()))
+                sf.commit();
+            d->recording = false;
+            d->recordedEvents.clear();
+        }
+    }
+}
+
+bool YamlParser::isScalar() const
+{
+    return d->type == YAML_SCALAR_EVENT;
+}
+
+bool YamlParser::isMap() const
+{
+    return d->type == YAML_MAPPING_START_EVENT;
+}
+
+bool YamlParser::isList() const
+{
+    return d->type == YAML_SEQUENCE_START_EVENT;
+}
+
+bool YamlParser::isNull() const
+{
+    return isScalar() && !parseScalar().isValid();
+}
+
+QVariant YamlParser::parseScalar() const
+{
+    if (!isScalar())
+        throwParseError(qSL("expected a scalar value"));
+    return QtYaml::convertYamlScalar(d->scalar, d->quoted);
+}
+
+QString YamlParser::parseString() const
+{
+    return parseScalar().toString();
+}
+
+QVariantMap YamlParser::parseMap()
+{
+    QVariantMap map;
+    if (isNull())
+        return map;
+    if (!isMap())
+        throwParseError(qSL("expected a map"));
+
+    while (true) {
+        nextEvent();
+        if (d->type == YAML_MAPPING_END_EVENT)
+            return map;
+
+        QVariant key = parseVariant();
+        QString keyStr = key.toString();
+
+        if (key.type() != QVariant::String)
+            qWarning() << "YAML Parser: converting non-string mapping key to string for JSON compatibility";
+        if (map.contains(keyStr))
+            qWarning() << "YAML Parser: duplicate key" << keyStr << "found in mapping";
+
+        nextEvent();
+        map.insert(keyStr, parseVariant());
+    }
+}
+
+QVariantList YamlParser::parseList()
+{
+    QVariantList list;
+    parseList([&list](YamlParser *p) {
+        list.append(p->parseVariant());
+    });
+    return list;
+}
+
+void YamlParser::parseList(const std::function<void(YamlParser *)> &callback)
+{
+    if (isNull())
+        return;
+    if (!isList())
+        throwParseError(qSL("expected a list"));
+
+    while (true) {
+        nextEvent();
+        if (d->type == YAML_SEQUENCE_END_EVENT)
+            return;
+        callback(this);
+    }
+}
+
+QVariant YamlParser::parseVariant()
+{
+    if (isScalar())
+        return parseScalar();
+    else if (isMap())
+        return parseMap();
+    else if (isList())
+        return parseList();
+
+    throwParseError(qSL("expected a scalar, map or list value"));
+}
+
+QStringList YamlParser::parseStringOrStringList()
+{
+    if (isList()) {
+        QStringList result;
+        parseList([&result](YamlParser *p) {
+            result.append(p->parseVariant().toString());
+        });
+        return result;
+    } else {
+        return variantToStringList(parseScalar());
+    }
+}
+
+void YamlParser::parseFields(const std::vector<Field> &fields)
+{
+    if (!isMap())
+        throwParseError(qSL("expected a map"));
+
+    std::vector<bool> found(fields.size(), false);
+
+    while (true) {
+        nextEvent();
+        if (d->type == YAML_MAPPING_END_EVENT)
+            break;
+
+        if (!isScalar())
+            throwParseError(qSL("only scalars are supported as keys"));
+
+        auto it = std::find_if(fields.cbegin(), fields.cend(), [this](const Field &field) {
+            return field.name == d->scalar;
+        });
+        if (it == fields.cend())
+            throwParseError(qSL("contains unsupported field: '%1'").arg(QString::fromUtf8(d->scalar)));
+
+        const Field &field = *it;
+        const size_t index = size_t(it - fields.cbegin());
+        if (found[index])
+            qWarning() << "YAML Parser: duplicate key" << field.name << "found in mapping";
+        found[index] = true;
+
+        nextEvent();
+
+        bool validType = (isScalar() && (field.types & Scalar))
+                || (isMap() && (field.types & Map))
+                || (isList() && (field.types & List))
+                || ((field.types & (Map | List)) && isNull());
+        if (!validType) {
+            QStringList expected;
+            if (field.types & Scalar)
+                expected << qSL("scalar");
+            if (field.types & List)
+                expected << qSL("list");
+            if (field.types & Map)
+                expected << qSL("map");
+            throwParseError(qSL("field '%1' has an invalid type: expected %2")
+                            .arg(QString::fromUtf8(field.name), expected.join(qSL(" or "))));
+        }
+        field.callback(this);
+    }
+
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (fields[i].required && !found[i])
+            throwParseError(qSL("required field '%1' is missing").arg(QString::fromUtf8(fields[i].name)));
+    }
+}
+
+void YamlParser::throwParseError(const QString &message) const
+{
+    throw Exception(Error::Parse, "YAML parse error at line %1, column %2: %3")
+            .arg(d->line).arg(d->column).arg(message);
+}
+
+QT_END_NAMESPACE_AM
@@ -43,12 +43,16 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include <QJsonParseError>
 #include <QVector>
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QVariant>
+#include <QPair>
+#include <QtAppManCommon/global.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -91,3 +95,81 @@ QByteArray yamlFromVariantDocuments(const QVector<QVariant> &maps, YamlStyle sty
 } // namespace QtYaml
 
 QT_END_NAMESPACE
+
+QT_BEGIN_NAMESPACE_AM
+
+class YamlParserPrivate;
+
+// A pull parser on top of the libyaml event stream: in contrast to variantDocumentsFromYaml(),
+// the caller consumes the values directly, without building a QVariant tree for each document.
+//
+// All parse*() functions expect the current event to be the start of a value (a scalar, the
+// start of a map or the start of a list) and leave the current event at the last event of this
+// value. Errors are reported by throwing an Exception. Aliases are resolved transparently by
+// replaying the events of the anchored node.
+//
+// The event stream of a fully parsed YAML file is kept in a binary on-disk cache, keyed by the
+// hash of the YAML content, so that repeated parsing of the same content can skip libyaml.
+// Untrusted content (e.g. from packages that are being installed) should bypass the cache.
+class YamlParser
+{
+public:
+    enum CacheMode { UseCache, NoCache };
+
+    YamlParser(const QByteArray &data, const QString &sourcePath = QString(), CacheMode cacheMode = UseCache);
+    ~YamlParser();
+
+    QString sourcePath() const;
+
+    // parses the header document: returns formatType and formatVersion
+    QPair<QString, int> parseHeader() Q_DECL_NOEXCEPT_EXPR(false);
+    // same checks as checkYamlFormat(): returns the formatType
+    QString checkHeader(const QVector<QByteArray> &formatTypes, int formatVersion) Q_DECL_NOEXCEPT_EXPR(false);
+
+    bool nextDocument() Q_DECL_NOEXCEPT_EXPR(false);
+    void nextEvent() Q_DECL_NOEXCEPT_EXPR(false);
+
+    bool isScalar() const;
+    bool isMap() const;
+    bool isList() const;
+    bool isNull() const;
+
+    QVariant parseScalar() const Q_DECL_NOEXCEPT_EXPR(false);
+    QString parseString() const Q_DECL_NOEXCEPT_EXPR(false);
+    QVariantMap parseMap() Q_DECL_NOEXCEPT_EXPR(false);
+    QVariantList parseList() Q_DECL_NOEXCEPT_EXPR(false);
+    QVariant parseVariant() Q_DECL_NOEXCEPT_EXPR(false);
+    QStringList parseStringOrStringList() Q_DECL_NOEXCEPT_EXPR(false);
+    void parseList(const std::function<void(YamlParser *)> &callback) Q_DECL_NOEXCEPT_EXPR(false);
+
+    enum FieldType { Scalar = 0x01, List = 0x02, Map = 0x04 };
+    Q_DECLARE_FLAGS(FieldTypes, FieldType)
+
+    struct Field
+    {
+        QByteArray name;
+        bool required;
+        FieldTypes types;
+        std::function<void(YamlParser *)> callback;
+
+        Field(const char *_name, bool _required, FieldTypes _types,
+              const std::function<void(YamlParser *)> &_callback)
+            : name(_name)
+            , required(_required)
+            , types(_types)
+            , callback(_callback)
+        { }
+    };
+    // parses a map with a fixed set of keys: unknown keys are an error
+    void parseFields(const std::vector<Field> &fields) Q_DECL_NOEXCEPT_EXPR(false);
+
+    Q_NORETURN void throwParseError(const QString &message) const Q_DECL_NOEXCEPT_EXPR(false);
+
+private:
+    Q_DISABLE_COPY(YamlParser)
+    YamlParserPrivate *d;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(YamlParser::FieldTypes)
+
+QT_END_NAMESPACE_AM
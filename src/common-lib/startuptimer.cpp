@@ -46,6 +46,9 @@
 #  define _WIN32_WINNT _WIN32_WINNT_VISTA
 #endif
 
+#include <QCoreApplication>
+#include <QThread>
+
 #include "startuptimer.h"
 #include "utilities.h"
 
@@ -65,6 +68,7 @@
 #  include <unistd.h>
 #  include <sys/sysctl.h>
 #endif
+#include <stdio.h>
 
 /*!
     \qmltype StartupTimer
@@ -99,6 +103,16 @@
     can however add arbitrary checkpoints yourself using the QML API: access to the StartupTimer
     object is possible through a the \c StartupTimer root-context property in the QML engine.
 
+    For a more detailed analysis, the \c $AM_STARTUP_TRACE environment variable can be set to the
+    name of a file: all checkpoints as well as the individual setup stages (including the ones
+    running in worker threads) and the start-up of every application are then appended to this file
+    as \l{https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU}
+    {trace events}. This works independently of \c $AM_STARTUP_TIMER. Since the variable is
+    inherited by the application processes, the System-UI and all QML applications write into the
+    same file, which can be loaded into \c chrome://tracing or the \l{https://ui.perfetto.dev}
+    {Perfetto UI}. Every process is named after the application it is running. You should remove
+    the file before starting the application-manager, as new events are always appended.
+
     This is an example output, starting the \c Neptune UI on a console with ANSI color support:
 
     \raw HTML
@@ -192,6 +206,47 @@
 
 QT_BEGIN_NAMESPACE_AM
 
+// a timestamp in usec that is comparable across processes, as needed for trace events
+static quint64 traceTimestamp()
+{
+#if defined(Q_OS_LINUX)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return quint64(ts.tv_sec) * 1000 * 1000 + quint64(ts.tv_nsec) / 1000;
+#else
+    QElapsedTimer timer;
+    timer.start();
+    return quint64(timer.msecsSinceReference()) * 1000;
+#endif
+}
+
+static quint64 traceThreadId()
+{
+#if defined(Q_OS_LINUX)
+    return quint64(syscall(SYS_gettid));
+#else
+    return quint64(quintptr(QThread::currentThreadId()));
+#endif
+}
+
+static QByteArray jsonEscaped(const QByteArray &str)
+{
+    QByteArray result;
+    result.reserve(str.size());
+    for (char c : str) {
+        if ((c == '"') || (c == '\\')) {
+            result.append('\\').append(c);
+        } else if (uchar(c) < 0x20) {
+            char buffer[8];
+            qsnprintf(buffer, sizeof(buffer), "\\u%04x", uint(uchar(c)));
+            result.append(buffer);
+        } else {
+            result.append(c);
+        }
+    }
+    return result;
+}
+
 struct SplitSeconds
 {
     int sec;
@@ -218,6 +273,23 @@ StartupTimer::StartupTimer()
 {
     ::atexit([]() { delete s_instance; });
 
+    QByteArray traceFile = qgetenv("AM_STARTUP_TRACE");
+    if (!traceFile.isEmpty()) {
+        // all processes append to the same file: every event is written with a single write()
+        // to an O_APPEND file, so they do not get mixed up
+        m_trace = fopen(traceFile, "a");
+        if (m_trace) {
+            fseek(m_trace, 0, SEEK_END);
+            if (ftell(m_trace) == 0) {
+                // the JSON array format does not need the closing ]
+                fputs("[\n", m_trace);
+                fflush(m_trace);
+            }
+        } else {
+            qWarning("StartupTimer: could not open the trace file %s", traceFile.constData());
+        }
+    }
+
     QByteArray useTimer = qgetenv("AM_STARTUP_TIMER");
     if (useTimer.isNull())
         return;
@@ -380,6 +452,8 @@ StartupTimer::~StartupTimer()
 {
     if (m_output && m_output != stderr)
         fclose(m_output);
+    if (m_trace)
+        fclose(m_trace);
 
     s_instance = nullptr;
 }
@@ -387,9 +461,14 @@ StartupTimer::~StartupTimer()
 void StartupTimer::checkpoint(const char *name)
 {
     if (Q_LIKELY(m_initialized)) {
+        QMutexLocker locker(&m_mutex);
         qint64 delta = m_timer.nsecsElapsed();
         m_checkpoints << qMakePair(quint64(delta / 1000) + m_processCreation, name);
     }
+    if (m_trace) {
+        QMutexLocker locker(&m_mutex);
+        writeTraceEvent("i", name, "\"s\":\"t\"");
+    }
 }
 
 void StartupTimer::checkpoint(const QString &name)
@@ -403,9 +482,11 @@ void StartupTimer::checkpoint(const QString &name)
 void StartupTimer::checkFirstFrame()
 {
     if (Q_LIKELY(m_initialized)) {
+        QMutexLocker locker(&m_mutex);
         QByteArray ba = "after first frame drawn";
         m_timeToFirstFrame = quint64(m_timer.nsecsElapsed() / 1000) + m_processCreation;
         m_checkpoints << qMakePair(m_timeToFirstFrame, ba);
+        locker.unlock();
         emit timeToFirstFrameChanged(m_timeToFirstFrame);
     }
 }
@@ -413,6 +494,7 @@ void StartupTimer::checkFirstFrame()
 void StartupTimer::reset()
 {
     if (m_initialized) {
+        QMutexLocker locker(&m_mutex);
         SplitSeconds delta = splitMicroSecs(quint64(m_timer.nsecsElapsed() / 1000) + m_processCreation);
         m_timer.restart();
         m_checkpoints.clear();
@@ -445,6 +527,7 @@ void StartupTimer::setAutomaticReporting(bool enableAutomaticReporting)
 
 void StartupTimer::createReport(const QString &title)
 {
+    QMutexLocker locker(&m_mutex);
     if (m_output && !m_checkpoints.isEmpty()) {
         bool ansiColorSupport = false;
         if (m_output == stderr)
@@ -488,6 +571,66 @@ void StartupTimer::createReport(const QString &title)
     }
 }
 
+bool StartupTimer::isTracing() const
+{
+    return m_trace;
+}
+
+void StartupTimer::beginSpan(const char *name)
+{
+    if (m_trace) {
+        QMutexLocker locker(&m_mutex);
+        writeTraceEvent("B", name);
+    }
+}
+
+void StartupTimer::endSpan(const char *name)
+{
+    if (m_trace) {
+        QMutexLocker locker(&m_mutex);
+        writeTraceEvent("E", name);
+    }
+}
+
+void StartupTimer::beginAsyncSpan(const QByteArray &name, quint64 id)
+{
+    if (m_trace) {
+        QMutexLocker locker(&m_mutex);
+        writeTraceEvent("b", name, "\"cat\":\"appman\",\"id\":\"0x" + QByteArray::number(id, 16) + '"');
+    }
+}
+
+void StartupTimer::endAsyncSpan(const QByteArray &name, quint64 id)
+{
+    if (m_trace) {
+        QMutexLocker locker(&m_mutex);
+        writeTraceEvent("e", name, "\"cat\":\"appman\",\"id\":\"0x" + QByteArray::number(id, 16) + '"');
+    }
+}
+
+void StartupTimer::setTraceProcessName(const QString &name)
+{
+    if (m_trace) {
+        QMutexLocker locker(&m_mutex);
+        writeTraceEvent("M", "process_name", "\"args\":{\"name\":\"" + jsonEscaped(name.toUtf8()) + "\"}");
+    }
+}
+
+// needs to be called with m_mutex locked
+void StartupTimer::writeTraceEvent(const char *phase, const QByteArray &name, const QByteArray &extraFields)
+{
+    QByteArray event = "{\"name\":\"" + jsonEscaped(name) + "\",\"ph\":\"" + phase
+            + "\",\"ts\":" + QByteArray::number(traceTimestamp())
+            + ",\"pid\":" + QByteArray::number(QCoreApplication::applicationPid())
+            + ",\"tid\":" + QByteArray::number(traceThreadId());
+    if (!extraFields.isEmpty())
+        event.append(',').append(extraFields);
+    event.append("},\n");
+
+    fwrite(event.constData(), 1, size_t(event.size()), m_trace);
+    fflush(m_trace);
+}
+
 quint64 StartupTimer::timeToFirstFrame() const
 {
     return m_timeToFirstFrame / 1000;
@@ -47,6 +47,7 @@
 #include <QPair>
 #include <QByteArray>
 #include <QElapsedTimer>
+#include <QMutex>
 #include <QtAppManCommon/global.h>
 
 QT_BEGIN_NAMESPACE_AM
@@ -74,6 +75,15 @@ public:
     void checkFirstFrame();
     void reset();
 
+    // only recorded in trace mode: nested spans on the calling thread, as well as asynchronous
+    // spans that can overlap (identified by name and id)
+    bool isTracing() const;
+    void beginSpan(const char *name);
+    void endSpan(const char *name);
+    void beginAsyncSpan(const QByteArray &name, quint64 id);
+    void endAsyncSpan(const QByteArray &name, quint64 id);
+    void setTraceProcessName(const QString &name);
+
 public slots:
     void setAutomaticReporting(bool enableAutomaticReporting);
 
@@ -86,7 +96,10 @@ private:
     StartupTimer();
     static StartupTimer *s_instance;
 
+    void writeTraceEvent(const char *phase, const QByteArray &name, const QByteArray &extraFields = QByteArray());
+
     FILE *m_output = nullptr;
+    FILE *m_trace = nullptr;
     bool m_initialized = false;
     bool m_automaticReporting = true;
     quint64 m_processCreation = 0;
@@ -94,6 +107,7 @@ private:
     quint64 m_systemUpTime = 0;
     QElapsedTimer m_timer;
     QVector<QPair<quint64, QByteArray>> m_checkpoints;
+    QMutex m_mutex; // checkpoints can be created from multiple threads during startup
 
     Q_DISABLE_COPY(StartupTimer)
 };
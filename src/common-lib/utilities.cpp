@@ -395,6 +395,42 @@ qint64 getParentPid(qint64 pid)
     return ppid;
 }
 
+quint64 getProcessStartTime(qint64 pid)
+{
+    quint64 startTime = 0;
+
+#if defined(Q_OS_LINUX)
+    static QString proc = qSL("/proc/%1/stat");
+    QFile f(proc.arg(pid));
+    if (f.open(QIODevice::ReadOnly)) {
+        QByteArray ba = f.read(1024);
+        // see getParentPid(): the fields after the binary name start with the 3rd one
+        int pos = ba.lastIndexOf(')');
+        if (pos > 0) {
+            const QList<QByteArray> fields = ba.mid(pos + 2).split(' ');
+            // the 22nd field is the start time in clock ticks after boot
+            if (fields.size() > (22 - 3))
+                startTime = fields.at(22 - 3).toULongLong();
+        }
+    }
+
+#elif defined(Q_OS_MACOS) || defined(Q_OS_IOS)
+    int mibNames[] = { CTL_KERN, KERN_PROC, KERN_PROC_PID, (pid_t) pid };
+    kinfo_proc procInfo;
+    size_t procInfoSize = sizeof(procInfo);
+
+    if ((sysctl(mibNames, sizeof(mibNames) / sizeof(mibNames[0]), &procInfo, &procInfoSize, nullptr, 0) == 0)
+            && (procInfoSize > 0)) {
+        startTime = quint64(procInfo.kp_proc.p_starttime.tv_sec) * 1000000
+                + quint64(procInfo.kp_proc.p_starttime.tv_usec);
+    }
+
+#else
+    Q_UNUSED(pid)
+#endif
+    return startTime;
+}
+
 int timeoutFactor()
 {
     static int tf = 0;
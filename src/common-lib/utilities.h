@@ -107,6 +107,9 @@ bool safeRemove(const QString &path, RecursiveOperationType type);
 void getOutputInformation(bool *ansiColorSupport, bool *runningInCreator, int *consoleWidth);
 
 qint64 getParentPid(qint64 pid);
+// An opaque value that identifies a process together with its pid, since pids get reused.
+// Returns 0, if the process does not exist or if this is not supported on the platform.
+quint64 getProcessStartTime(qint64 pid);
 
 QVector<QObject *> loadPlugins_helper(const char *type, const QStringList &files, const char *iid) Q_DECL_NOEXCEPT_EXPR(false);
 
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QtEndian>
+#include <QtAppManCommon/global.h>
+
+QT_BEGIN_NAMESPACE_AM
+
+// The messages exchanged between the application manager and a zygote launcher process: each
+// message is a QDataStream serialized payload, prefixed with its size as a big-endian quint32.
+// All payloads start with the MessageType as qint32.
+namespace ZygoteProtocol {
+
+enum MessageType {
+    Fork = 1,     // -> zygote: quint32 requestId, QStringList arguments, QStringList environment,
+                  //            QString workingDirectory
+    Forked = 2,   // <- zygote: quint32 requestId, qint64 pid (or -errno on failure)
+    Finished = 3  // <- zygote: qint64 pid, qint32 exitCode (or signal), bool crashed
+};
+
+inline QByteArray frame(const QByteArray &payload)
+{
+    QByteArray result(4, 0);
+    qToBigEndian(quint32(payload.size()), result.data());
+    return result + payload;
+}
+
+// takes the first complete message out of the buffer, if there is one
+inline bool takeFrame(QByteArray &buffer, QByteArray &payload)
+{
+    if (buffer.size() < 4)
+        return false;
+    const quint32 size = qFromBigEndian<quint32>(buffer.constData());
+    if (quint32(buffer.size() - 4) < size)
+        return false;
+    payload = buffer.mid(4, int(size));
+    buffer.remove(0, int(size) + 4);
+    return true;
+}
+
+} // namespace ZygoteProtocol
+
+QT_END_NAMESPACE_AM
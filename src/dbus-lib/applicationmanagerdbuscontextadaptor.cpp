@@ -47,8 +47,10 @@
 
 #include "applicationmanagerdbuscontextadaptor.h"
 #include "applicationmanager.h"
+#include "launchstatistics.h"
 #include "io.qt.applicationmanager_adaptor.h"
 #include "dbuspolicy.h"
+#include "dbus-utilities.h"
 #include "exception.h"
 #include "logging.h"
 
@@ -89,6 +91,10 @@ ApplicationManagerAdaptor::ApplicationManagerAdaptor(QObject *parent)
             this, [this](const QString &id, QT_PREPEND_NAMESPACE_AM(Am::RunState) runState) {
         emit applicationRunStateChanged(id, runState);
     });
+    connect(am, &ApplicationManager::applicationsStarted,
+            this, &ApplicationManagerAdaptor::applicationsStarted);
+    connect(am, &ApplicationManager::applicationsStopped,
+            this, &ApplicationManagerAdaptor::applicationsStopped);
 }
 
 ApplicationManagerAdaptor::~ApplicationManagerAdaptor()
@@ -192,6 +198,20 @@ bool ApplicationManagerAdaptor::debugApplication(const QString &id, const QStrin
     return result;
 }
 
+QString ApplicationManagerAdaptor::startApplications(const QVariantList &applications)
+{
+    return startApplications(applications, QVariantMap());
+}
+
+QString ApplicationManagerAdaptor::startApplications(const QVariantList &applications, const QVariantMap &options)
+{
+    AM_AUTHENTICATE_DBUS(QString)
+
+    // D-Bus clients send the per-application maps as a{sv}, wrapped in a variant
+    return ApplicationManager::instance()->startApplications(convertFromDBusVariant(applications).toList(),
+                                                             convertFromDBusVariant(options).toMap());
+}
+
 QVariantMap ApplicationManagerAdaptor::get(const QString &id)
 {
     AM_AUTHENTICATE_DBUS(QVariantMap)
@@ -200,6 +220,12 @@ QVariantMap ApplicationManagerAdaptor::get(const QString &id)
     return map;
 }
 
+QVariantMap ApplicationManagerAdaptor::launchStatistics(const QString &id)
+{
+    AM_AUTHENTICATE_DBUS(QVariantMap)
+    return LaunchStatistics::instance()->statistics(id);
+}
+
 QString ApplicationManagerAdaptor::identifyApplication(qlonglong pid)
 {
     AM_AUTHENTICATE_DBUS(QString)
@@ -288,3 +314,15 @@ void ApplicationManagerAdaptor::stopApplication(const QString &id, bool forceKil
     AM_AUTHENTICATE_DBUS(void)
     ApplicationManager::instance()->stopApplication(id, forceKill);
 }
+
+bool ApplicationManagerAdaptor::suspendApplication(const QString &id)
+{
+    AM_AUTHENTICATE_DBUS(bool)
+    return ApplicationManager::instance()->suspendApplication(id);
+}
+
+bool ApplicationManagerAdaptor::resumeApplication(const QString &id)
+{
+    AM_AUTHENTICATE_DBUS(bool)
+    return ApplicationManager::instance()->resumeApplication(id);
+}
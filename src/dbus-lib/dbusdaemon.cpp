@@ -78,6 +78,8 @@ DBusDaemonProcess::DBusDaemonProcess(QObject *parent)
 
 DBusDaemonProcess::~DBusDaemonProcess()
 {
+    if (s_launched == this)
+        s_launched = nullptr;
     kill();
     waitForFinished();
 }
@@ -91,13 +93,31 @@ void DBusDaemonProcess::setupChildProcess()
     QProcess::setupChildProcess();
 }
 
+DBusDaemonProcess *DBusDaemonProcess::s_launched = nullptr;
+
 void DBusDaemonProcess::start() Q_DECL_NOEXCEPT_EXPR(false)
+{
+    launch();
+    waitForAddress();
+}
+
+void DBusDaemonProcess::launch() Q_DECL_NOEXCEPT_EXPR(false)
+{
+    s_launched = new DBusDaemonProcess(qApp);
+    s_launched->QProcess::start(QIODevice::ReadOnly);
+}
+
+void DBusDaemonProcess::waitForAddress() Q_DECL_NOEXCEPT_EXPR(false)
 {
     static const int timeout = 10000 * int(timeoutFactor());
 
-    auto dbusDaemon = new DBusDaemonProcess(qApp);
-    dbusDaemon->QProcess::start(QIODevice::ReadOnly);
-    if (!dbusDaemon->waitForStarted(timeout) || !dbusDaemon->waitForReadyRead(timeout)) {
+    auto dbusDaemon = s_launched;
+    if (!dbusDaemon)
+        throw Exception("no dbus-daemon process has been launched");
+
+    // the address might already have been read, if the event loop was running since launch()
+    if (!dbusDaemon->waitForStarted(timeout)
+            || (!dbusDaemon->bytesAvailable() && !dbusDaemon->waitForReadyRead(timeout))) {
         throw Exception("could not start a dbus-daemon process (%1): %2")
                 .arg(dbusDaemon->program(), dbusDaemon->errorString());
     }
@@ -55,8 +55,15 @@ public:
 
     static void start() Q_DECL_NOEXCEPT_EXPR(false);
 
+    // start() split into two halves, so that the daemon can start up while we do something else
+    static void launch() Q_DECL_NOEXCEPT_EXPR(false);
+    static void waitForAddress() Q_DECL_NOEXCEPT_EXPR(false);
+
 protected:
     void setupChildProcess() override;
+
+private:
+    static DBusDaemonProcess *s_launched;
 };
 
 QT_END_NAMESPACE_AM
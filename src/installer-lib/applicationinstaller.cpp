@@ -355,6 +355,17 @@ void ApplicationInstaller::setCACertificates(const QList<QByteArray> &chainOfTru
     d->chainOfTrust = chainOfTrust;
 }
 
+QString ApplicationInstaller::qmlCacheGenerator(const QString &runtimeId) const
+{
+    return d->qmlCacheGeneratorRuntimeIds.contains(runtimeId) ? d->qmlCacheGenerator : QString();
+}
+
+void ApplicationInstaller::setQmlCacheGenerator(const QString &program, const QStringList &runtimeIds)
+{
+    d->qmlCacheGenerator = program;
+    d->qmlCacheGeneratorRuntimeIds = program.isEmpty() ? QStringList() : runtimeIds;
+}
+
 // find mounts and loopbacks left-over from a previous instance and kill them
 void ApplicationInstaller::cleanupMounts() const
 {
@@ -107,6 +107,10 @@ public:
     bool setDBusPolicy(const QVariantMap &yamlFragment);
     void setCACertificates(const QList<QByteArray> &chainOfTrust);
 
+    // the QML of applications using one of the given runtimes is pre-compiled at installation time
+    QString qmlCacheGenerator(const QString &runtimeId) const;
+    void setQmlCacheGenerator(const QString &program, const QStringList &runtimeIds);
+
     void cleanupBrokenInstallations() const Q_DECL_NOEXCEPT_EXPR(false);
 
     // InstallationLocation handling
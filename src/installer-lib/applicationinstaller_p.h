@@ -76,6 +76,9 @@ public:
     QString hardwareId;
     QList<QByteArray> chainOfTrust;
 
+    QString qmlCacheGenerator;
+    QStringList qmlCacheGeneratorRuntimeIds;
+
     QList<AsynchronousTask *> incomingTaskList;     // incoming queue
     QList<AsynchronousTask *> installationTaskList; // installation jobs in state >= AwaitingAcknowledge
     AsynchronousTask *activeTask = nullptr;         // currently active
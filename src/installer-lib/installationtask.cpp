@@ -42,6 +42,8 @@
 
 #include <QTemporaryDir>
 #include <QMessageAuthenticationCode>
+#include <QDirIterator>
+#include <QProcess>
 
 #include "logging.h"
 #include "applicationinstaller_p.h"
@@ -104,6 +106,9 @@
   if (not <isupdate>)
       create document directory
 
+  if (optional QML pre-compilation for the app's runtime)
+      create a <file>c cache next to every .qml/.js/.mjs file in <extractiondir>
+
   if (optional uid separation)
       chown/chmod recursively in <extractionDir> and document directory
 
@@ -315,12 +320,14 @@ void InstallationTask::checkExtractedFile(const QString &file) Q_DECL_NOEXCEPT_E
             throw Exception(Error::Package, "info.yaml must be the first file in the package. Got %1")
                 .arg(file);
 
-        YamlApplicationScanner yas;
+        // the package is not trusted yet: keep its manifest out of the shared YAML cache
+        YamlApplicationScanner yas(YamlParser::NoCache);
         m_app.reset(yas.scan(m_extractor->destinationDirectory().absoluteFilePath(file)));
         if (m_app->id() != m_extractor->installationReport().applicationId())
             throw Exception(Error::Package, "the application identifiers in --PACKAGE-HEADER--' and info.yaml do not match");
 
         m_iconFileName = m_app->icon(); // store it separately as we will give away ApplicationInfo later on
+        m_qmlCacheGenerator = m_ai->qmlCacheGenerator(m_app->runtimeName());
 
         if (m_iconFileName.isEmpty())
             throw Exception(Error::Package, "the 'icon' field in info.yaml cannot be empty or absent.");
@@ -441,6 +448,9 @@ void InstallationTask::startInstallation() Q_DECL_NOEXCEPT_EXPR(false)
             throw Exception("could not create application image base directory %1").arg(installationDir);
 
         quint64 neededSize = qMax(m_extractor->installationReport().diskSpaceUsed(), quint64(70 * 1024));
+        // the compiled QML caches are stored in the image as well: leave some headroom for them
+        if (!m_qmlCacheGenerator.isEmpty())
+            neededSize += neededSize / 2;
 
         quint64 availableSize = 0;
         if (!m_installationLocation.installationDeviceFreeSpace(nullptr, &availableSize) || availableSize < neededSize) {
@@ -494,6 +504,46 @@ void InstallationTask::startInstallation() Q_DECL_NOEXCEPT_EXPR(false)
     }
 }
 
+void InstallationTask::precompileQml()
+{
+    // Qt's QML engine picks up a <file>c cache that is located right next to its <file> source,
+    // even if the directory is read-only. Generating these caches here means that the app does
+    // not have to compile its QML on the first start and that the caches live and die together
+    // with the installation. Any failure is not fatal: the engine will simply compile at runtime.
+
+    static const int timeout = 30000;
+    int compiled = 0;
+    int failed = 0;
+
+    QDirIterator it(m_extractionDir.absolutePath(), { qSL("*.qml"), qSL("*.js"), qSL("*.mjs") },
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString sourceFile = it.next();
+        const QString cacheFile = sourceFile + qL1C('c');
+
+        QProcess qmlcachegen;
+        qmlcachegen.setProcessChannelMode(QProcess::MergedChannels);
+        qmlcachegen.start(m_qmlCacheGenerator, { qSL("-o"), cacheFile, sourceFile });
+
+        if (!qmlcachegen.waitForFinished(timeout) || (qmlcachegen.exitStatus() != QProcess::NormalExit)
+                || (qmlcachegen.exitCode() != 0)) {
+            qCWarning(LogInstaller) << "Could not pre-compile" << m_extractionDir.relativeFilePath(sourceFile)
+                                    << "of application" << m_applicationId << ":"
+                                    << (qmlcachegen.error() == QProcess::UnknownError
+                                        ? QString::fromLocal8Bit(qmlcachegen.readAll()).trimmed()
+                                        : qmlcachegen.errorString());
+            qmlcachegen.kill();
+            qmlcachegen.waitForFinished();
+            QFile::remove(cacheFile);
+            ++failed;
+        } else {
+            ++compiled;
+        }
+    }
+    qCDebug(LogInstaller) << "Pre-compiled" << compiled << "QML/JS files of application" << m_applicationId
+                          << "(" << failed << "failed )";
+}
+
 void InstallationTask::finishInstallation() Q_DECL_NOEXCEPT_EXPR(false)
 {
     QDir documentDirectory(m_installationLocation.documentPath());
@@ -537,6 +587,11 @@ void InstallationTask::finishInstallation() Q_DECL_NOEXCEPT_EXPR(false)
                 throw Exception(Error::IO, "could not create the document directory %1").arg(documentDirectory.filePath(m_applicationId));
         }
     }
+
+    // this needs to happen before the ownership changes below, so the caches are covered as well
+    if (!m_qmlCacheGenerator.isEmpty())
+        precompileQml();
+
 #ifdef Q_OS_UNIX
     // update the owner, group and permission bits on both the installation and document directories
     SudoClient *root = SudoClient::instance();
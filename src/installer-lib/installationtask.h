@@ -79,6 +79,7 @@ private:
     void startInstallation() Q_DECL_NOEXCEPT_EXPR(false);
     void finishInstallation() Q_DECL_NOEXCEPT_EXPR(false);
     void checkExtractedFile(const QString &file) Q_DECL_NOEXCEPT_EXPR(false);
+    void precompileQml();
 
 private:
     ApplicationInstaller *m_ai;
@@ -87,6 +88,7 @@ private:
     bool m_foundInfo = false;
     bool m_foundIcon = false;
     QString m_iconFileName;
+    QString m_qmlCacheGenerator;
     bool m_locked = false;
     uint m_extractedFileCount = 0;
     bool m_managerApproval = false;
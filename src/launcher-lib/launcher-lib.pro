@@ -29,6 +29,11 @@ SOURCES += \
 !headless:SOURCES += \
     applicationmanagerwindow.cpp \
 
+linux {
+    HEADERS += zygoteserver.h
+    SOURCES += zygoteserver.cpp
+}
+
 !headless:qtHaveModule(waylandclient) {
     QT *= waylandclient waylandclient-private
     CONFIG *= wayland-scanner generated_privates
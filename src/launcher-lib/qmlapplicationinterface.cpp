@@ -121,6 +121,8 @@ bool QmlApplicationInterface::initialize()
     bool ok = true;
     ok = ok && connect(m_runtimeIf, SIGNAL(startApplication(QString,QString,QString,QString,QVariantMap,QVariantMap)),
                        this,        SIGNAL(startApplication(QString,QString,QString,QString,QVariantMap,QVariantMap)));
+    ok = ok && connect(m_runtimeIf, SIGNAL(preloadApplication(QString,QString,QVariantMap)),
+                       this,        SIGNAL(preloadApplication(QString,QString,QVariantMap)));
 
     if (!ok)
         qCritical("ERROR: could not connect the RuntimeInterface via D-Bus: %s", qPrintable(m_runtimeIf->lastError().name()));
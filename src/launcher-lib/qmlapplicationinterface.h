@@ -88,6 +88,8 @@ private:
     Q_SIGNAL void startApplication(const QString &baseDir, const QString &qmlFile, const QString &document,
                                    const QString &mimeType, const QVariantMap &runtimeParams,
                                    const QVariantMap systemProperties);
+    Q_SIGNAL void preloadApplication(const QString &baseDir, const QString &qmlFile,
+                                     const QVariantMap &runtimeParams);
 
     uint notificationShow(QmlNotification *n);
     void notificationClose(QmlNotification *n);
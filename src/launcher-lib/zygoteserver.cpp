@@ -0,0 +1,254 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QDataStream>
+#include <QFile>
+#include <QStringList>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <dlfcn.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "global.h"
+#include "zygoteprotocol.h"
+#include "zygoteserver.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+static int s_childPipe[2] = { -1, -1 };
+
+static void childSignalHandler(int)
+{
+    int savedErrno = errno;
+    char c = 0;
+    ssize_t written = ::write(s_childPipe[1], &c, 1);
+    Q_UNUSED(written) // there is nothing we could do about an error here
+    errno = savedErrno;
+}
+
+static bool writeMessage(int fd, const QByteArray &payload)
+{
+    const QByteArray message = ZygoteProtocol::frame(payload);
+    const char *pos = message.constData();
+    qint64 left = message.size();
+
+    while (left > 0) {
+        ssize_t written = ::write(fd, pos, size_t(left));
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        pos += written;
+        left -= written;
+    }
+    return true;
+}
+
+static bool setupChild(const QStringList &arguments, const QStringList &environment,
+                       const QString &workingDirectory, int &argc, char **&argv)
+{
+    if (!workingDirectory.isEmpty() && (::chdir(QFile::encodeName(workingDirectory).constData()) != 0))
+        return false;
+
+    clearenv();
+    for (const QString &env : environment) {
+        // putenv() does not copy the string, so we have to leak it
+        if (::putenv(::strdup(env.toLocal8Bit().constData())) != 0)
+            return false;
+    }
+
+    // the new command line needs to stay valid for the whole lifetime of the process
+    char *program = argv[0];
+    argc = arguments.size() + 1;
+    argv = new char *[argc + 1];
+    argv[0] = program;
+    for (int i = 0; i < arguments.size(); ++i)
+        argv[i + 1] = ::strdup(arguments.at(i).toLocal8Bit().constData());
+    argv[argc] = nullptr;
+    return true;
+}
+
+const char *ZygoteServer::socketPathFromArguments(int argc, char **argv)
+{
+    if ((argc >= 3) && !::strcmp(argv[1], "--zygote"))
+        return argv[2];
+    return nullptr;
+}
+
+void ZygoteServer::preloadLibraries()
+{
+    const QByteArrayList libraries = qgetenv("AM_ZYGOTE_PRELOAD").split(':');
+    for (const QByteArray &library : libraries) {
+        if (!library.isEmpty() && !dlopen(library.constData(), RTLD_NOW))
+            fprintf(stderr, "WARNING: the zygote could not preload %s: %s\n", library.constData(), dlerror());
+    }
+}
+
+int ZygoteServer::run(const char *socketPath, int &argc, char **&argv)
+{
+    // there is no Q*Application (and no logging setup) at this point, so we have to use stderr
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "ERROR: the zygote socket path is too long: %s\n", socketPath);
+        return 1;
+    }
+    strcpy(addr.sun_path, socketPath);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((fd < 0) || (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0)) {
+        fprintf(stderr, "ERROR: the zygote could not connect to %s: %s\n", socketPath, strerror(errno));
+        return 1;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    // SIGCHLD is forwarded to the poll() loop via a self-pipe
+    if (::pipe(s_childPipe) != 0) {
+        fprintf(stderr, "ERROR: the zygote could not create a pipe: %s\n", strerror(errno));
+        return 1;
+    }
+    for (int pfd : s_childPipe) {
+        fcntl(pfd, F_SETFD, FD_CLOEXEC);
+        fcntl(pfd, F_SETFL, fcntl(pfd, F_GETFL) | O_NONBLOCK);
+    }
+
+    struct sigaction sa, oldSa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = childSignalHandler;
+    sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGCHLD, &sa, &oldSa);
+
+    QByteArray buffer;
+
+    while (true) {
+        struct pollfd pfds[2] = { { fd, POLLIN, 0 }, { s_childPipe[0], POLLIN, 0 } };
+        if (::poll(pfds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            fprintf(stderr, "ERROR: the zygote failed to poll: %s\n", strerror(errno));
+            return 1;
+        }
+
+        if (pfds[1].revents & POLLIN) {
+            char dummy[64];
+            while (::read(s_childPipe[0], dummy, sizeof(dummy)) > 0)
+                ;
+
+            int status;
+            pid_t pid;
+            while ((pid = ::waitpid(-1, &status, WNOHANG)) > 0) {
+                const bool crashed = WIFSIGNALED(status);
+                QByteArray payload;
+                QDataStream ds(&payload, QIODevice::WriteOnly);
+                ds << qint32(ZygoteProtocol::Finished) << qint64(pid)
+                   << qint32(crashed ? WTERMSIG(status) : WEXITSTATUS(status)) << crashed;
+                if (!writeMessage(fd, payload))
+                    return 1;
+            }
+        }
+
+        if (pfds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            char data[4096];
+            ssize_t bytesRead = ::read(fd, data, sizeof(data));
+            if ((bytesRead < 0) && (errno == EINTR))
+                continue;
+            if (bytesRead <= 0) // the application manager is gone
+                return 0;
+            buffer.append(data, int(bytesRead));
+
+            QByteArray payload;
+            while (ZygoteProtocol::takeFrame(buffer, payload)) {
+                QDataStream ds(payload);
+                qint32 type = 0;
+                quint32 requestId = 0;
+                QStringList arguments;
+                QStringList environment;
+                QString workingDirectory;
+
+                ds >> type;
+                if (type != ZygoteProtocol::Fork)
+                    continue;
+                ds >> requestId >> arguments >> environment >> workingDirectory;
+                if (ds.status() != QDataStream::Ok)
+                    continue;
+
+                pid_t pid = ::fork();
+                const int forkErrno = errno;
+                if (pid == 0) {
+                    ::close(fd);
+                    ::close(s_childPipe[0]);
+                    ::close(s_childPipe[1]);
+                    sigaction(SIGCHLD, &oldSa, nullptr);
+
+                    if (!setupChild(arguments, environment, workingDirectory, argc, argv)) {
+                        fprintf(stderr, "ERROR: could not set up the process forked from the zygote: %s\n",
+                                strerror(errno));
+                        ::_exit(127);
+                    }
+                    return -1;
+                }
+
+                QByteArray reply;
+                QDataStream rds(&reply, QIODevice::WriteOnly);
+                rds << qint32(ZygoteProtocol::Forked) << requestId << qint64((pid < 0) ? -forkErrno : pid);
+                if (!writeMessage(fd, reply))
+                    return 1;
+            }
+        }
+    }
+}
+
+QT_END_NAMESPACE_AM
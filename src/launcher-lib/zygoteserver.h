@@ -0,0 +1,68 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QtAppManCommon/global.h>
+
+QT_BEGIN_NAMESPACE_AM
+
+// The launcher side of the zygote mode: a launcher started with --zygote does all the process
+// wide initialization that can happen before the Q*Application is constructed and then waits
+// for fork requests from the application manager. Every forked child continues as if it was
+// started via exec() with the requested arguments, environment and working directory.
+class ZygoteServer
+{
+public:
+    // Returns -1 in the forked children, with argc and argv replaced by the requested command
+    // line. The zygote process itself only returns with its exit code.
+    static int run(const char *socketPath, int &argc, char **&argv);
+
+    // Checks for the --zygote option in argv: returns the socket path or nullptr
+    static const char *socketPathFromArguments(int argc, char **argv);
+
+    // preload the shared libraries given in $AM_ZYGOTE_PRELOAD (separated by ':'), so that the
+    // dynamic linking is done before forking
+    static void preloadLibraries();
+};
+
+QT_END_NAMESPACE_AM
@@ -134,6 +134,20 @@ void Configuration::mergeConfig(const QVariantMap &other)
     recursiveMergeVariantMap(m_config, other);
 }
 
+void Configuration::resolveConfigValues()
+{ }
+
+void Configuration::saveResolvedConfigValues(QDataStream &ds) const
+{
+    Q_UNUSED(ds)
+}
+
+bool Configuration::loadResolvedConfigValues(QDataStream &ds)
+{
+    Q_UNUSED(ds)
+    return true;
+}
+
 
 Configuration::Configuration(const QStringList &defaultConfigFilePaths, const QString &buildConfigFilePath)
     : m_defaultConfigFilePaths(defaultConfigFilePaths)
@@ -247,6 +261,7 @@ void Configuration::parseWithArguments(const QStringList &arguments, QStringList
 #endif
 
     QStringList configFilePaths = m_clp.values(qSL("config-file"));
+    const QStringList options = m_clp.values(qSL("o"));
 
     struct ConfigFile
     {
@@ -279,7 +294,8 @@ void Configuration::parseWithArguments(const QStringList &arguments, QStringList
             try {
                 QDataStream ds(&cacheFile);
                 QVector<QPair<QString, QByteArray>> configChecksums; // abs. file path -> sha1
-                ds >> configChecksums >> cache;
+                QByteArray resolvedValues;
+                ds >> configChecksums >> cache >> resolvedValues;
 
                 if (ds.status() != QDataStream::Ok)
                     throw Exception("failed to read config cache content");
@@ -293,6 +309,13 @@ void Configuration::parseWithArguments(const QStringList &arguments, QStringList
                         throw Exception("the cached config file names do not match the current set (or their order changed)");
                     cf.checksum = configChecksums.at(i).second;
                 }
+
+                // no need to restore the snapshot, if it gets invalidated by -o options anyway
+                if (options.isEmpty()) {
+                    QDataStream resolvedDs(resolvedValues);
+                    if (!loadResolvedConfigValues(resolvedDs) || (resolvedDs.status() != QDataStream::Ok))
+                        throw Exception("the cached resolved config values are outdated");
+                }
                 useCache = true;
 
 #if defined(AM_TIME_CONFIG_PARSING)
@@ -392,6 +415,8 @@ void Configuration::parseWithArguments(const QStringList &arguments, QStringList
         for (int i = 1; i < configFiles.size(); ++i)
             mergeConfig(configFiles.at(i).config);
 
+        resolveConfigValues();
+
         if (!noConfigCache) {
             try {
                 QFile cacheFile(cacheFilePath);
@@ -403,7 +428,11 @@ void Configuration::parseWithArguments(const QStringList &arguments, QStringList
                 for (const ConfigFile &cf : qAsConst(configFiles))
                     configChecksums.append(qMakePair(cf.filePath, cf.checksum));
 
-                ds << configChecksums << m_config;
+                QByteArray resolvedValues;
+                QDataStream resolvedDs(&resolvedValues, QIODevice::WriteOnly);
+                saveResolvedConfigValues(resolvedDs);
+
+                ds << configChecksums << m_config << resolvedValues;
 
                 if (ds.status() != QDataStream::Ok)
                     throw Exception("error writing config cache content");
@@ -416,9 +445,10 @@ void Configuration::parseWithArguments(const QStringList &arguments, QStringList
         qCDebug(LogSystem) << "Config parsing" << configFiles.size() << "files: parsing finished after"
                            << (timer.nsecsElapsed() / 1000) << "usec";
 #endif
+    } else {
+        resolveConfigValues();
     }
 
-    const QStringList options = m_clp.values(qSL("o"));
     for (const QString &option : options) {
         QtYaml::ParseError parseError;
         QVector<QVariant> docs = QtYaml::variantDocumentsFromYaml(option.toUtf8(), &parseError);
@@ -435,6 +465,8 @@ void Configuration::parseWithArguments(const QStringList &arguments, QStringList
         }
         mergeConfig(docs.at(0).toMap());
     }
+    if (!options.isEmpty())
+        resolveConfigValues();
 
 #if defined(AM_TIME_CONFIG_PARSING)
     qCDebug(LogSystem) << "Config parsing" << options.size() << "-o options: parsing finished after"
@@ -48,6 +48,8 @@
 #include <QVector>
 #include <QCommandLineParser>
 
+QT_FORWARD_DECLARE_CLASS(QDataStream)
+
 QT_BEGIN_NAMESPACE_AM
 
 class Configuration
@@ -65,6 +67,13 @@ protected:
 
     void showParserMessage(const QString &message, MessageType type);
 
+    // Derived classes can resolve the config file values into a typed snapshot: this snapshot is
+    // stored in the config cache alongside the merged config, so it only needs to be rebuilt
+    // when the config files (or the -o options) change.
+    virtual void resolveConfigValues();
+    virtual void saveResolvedConfigValues(QDataStream &ds) const;
+    virtual bool loadResolvedConfigValues(QDataStream &ds);
+
     template <typename T> T value(const char *clname, const QVector<const char *> &cfname = QVector<const char *>()) const
     {
         Q_UNUSED(clname)
@@ -44,8 +44,11 @@
 #include <QCoreApplication>
 #include <QFile>
 #include <QDebug>
+#include <QDataStream>
 
 #include <QtAppManCommon/logging.h>
+#include <QtAppManCommon/utilities.h>
+#include <QtAppManCommon/qml-utilities.h>
 
 #include "defaultconfiguration.h"
 
@@ -129,6 +132,18 @@ void DefaultConfiguration::parseWithArguments(const QStringList &arguments, QStr
         exit(1);
     }
 
+    resolveCommandLineValues();
+
+    // see Configuration::parseWithArguments(): the QVariants in the cache cannot contain nullptr
+    fixNullValuesForQml(m_values.openGLConfiguration);
+    fixNullValuesForQml(m_values.installationLocations);
+    fixNullValuesForQml(m_values.containerConfigurations);
+    fixNullValuesForQml(m_values.runtimeConfigurations);
+    for (auto it = m_values.dbusPolicies.begin(); it != m_values.dbusPolicies.end(); ++it)
+        fixNullValuesForQml(it.value());
+    fixNullValuesForQml(m_values.rawSystemProperties);
+    fixNullValuesForQml(m_values.managerCrashAction);
+
     if (!deploymentWarnings)
         return;
 
@@ -146,92 +161,389 @@ void DefaultConfiguration::parseWithArguments(const QStringList &arguments, QStr
                 " remove or access installable applications.");
 }
 
-QString DefaultConfiguration::mainQmlFile() const
+// bump this, whenever the set or the types of the values in save/loadResolvedConfigValues change
+static const quint32 ResolvedValuesVersion = 6;
+
+void DefaultConfiguration::resolveConfigValues()
 {
+    ResolvedValues &v = m_values;
+    v = ResolvedValues();
+
+    v.mainQmlFile = value<QString>(nullptr, { "ui", "mainQml" });
+    v.database = value<QString>(nullptr, { "applications", "database" });
+    v.manifestChecksums = value<bool>(nullptr, { "applications", "manifestChecksums" });
+    v.builtinAppsManifestDirs = value<QStringList>(nullptr, { "applications", "builtinAppsManifestDir" });
+    v.installedAppsManifestDir = value<QString>(nullptr, { "applications", "installedAppsManifestDir" });
+    v.appImageMountDir = value<QString>(nullptr, { "applications", "appImageMountDir" });
+    const QVariant stopGracePeriod = value<QVariant>(nullptr, { "applications", "stopGracePeriod" });
+    if (stopGracePeriod.isValid())
+        v.stopGracePeriod = qMax(0, stopGracePeriod.toInt());
+    v.disableInstaller = value<bool>(nullptr, { "installer", "disable" });
+    v.disableIntents = value<bool>(nullptr, { "intents", "disable" });
+
+    const QVariantMap timeouts = value<QVariant>(nullptr, { "intents", "timeouts" }).toMap();
+    for (auto it = timeouts.cbegin(); it != timeouts.cend(); ++it) {
+        QVariant t = it.value();
+        if (t.canConvert<int>())
+            v.intentTimeouts.insert(it.key(), t.toInt());
+    }
+
+    v.fullscreen = value<bool>(nullptr, { "ui", "fullscreen" });
+    v.windowIcon = value<QString>(nullptr, { "ui", "windowIcon" });
+    v.importPaths = value<QStringList>(nullptr, { "ui", "importPaths" });
+    v.loadDummyData = value<bool>(nullptr, { "ui", "loadDummyData" });
+    v.noSecurity = value<bool>(nullptr, { "flags", "noSecurity" });
+    v.developmentMode = value<bool>(nullptr, { "flags", "developmentMode" });
+    v.noUiWatchdog = value<bool>(nullptr, { "flags", "noUiWatchdog" });
+    v.forceSingleProcess = value<bool>(nullptr, { "flags", "forceSingleProcess" });
+    v.forceMultiProcess = value<bool>(nullptr, { "flags", "forceMultiProcess" });
+    v.loggingRules = value<QStringList>(nullptr, { "logging", "rules" });
+    v.style = value<QString>(nullptr, { "ui", "style" });
+    v.iconThemeName = value<QString>(nullptr, { "ui", "iconThemeName" });
+    v.iconThemeSearchPaths = value<QStringList>(nullptr, { "ui", "iconThemeSearchPaths" });
+    v.enableTouchEmulation = value<bool>(nullptr, { "ui", "enableTouchEmulation" });
+    v.dltId = value<QString>(nullptr, { "logging", "dlt", "id" });
+    v.dltDescription = value<QString>(nullptr, { "logging", "dlt", "description" });
+
+    v.openGLConfiguration = value<QVariant>(nullptr, { "ui", "opengl" }).toMap();
+    v.installationLocations = value<QVariant>(nullptr, { "installationLocations" }).toList();
+
+    QVariant containerSelection = value<QVariant>(nullptr, { "containers", "selection" });
+
+    // this is easy to get wrong in the config file, so we do not just ignore a map here
+    // (this will in turn trigger the warning below)
+    if (containerSelection.type() == QVariant::Map)
+        containerSelection = QVariantList { containerSelection };
+
+    if (containerSelection.type() == QVariant::String) {
+        v.containerSelectionConfiguration.append(qMakePair(qSL("*"), containerSelection.toString()));
+    } else if (containerSelection.type() == QVariant::List) {
+        QVariantList list = containerSelection.toList();
+        for (const QVariant &selection : list) {
+            if (selection.type() == QVariant::Map) {
+                QVariantMap map = selection.toMap();
+
+                if (map.size() != 1) {
+                    qCWarning(LogSystem) << "The container selection configuration needs to be a list of "
+                                            "single mappings, in order to preserve the evaluation "
+                                            "order: found a mapping with" << map.size() << "entries.";
+                }
+
+                for (auto it = map.cbegin(); it != map.cend(); ++it)
+                    v.containerSelectionConfiguration.append(qMakePair(it.key(), it.value().toString()));
+            }
+        }
+    }
+
+    v.containerConfigurations = value<QVariant>(nullptr, { "containers" }).toMap();
+    v.containerConfigurations.remove(qSL("selection"));
+    v.runtimeConfigurations = value<QVariant>(nullptr, { "runtimes" }).toMap();
+
+    const QVariantMap dbus = value<QVariant>(nullptr, { "dbus" }).toMap();
+    for (auto it = dbus.cbegin(); it != dbus.cend(); ++it) {
+        if (it.value().type() != QVariant::Map)
+            continue;
+        const QVariantMap interfaceConfig = it.value().toMap();
+        v.dbusPolicies.insert(it.key(), interfaceConfig.value(qSL("policy")).toMap());
+        auto registration = interfaceConfig.find(qSL("register"));
+        if (registration != interfaceConfig.cend())
+            v.dbusRegistrations.insert(it.key(), registration->toString());
+    }
+    v.dbusStartSessionBus = value<bool>(nullptr, { "dbus", "startSessionBus" });
+
+    v.rawSystemProperties = value<QVariant>(nullptr, { "systemProperties" }).toMap();
+    v.applicationUserIdSeparation = value<QVariant>(nullptr, { "installer", "applicationUserIdSeparation" }).toMap();
+
+    v.quickLaunchIdleLoad = value<QVariant>(nullptr, { "quicklaunch", "idleLoad" }).toReal();
+    // if you need more than 10 quicklaunchers per runtime, you're probably doing something wrong
+    // or you have a typo in your YAML, which could potentially freeze your target (container
+    // construction can be expensive)
+    v.quickLaunchRuntimesPerContainer = qBound(0, value<QVariant>(nullptr, { "quicklaunch", "runtimesPerContainer" }).toInt(), 10);
+    v.quickLaunchMaximumConcurrentStarts = qBound(1, value<QVariant>(nullptr, { "quicklaunch", "maximumConcurrentStarts" }).toInt(), 10);
+    v.quickLaunchAdaptive = value<bool>(nullptr, { "quicklaunch", "adaptive" });
+    v.quickLaunchMemoryBudget = qMax(0, value<QVariant>(nullptr, { "quicklaunch", "memoryBudget" }).toInt());
+    v.quickLaunchMemoryPerRuntime = value<QVariant>(nullptr, { "quicklaunch", "memoryPerRuntime" }).toInt();
+    if (v.quickLaunchMemoryPerRuntime <= 0)
+        v.quickLaunchMemoryPerRuntime = 50;
+    // an explicit 0 disables the memory pressure handling
+    const QVariant memoryLowThreshold = value<QVariant>(nullptr, { "quicklaunch", "memoryLowThreshold" });
+    v.quickLaunchMemoryLowThreshold = memoryLowThreshold.isValid() ? qBound(qreal(0), memoryLowThreshold.toReal(), qreal(100)) : 75;
+    const QVariant memoryCriticalThreshold = value<QVariant>(nullptr, { "quicklaunch", "memoryCriticalThreshold" });
+    v.quickLaunchMemoryCriticalThreshold = memoryCriticalThreshold.isValid() ? qBound(qreal(0), memoryCriticalThreshold.toReal(), qreal(100)) : 90;
+
+    v.memoryEviction = value<QVariant>(nullptr, { "memoryEviction" }).toMap();
+
+    v.telnetAddress = value<QString>(nullptr, { "debug", "telnetAddress" });
+    if (v.telnetAddress.isEmpty())
+        v.telnetAddress = qSL("0.0.0.0");
+    v.telnetPort = value<QVariant>(nullptr, { "debug", "telnetPort" }).value<quint16>();
+
+    v.managerCrashAction = value<QVariant>(nullptr, { "crashAction" }).toMap();
+    v.caCertificates = value<QStringList>(nullptr, { "installer", "caCertificates" });
+
+    const QVariantMap plugins = value<QVariant>(nullptr, { "plugins" }).toMap();
+    for (auto it = plugins.cbegin(); it != plugins.cend(); ++it)
+        v.pluginFilePaths.insert(it.key(), variantToStringList(it.value()));
+}
+
+void DefaultConfiguration::saveResolvedConfigValues(QDataStream &ds) const
+{
+    const ResolvedValues &v = m_values;
+
+    ds << ResolvedValuesVersion
+       << v.mainQmlFile
+       << v.database
+       << v.manifestChecksums
+       << v.builtinAppsManifestDirs
+       << v.installedAppsManifestDir
+       << v.appImageMountDir
+       << v.stopGracePeriod
+       << v.disableInstaller
+       << v.disableIntents
+       << v.intentTimeouts
+       << v.fullscreen
+       << v.windowIcon
+       << v.importPaths
+       << v.loadDummyData
+       << v.noSecurity
+       << v.developmentMode
+       << v.noUiWatchdog
+       << v.forceSingleProcess
+       << v.forceMultiProcess
+       << v.loggingRules
+       << v.style
+       << v.iconThemeName
+       << v.iconThemeSearchPaths
+       << v.enableTouchEmulation
+       << v.dltId
+       << v.dltDescription
+       << v.openGLConfiguration
+       << v.installationLocations
+       << v.containerSelectionConfiguration
+       << v.containerConfigurations
+       << v.runtimeConfigurations
+       << v.dbusPolicies
+       << v.dbusRegistrations
+       << v.dbusStartSessionBus
+       << v.rawSystemProperties
+       << v.applicationUserIdSeparation
+       << v.quickLaunchIdleLoad
+       << v.quickLaunchRuntimesPerContainer
+       << v.quickLaunchMaximumConcurrentStarts
+       << v.quickLaunchAdaptive
+       << v.quickLaunchMemoryBudget
+       << v.quickLaunchMemoryPerRuntime
+       << v.quickLaunchMemoryLowThreshold
+       << v.quickLaunchMemoryCriticalThreshold
+       << v.memoryEviction
+       << v.telnetAddress
+       << v.telnetPort
+       << v.managerCrashAction
+       << v.caCertificates
+       << v.pluginFilePaths;
+}
+
+bool DefaultConfiguration::loadResolvedConfigValues(QDataStream &ds)
+{
+    ResolvedValues &v = m_values;
+    v = ResolvedValues();
+
+    quint32 version = 0;
+    ds >> version;
+    if (version != ResolvedValuesVersion)
+        return false;
+
+    ds >> v.mainQmlFile
+       >> v.database
+       >> v.manifestChecksums
+       >> v.builtinAppsManifestDirs
+       >> v.installedAppsManifestDir
+       >> v.appImageMountDir
+       >> v.stopGracePeriod
+       >> v.disableInstaller
+       >> v.disableIntents
+       >> v.intentTimeouts
+       >> v.fullscreen
+       >> v.windowIcon
+       >> v.importPaths
+       >> v.loadDummyData
+       >> v.noSecurity
+       >> v.developmentMode
+       >> v.noUiWatchdog
+       >> v.forceSingleProcess
+       >> v.forceMultiProcess
+       >> v.loggingRules
+       >> v.style
+       >> v.iconThemeName
+       >> v.iconThemeSearchPaths
+       >> v.enableTouchEmulation
+       >> v.dltId
+       >> v.dltDescription
+       >> v.openGLConfiguration
+       >> v.installationLocations
+       >> v.containerSelectionConfiguration
+       >> v.containerConfigurations
+       >> v.runtimeConfigurations
+       >> v.dbusPolicies
+       >> v.dbusRegistrations
+       >> v.dbusStartSessionBus
+       >> v.rawSystemProperties
+       >> v.applicationUserIdSeparation
+       >> v.quickLaunchIdleLoad
+       >> v.quickLaunchRuntimesPerContainer
+       >> v.quickLaunchMaximumConcurrentStarts
+       >> v.quickLaunchAdaptive
+       >> v.quickLaunchMemoryBudget
+       >> v.quickLaunchMemoryPerRuntime
+       >> v.quickLaunchMemoryLowThreshold
+       >> v.quickLaunchMemoryCriticalThreshold
+       >> v.memoryEviction
+       >> v.telnetAddress
+       >> v.telnetPort
+       >> v.managerCrashAction
+       >> v.caCertificates
+       >> v.pluginFilePaths;
+
+    return ds.status() == QDataStream::Ok;
+}
+
+void DefaultConfiguration::resolveCommandLineValues()
+{
+    ResolvedValues &v = m_values;
+
+    auto isSet = [this](const char *name) { return m_clp.isSet(qL1S(name)); };
+    auto applyBool = [&isSet](bool &value, const char *name) {
+        if (isSet(name))
+            value = true;
+    };
+    auto applyString = [this, &isSet](QString &value, const char *name) {
+        if (isSet(name))
+            value = m_clp.value(qL1S(name));
+    };
+    auto applyStringList = [this](QStringList &value, const char *name) {
+        value = m_clp.values(qL1S(name)) + value;
+    };
+
     if (!m_clp.positionalArguments().isEmpty() && m_clp.positionalArguments().at(0).endsWith(qL1S(".qml")))
-        return m_clp.positionalArguments().at(0);
-    else
-        return value<QString>(nullptr, { "ui", "mainQml" });
+        v.mainQmlFile = m_clp.positionalArguments().at(0);
+
+    applyString(v.database, "database");
+    applyBool(v.recreateDatabase, "recreate-database");
+    applyStringList(v.builtinAppsManifestDirs, "builtin-apps-manifest-dir");
+    applyString(v.installedAppsManifestDir, "installed-apps-manifest-dir");
+    applyString(v.appImageMountDir, "app-image-mount-dir");
+    applyBool(v.disableInstaller, "disable-installer");
+    applyBool(v.disableIntents, "disable-intents");
+
+    applyBool(v.fullscreen, "fullscreen");
+    applyBool(v.noFullscreen, "no-fullscreen");
+    applyStringList(v.importPaths, "I");
+    for (int i = 0; i < v.importPaths.size(); ++i)
+        v.importPaths[i] = QFileInfo(v.importPaths.at(i)).absoluteFilePath();
+    applyBool(v.verbose, "verbose");
+    applyBool(v.slowAnimations, "slow-animations");
+    applyBool(v.loadDummyData, "load-dummydata");
+    applyBool(v.noSecurity, "no-security");
+    applyBool(v.developmentMode, "development-mode");
+    applyBool(v.noUiWatchdog, "no-ui-watchdog");
+    applyBool(v.noDltLogging, "no-dlt-logging");
+    applyBool(v.forceSingleProcess, "force-single-process");
+    applyBool(v.forceMultiProcess, "force-multi-process");
+    applyBool(v.qmlDebugging, "qml-debug");
+    applyString(v.singleApp, "single-app");
+    applyStringList(v.loggingRules, "logging-rule");
+    applyBool(v.enableTouchEmulation, "enable-touch-emulation");
+
+#if defined(QT_DBUS_LIB)
+    // the command line option has a default value, which is used for all interfaces that have no
+    // explicit registration in the config file
+    v.dbusDefaultRegistration = m_clp.value(qSL("dbus"));
+    if (isSet("dbus"))
+        v.dbusRegistrations.clear();
+    applyBool(v.dbusStartSessionBus, "start-session-dbus");
+#endif
+}
+
+QString DefaultConfiguration::mainQmlFile() const
+{
+    return m_values.mainQmlFile;
 }
 
 
 QString DefaultConfiguration::database() const
 {
-    return value<QString>("database", { "applications", "database" });
+    return m_values.database;
 }
 
 bool DefaultConfiguration::recreateDatabase() const
 {
-    return value<bool>("recreate-database");
+    return m_values.recreateDatabase;
+}
+
+bool DefaultConfiguration::manifestChecksums() const
+{
+    return m_values.manifestChecksums;
 }
 
 QStringList DefaultConfiguration::builtinAppsManifestDirs() const
 {
-    return value<QStringList>("builtin-apps-manifest-dir", { "applications", "builtinAppsManifestDir" });
+    return m_values.builtinAppsManifestDirs;
 }
 
 QString DefaultConfiguration::installedAppsManifestDir() const
 {
-    return value<QString>("installed-apps-manifest-dir", { "applications", "installedAppsManifestDir" });
+    return m_values.installedAppsManifestDir;
 }
 
 QString DefaultConfiguration::appImageMountDir() const
 {
-    return value<QString>("app-image-mount-dir", { "applications", "appImageMountDir" });
+    return m_values.appImageMountDir;
+}
+
+int DefaultConfiguration::stopGracePeriod() const
+{
+    return m_values.stopGracePeriod;
 }
 
 bool DefaultConfiguration::disableInstaller() const
 {
-    return value<bool>("disable-installer", { "installer", "disable" });
+    return m_values.disableInstaller;
 }
 
 bool DefaultConfiguration::disableIntents() const
 {
-    return value<bool>("disable-intents", { "intents", "disable" });
+    return m_values.disableIntents;
 }
 
 QMap<QString, int> DefaultConfiguration::intentTimeouts() const
 {
-    QVariantMap map = value<QVariant>(nullptr, { "intents", "timeouts" }).toMap();
-    QMap<QString, int> timeouts;
-
-    for (auto it = map.cbegin(); it != map.cend(); ++it) {
-        QVariant v = it.value();
-        if (v.canConvert<int>())
-            timeouts.insert(it.key(), v.toInt());
-    }
-    return timeouts;
+    return m_values.intentTimeouts;
 }
 
 
 bool DefaultConfiguration::fullscreen() const
 {
-    return value<bool>("fullscreen", { "ui", "fullscreen" });
+    return m_values.fullscreen;
 }
 
 bool DefaultConfiguration::noFullscreen() const
 {
-    return value<bool>("no-fullscreen");
+    return m_values.noFullscreen;
 }
 
 QString DefaultConfiguration::windowIcon() const
 {
-    return value<QString>(nullptr, { "ui", "windowIcon" });
+    return m_values.windowIcon;
 }
 
 QStringList DefaultConfiguration::importPaths() const
 {
-    QStringList importPaths = value<QStringList>("I", { "ui", "importPaths" });
-
-    for (int i = 0; i < importPaths.size(); ++i)
-        importPaths[i] = QFileInfo(importPaths.at(i)).absoluteFilePath();
-
-    return importPaths;
+    return m_values.importPaths;
 }
 
 bool DefaultConfiguration::verbose() const
 {
-    return value<bool>("verbose") || m_forceVerbose;
+    return m_values.verbose || m_forceVerbose;
 }
 
 void QtAM::DefaultConfiguration::setForceVerbose(bool forceVerbose)
@@ -241,151 +553,122 @@ void QtAM::DefaultConfiguration::setForceVerbose(bool forceVerbose)
 
 bool DefaultConfiguration::slowAnimations() const
 {
-    return value<bool>("slow-animations");
+    return m_values.slowAnimations;
 }
 
 bool DefaultConfiguration::loadDummyData() const
 {
-    return value<bool>("load-dummydata", { "ui", "loadDummyData" });
+    return m_values.loadDummyData;
 }
 
 bool DefaultConfiguration::noSecurity() const
 {
-    return value<bool>("no-security", { "flags", "noSecurity" });
+    return m_values.noSecurity;
 }
 
 bool DefaultConfiguration::developmentMode() const
 {
-    return value<bool>("development-mode", { "flags", "developmentMode" });
+    return m_values.developmentMode;
 }
 
 bool DefaultConfiguration::noUiWatchdog() const
 {
-    return value<bool>("no-ui-watchdog", { "flags", "noUiWatchdog" });
+    return m_values.noUiWatchdog;
 }
 
 bool DefaultConfiguration::noDltLogging() const
 {
-    return value<bool>("no-dlt-logging");
+    return m_values.noDltLogging;
 }
 
 bool DefaultConfiguration::forceSingleProcess() const
 {
-    return value<bool>("force-single-process", { "flags", "forceSingleProcess" });
+    return m_values.forceSingleProcess;
 }
 
 bool DefaultConfiguration::forceMultiProcess() const
 {
-    return value<bool>("force-multi-process", { "flags", "forceMultiProcess" });
+    return m_values.forceMultiProcess;
 }
 
 bool DefaultConfiguration::qmlDebugging() const
 {
-    return value<bool>("qml-debug");
+    return m_values.qmlDebugging;
 }
 
 QString DefaultConfiguration::singleApp() const
 {
-    return value<QString>("single-app");
+    return m_values.singleApp;
 }
 
 QStringList DefaultConfiguration::loggingRules() const
 {
-    return value<QStringList>("logging-rule", { "logging", "rules" });
+    return m_values.loggingRules;
 }
 
 QString DefaultConfiguration::style() const
 {
-    return value<QString>(nullptr, { "ui", "style" });
+    return m_values.style;
 }
 
 QString DefaultConfiguration::iconThemeName() const
 {
-    return value<QString>(nullptr, { "ui", "iconThemeName" });
+    return m_values.iconThemeName;
 }
 
 QStringList DefaultConfiguration::iconThemeSearchPaths() const
 {
-    return value<QStringList>(nullptr, { "ui", "iconThemeSearchPaths" });
+    return m_values.iconThemeSearchPaths;
 }
 
 bool DefaultConfiguration::enableTouchEmulation() const
 {
-    return value<bool>("enable-touch-emulation", { "ui", "enableTouchEmulation" });
+    return m_values.enableTouchEmulation;
 }
 
 QString DefaultConfiguration::dltId() const
 {
-    return value<QString>(nullptr, { "logging", "dlt", "id" });
+    return m_values.dltId;
 }
 
 QString DefaultConfiguration::dltDescription() const
 {
-    return value<QString>(nullptr, { "logging", "dlt", "description" });
+    return m_values.dltDescription;
 }
 
 QVariantMap DefaultConfiguration::openGLConfiguration() const
 {
-    return value<QVariant>(nullptr, { "ui", "opengl" }).toMap();
+    return m_values.openGLConfiguration;
 }
 
 QVariantList DefaultConfiguration::installationLocations() const
 {
-    return value<QVariant>(nullptr, { "installationLocations" }).toList();
+    return m_values.installationLocations;
 }
 
 QList<QPair<QString, QString>> DefaultConfiguration::containerSelectionConfiguration() const
 {
-    QList<QPair<QString, QString>> config;
-    QVariant containerSelection = value<QVariant>(nullptr, { "containers", "selection" });
-
-    // this is easy to get wrong in the config file, so we do not just ignore a map here
-    // (this will in turn trigger the warning below)
-    if (containerSelection.type() == QVariant::Map)
-        containerSelection = QVariantList { containerSelection };
-
-    if (containerSelection.type() == QVariant::String) {
-        config.append(qMakePair(qSL("*"), containerSelection.toString()));
-    } else if (containerSelection.type() == QVariant::List) {
-        QVariantList list = containerSelection.toList();
-        for (const QVariant &v : list) {
-            if (v.type() == QVariant::Map) {
-                QVariantMap map = v.toMap();
-
-                if (map.size() != 1) {
-                    qCWarning(LogSystem) << "The container selection configuration needs to be a list of "
-                                            "single mappings, in order to preserve the evaluation "
-                                            "order: found a mapping with" << map.size() << "entries.";
-                }
-
-                for (auto it = map.cbegin(); it != map.cend(); ++it)
-                    config.append(qMakePair(it.key(), it.value().toString()));
-            }
-        }
-    }
-    return config;
+    return m_values.containerSelectionConfiguration;
 }
 
 QVariantMap DefaultConfiguration::containerConfigurations() const
 {
-    QVariantMap map = value<QVariant>(nullptr, { "containers" }).toMap();
-    map.remove(qSL("selection"));
-    return map;
+    return m_values.containerConfigurations;
 }
 
 QVariantMap DefaultConfiguration::runtimeConfigurations() const
 {
-    return value<QVariant>(nullptr, { "runtimes" }).toMap();
+    return m_values.runtimeConfigurations;
 }
 
 QVariantMap DefaultConfiguration::dbusPolicy(const char *interfaceName) const
 {
-    return value<QVariant>(nullptr, { "dbus", interfaceName, "policy" }).toMap();
+    return m_values.dbusPolicies.value(qL1S(interfaceName));
 }
 
 QString DefaultConfiguration::dbusRegistration(const char *interfaceName) const
 {
-    QString dbus = value<QString>("dbus", { "dbus", interfaceName, "register" });
+    QString dbus = m_values.dbusRegistrations.value(qL1S(interfaceName), m_values.dbusDefaultRegistration);
     if (dbus == qL1S("none"))
         dbus.clear();
     return dbus;
@@ -393,18 +676,18 @@ QString DefaultConfiguration::dbusRegistration(const char *interfaceName) const
 
 bool DefaultConfiguration::dbusStartSessionBus() const
 {
-    return value<bool>("start-session-dbus", { "dbus", "startSessionBus" });
+    return m_values.dbusStartSessionBus;
 }
 
 QVariantMap DefaultConfiguration::rawSystemProperties() const
 {
-    return value<QVariant>(nullptr, { "systemProperties" }).toMap();
+    return m_values.rawSystemProperties;
 }
 
 bool DefaultConfiguration::applicationUserIdSeparation(uint *minUserId, uint *maxUserId, uint *commonGroupId) const
 {
     bool found = false;
-    QVariantMap map = value<QVariant>(nullptr, { "installer", "applicationUserIdSeparation" }).toMap();
+    const QVariantMap &map = m_values.applicationUserIdSeparation;
 
     if (found) {
         auto idFromMap = [&map](const char *key) -> uint {
@@ -433,17 +716,47 @@ bool DefaultConfiguration::applicationUserIdSeparation(uint *minUserId, uint *ma
 
 qreal DefaultConfiguration::quickLaunchIdleLoad() const
 {
-    return value<QVariant>(nullptr, { "quicklaunch", "idleLoad" }).toReal();
+    return m_values.quickLaunchIdleLoad;
 }
 
 int DefaultConfiguration::quickLaunchRuntimesPerContainer() const
 {
-    int rpc = value<QVariant>(nullptr, { "quicklaunch", "runtimesPerContainer" }).toInt();
+    return m_values.quickLaunchRuntimesPerContainer;
+}
 
-    // if you need more than 10 quicklaunchers per runtime, you're probably doing something wrong
-    // or you have a typo in your YAML, which could potentially freeze your target (container
-    // construction can be expensive)
-    return qBound(0, rpc, 10);
+int DefaultConfiguration::quickLaunchMaximumConcurrentStarts() const
+{
+    return m_values.quickLaunchMaximumConcurrentStarts;
+}
+
+bool DefaultConfiguration::quickLaunchAdaptive() const
+{
+    return m_values.quickLaunchAdaptive;
+}
+
+int DefaultConfiguration::quickLaunchMemoryBudget() const
+{
+    return m_values.quickLaunchMemoryBudget;
+}
+
+int DefaultConfiguration::quickLaunchMemoryPerRuntime() const
+{
+    return m_values.quickLaunchMemoryPerRuntime;
+}
+
+qreal DefaultConfiguration::quickLaunchMemoryLowThreshold() const
+{
+    return m_values.quickLaunchMemoryLowThreshold;
+}
+
+qreal DefaultConfiguration::quickLaunchMemoryCriticalThreshold() const
+{
+    return m_values.quickLaunchMemoryCriticalThreshold;
+}
+
+QVariantMap DefaultConfiguration::memoryEviction() const
+{
+    return m_values.memoryEviction;
 }
 
 QString DefaultConfiguration::waylandSocketName() const
@@ -467,30 +780,27 @@ QString DefaultConfiguration::waylandSocketName() const
 
 QString DefaultConfiguration::telnetAddress() const
 {
-    QString s = value<QString>(nullptr, { "debug", "telnetAddress" });
-    if (s.isEmpty())
-        s = qSL("0.0.0.0");
-    return s;
+    return m_values.telnetAddress;
 }
 
 quint16 DefaultConfiguration::telnetPort() const
 {
-    return value<QVariant>(nullptr, { "debug", "telnetPort" }).value<quint16>();
+    return m_values.telnetPort;
 }
 
 QVariantMap DefaultConfiguration::managerCrashAction() const
 {
-    return value<QVariant>(nullptr, { "crashAction"} ).toMap();
+    return m_values.managerCrashAction;
 }
 
 QStringList DefaultConfiguration::caCertificates() const
 {
-    return value<QStringList>(nullptr, { "installer", "caCertificates" });
+    return m_values.caCertificates;
 }
 
 QStringList DefaultConfiguration::pluginFilePaths(const char *type) const
 {
-    return value<QStringList>(nullptr, { "plugins", type });
+    return m_values.pluginFilePaths.value(qL1S(type));
 }
 
 QStringList DefaultConfiguration::testRunnerArguments() const
@@ -63,10 +63,12 @@ public:
     QString mainQmlFile() const;
     QString database() const;
     bool recreateDatabase() const;
+    bool manifestChecksums() const;
 
     QStringList builtinAppsManifestDirs() const;
     QString installedAppsManifestDir() const;
     QString appImageMountDir() const;
+    int stopGracePeriod() const;
     bool disableInstaller() const;
     bool disableIntents() const;
     QMap<QString, int> intentTimeouts() const;
@@ -113,6 +115,14 @@ public:
 
     qreal quickLaunchIdleLoad() const;
     int quickLaunchRuntimesPerContainer() const;
+    int quickLaunchMaximumConcurrentStarts() const;
+    bool quickLaunchAdaptive() const;
+    int quickLaunchMemoryBudget() const;
+    int quickLaunchMemoryPerRuntime() const;
+    qreal quickLaunchMemoryLowThreshold() const;
+    qreal quickLaunchMemoryCriticalThreshold() const;
+
+    QVariantMap memoryEviction() const;
 
     QString waylandSocketName() const;
 
@@ -127,10 +137,89 @@ public:
 
     QStringList testRunnerArguments() const;
 
+protected:
+    void resolveConfigValues() override;
+    void saveResolvedConfigValues(QDataStream &ds) const override;
+    bool loadResolvedConfigValues(QDataStream &ds) override;
+
 private:
-    QString m_mainQmlFile;
+    void resolveCommandLineValues();
+
     bool m_onlyOnePositionalArgument = false;
     bool m_forceVerbose = false;
+
+    // All values are resolved once in parseWithArguments(): the config file part is stored in
+    // the config cache and the command line options are applied on top afterwards.
+    struct ResolvedValues
+    {
+        QString mainQmlFile;
+        QString database;
+        bool recreateDatabase = false;
+        bool manifestChecksums = false;
+        QStringList builtinAppsManifestDirs;
+        QString installedAppsManifestDir;
+        QString appImageMountDir;
+        int stopGracePeriod = 5000;
+        bool disableInstaller = false;
+        bool disableIntents = false;
+        QMap<QString, int> intentTimeouts;
+
+        bool fullscreen = false;
+        bool noFullscreen = false;
+        QString windowIcon;
+        QStringList importPaths;
+        bool verbose = false;
+        bool slowAnimations = false;
+        bool loadDummyData = false;
+        bool noSecurity = false;
+        bool developmentMode = false;
+        bool noUiWatchdog = false;
+        bool noDltLogging = false;
+        bool forceSingleProcess = false;
+        bool forceMultiProcess = false;
+        bool qmlDebugging = false;
+        QString singleApp;
+        QStringList loggingRules;
+        QString style;
+        QString iconThemeName;
+        QStringList iconThemeSearchPaths;
+        bool enableTouchEmulation = false;
+        QString dltId;
+        QString dltDescription;
+
+        QVariantMap openGLConfiguration;
+        QVariantList installationLocations;
+
+        QList<QPair<QString, QString>> containerSelectionConfiguration;
+        QVariantMap containerConfigurations;
+        QVariantMap runtimeConfigurations;
+
+        QMap<QString, QVariantMap> dbusPolicies;
+        QMap<QString, QString> dbusRegistrations;
+        QString dbusDefaultRegistration;
+        bool dbusStartSessionBus = false;
+
+        QVariantMap rawSystemProperties;
+        QVariantMap applicationUserIdSeparation;
+
+        qreal quickLaunchIdleLoad = 0;
+        int quickLaunchRuntimesPerContainer = 0;
+        int quickLaunchMaximumConcurrentStarts = 1;
+        bool quickLaunchAdaptive = false;
+        int quickLaunchMemoryBudget = 0;
+        int quickLaunchMemoryPerRuntime = 0;
+        qreal quickLaunchMemoryLowThreshold = 0;
+        qreal quickLaunchMemoryCriticalThreshold = 0;
+
+        QVariantMap memoryEviction;
+
+        QString telnetAddress;
+        quint16 telnetPort = 0;
+
+        QVariantMap managerCrashAction;
+        QStringList caCertificates;
+        QMap<QString, QStringList> pluginFilePaths;
+    } m_values;
 };
 
 QT_END_NAMESPACE_AM
@@ -32,11 +32,13 @@ DEFINES += AM_BUILD_DIR=\\\"$$BUILD_DIR\\\"
 HEADERS += \
     $$PWD/configuration.h \
     $$PWD/main.h \
-    $$PWD/defaultconfiguration.h
+    $$PWD/defaultconfiguration.h \
+    $$PWD/startupgraph.h
 
 SOURCES += \
     $$PWD/main.cpp \
     $$PWD/configuration.cpp \
-    $$PWD/defaultconfiguration.cpp
+    $$PWD/defaultconfiguration.cpp \
+    $$PWD/startupgraph.cpp
 
 load(qt_module)
@@ -70,6 +70,11 @@
 #include <QProcess>
 #include <QQmlDebuggingEnabler>
 #include <QNetworkInterface>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QLibraryInfo>
+#include <QtConcurrent/QtConcurrent>
 #include <private/qabstractanimation_p.h>
 
 #if !defined(AM_HEADLESS)
@@ -79,6 +84,10 @@
 #  include <private/qopenglcontext_p.h>
 #endif
 
+#if defined(Q_OS_UNIX)
+#  include <sys/stat.h>
+#endif
+
 #if defined(QT_PSHELLSERVER_LIB)
 #  include <PShellServer/PTelnetServer>
 #  include <PShellServer/PAbstractShell>
@@ -105,6 +114,8 @@
 #include "runtimefactory.h"
 #include "containerfactory.h"
 #include "quicklauncher.h"
+#include "stopcoordinator.h"
+#include "launchstatistics.h"
 #if defined(AM_MULTI_PROCESS)
 #  include "processcontainer.h"
 #  include "nativeruntime.h"
@@ -132,6 +143,7 @@
 #include "utilities.h"
 #include "exception.h"
 #include "crashhandler.h"
+#include "startupgraph.h"
 #include "qmllogger.h"
 #include "startuptimer.h"
 #include "applicationipcmanager.h"
@@ -143,6 +155,7 @@
 #include "gpustatus.h"
 #include "iostatus.h"
 #include "memorystatus.h"
+#include "memoryevictionpolicy.h"
 #include "monitormodel.h"
 #include "processstatus.h"
 
@@ -151,6 +164,9 @@
 
 QT_BEGIN_NAMESPACE_AM
 
+// use QtConcurrent to scan the application directories, if there are more than x of them
+static const int ParallelScanThreshold = 1;
+
 // The QGuiApplication constructor
 
 Main::Main(int &argc, char **argv)
@@ -166,6 +182,7 @@ Main::Main(int &argc, char **argv)
         fputs("\n*** received SIGINT / Ctrl+C ... exiting ***\n\n", stderr);
         static_cast<Main *>(QCoreApplication::instance())->shutDown();
     });
+    StartupTimer::instance()->setTraceProcessName(qSL("System-UI"));
     StartupTimer::instance()->checkpoint("after application constructor");
 }
 
@@ -216,46 +233,139 @@ void Main::setup(const DefaultConfiguration *cfg, const QStringList &deploymentW
     for (const QString &warning : deploymentWarnings)
         qCWarning(LogDeployment).noquote() << warning;
 
-    setupOpenGL(cfg->openGLConfiguration());
-    setupIconTheme(cfg->iconThemeSearchPaths(), cfg->iconThemeName());
+    // The remaining setup is a graph of stages with explicit dependencies: stages that do not
+    // need the main thread run in parallel to the ones that do (see StartupGraph).
+    StartupGraph graph;
 
-    loadStartupPlugins(cfg->pluginFilePaths("startup"));
-    parseSystemProperties(cfg->rawSystemProperties());
+    const bool startSessionBus = cfg->dbusStartSessionBus();
+    graph.addStage("session-bus-launch", StartupGraph::MainThread, { }, [this, startSessionBus]() {
+        launchDBus(startSessionBus);
+    });
 
-    setMainQmlFile(cfg->mainQmlFile());
-    setupSingleOrMultiProcess(cfg->forceSingleProcess(), cfg->forceMultiProcess());
-    setupRuntimesAndContainers(cfg->runtimeConfigurations(), cfg->openGLConfiguration(),
-                               cfg->containerConfigurations(), cfg->pluginFilePaths("container"),
-                               cfg->iconThemeSearchPaths(), cfg->iconThemeName());
-    if (!cfg->disableInstaller())
-        setupInstallationLocations(cfg->installationLocations());
+    const bool disableInstaller = cfg->disableInstaller();
+    graph.addStage("hardware-id", StartupGraph::WorkerThread, { }, [this, disableInstaller]() {
+        if (!disableInstaller)
+            m_hardwareId = hardwareId();
+    });
 
-    if (!cfg->database().isEmpty())
-        loadApplicationDatabase(cfg->database(), cfg->recreateDatabase(), cfg->singleApp());
+    graph.addStage("basics", StartupGraph::MainThread, { }, [this, cfg]() {
+        setupOpenGL(cfg->openGLConfiguration());
+        setupIconTheme(cfg->iconThemeSearchPaths(), cfg->iconThemeName());
 
-    setupSingletons(cfg->containerSelectionConfiguration(), cfg->quickLaunchRuntimesPerContainer(),
-                    cfg->quickLaunchIdleLoad(), cfg->singleApp());
+        loadStartupPlugins(cfg->pluginFilePaths("startup"));
+        parseSystemProperties(cfg->rawSystemProperties());
 
-    if (m_installedAppsManifestDir.isEmpty() || cfg->disableInstaller()) {
-        StartupTimer::instance()->checkpoint("skipping installer");
-    } else {
-        setupInstaller(cfg->appImageMountDir(), cfg->caCertificates(),
-                       std::bind(&DefaultConfiguration::applicationUserIdSeparation, cfg,
-                                 std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    }
-    if (!cfg->disableIntents())
-        setupIntents(cfg->intentTimeouts());
-
-    setupQmlEngine(cfg->importPaths(), cfg->style());
-    setupWindowTitle(QString(), cfg->windowIcon());
-    setupWindowManager(cfg->waylandSocketName(), cfg->slowAnimations(), cfg->noUiWatchdog());
-    setupTouchEmulation(cfg->enableTouchEmulation());
-    setupShellServer(cfg->telnetAddress(), cfg->telnetPort());
-    setupSSDPService();
-
-    setupDBus(cfg->dbusStartSessionBus());
-    registerDBusInterfaces(std::bind(&DefaultConfiguration::dbusRegistration, cfg, std::placeholders::_1),
-                           std::bind(&DefaultConfiguration::dbusPolicy, cfg, std::placeholders::_1));
+        setMainQmlFile(cfg->mainQmlFile());
+        setupSingleOrMultiProcess(cfg->forceSingleProcess(), cfg->forceMultiProcess());
+    });
+
+    graph.addStage("runtimes", StartupGraph::MainThread, { "basics" }, [this, cfg]() {
+        setupRuntimesAndContainers(cfg->runtimeConfigurations(), cfg->openGLConfiguration(),
+                                   cfg->containerConfigurations(), cfg->pluginFilePaths("container"),
+                                   cfg->iconThemeSearchPaths(), cfg->iconThemeName());
+    });
+
+    graph.addStage("installation-locations", StartupGraph::MainThread, { "hardware-id" }, [this, cfg, disableInstaller]() {
+        if (!disableInstaller)
+            setupInstallationLocations(cfg->installationLocations());
+    });
+
+    // worker stages get copies of their configuration values
+    const QString database = cfg->database();
+    const bool recreateDatabase = cfg->recreateDatabase();
+    const bool manifestChecksums = cfg->manifestChecksums();
+    const QString singleApp = cfg->singleApp();
+    QVector<ApplicationDirectory> appDirs;
+    QMap<QString, QByteArray> appDirFingerprints;
+    graph.addStage("application-fingerprints", StartupGraph::WorkerThread, { "runtimes", "installation-locations" },
+                   [this, database, manifestChecksums, singleApp, &appDirs, &appDirFingerprints]() {
+        if (!database.isEmpty() && singleApp.isEmpty()) {
+            appDirs = findApplicationDirectories(m_builtinAppsManifestDirs, m_installedAppsManifestDir);
+            appDirFingerprints = applicationDirectoryFingerprints(appDirs, manifestChecksums);
+        }
+    });
+
+    // the ApplicationDatabase owns QFile objects, so it has to be created on the main thread
+    graph.addStage("application-database", StartupGraph::MainThread, { "application-fingerprints" },
+                   [this, database, recreateDatabase, manifestChecksums, singleApp, &appDirs, &appDirFingerprints]() {
+        if (!database.isEmpty())
+            loadApplicationDatabase(database, recreateDatabase, manifestChecksums, singleApp, appDirs, appDirFingerprints);
+    });
+
+    const bool enableInstaller = !m_installedAppsManifestDir.isEmpty() && !disableInstaller;
+    const QStringList caCertificatePaths = (enableInstaller && !m_noSecurity) ? cfg->caCertificates()
+                                                                              : QStringList();
+    QList<QByteArray> caCertificates;
+    graph.addStage("ca-certificates", StartupGraph::WorkerThread, { }, [caCertificatePaths, &caCertificates]() {
+        caCertificates = loadCACertificates(caCertificatePaths);
+    });
+
+    graph.addStage("qml-engine", StartupGraph::MainThread, { "basics" }, [this, cfg]() {
+        setupQmlEngine(cfg->importPaths(), cfg->style());
+    });
+
+    graph.addStage("singletons", StartupGraph::MainThread, { "runtimes", "application-database" }, [this, cfg]() {
+        QuickLauncher::instance()->setMaximumConcurrentStarts(cfg->quickLaunchMaximumConcurrentStarts());
+        if (cfg->quickLaunchAdaptive()) {
+            const QDir cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+            if (!cacheLocation.exists())
+                cacheLocation.mkpath(qSL("."));
+
+            QuickLauncher::instance()->enableAdaptiveSizing(cacheLocation.absoluteFilePath(qSL("appman-quicklaunch-history.cache")),
+                                                            cfg->quickLaunchMemoryBudget(),
+                                                            cfg->quickLaunchMemoryPerRuntime());
+        }
+        if ((cfg->quickLaunchRuntimesPerContainer() > 0) && (cfg->quickLaunchMemoryLowThreshold() > 0)) {
+            qreal criticalThreshold = cfg->quickLaunchMemoryCriticalThreshold();
+            if (criticalThreshold <= 0)
+                criticalThreshold = 100;
+            QuickLauncher::instance()->enableMemoryPressureHandling(cfg->quickLaunchMemoryLowThreshold(),
+                                                                    qMax(criticalThreshold, cfg->quickLaunchMemoryLowThreshold()));
+        }
+        setupSingletons(cfg->containerSelectionConfiguration(), cfg->quickLaunchRuntimesPerContainer(),
+                        cfg->quickLaunchIdleLoad(), cfg->singleApp());
+        m_applicationManager->setStopGracePeriod(cfg->stopGracePeriod());
+
+        // does nothing, if no memoryEviction/lowThreshold is configured
+        (new MemoryEvictionPolicy(cfg->memoryEviction(), this))->start();
+    });
+
+    graph.addStage("installer", StartupGraph::MainThread, { "singletons", "ca-certificates" },
+                   [this, cfg, enableInstaller, &caCertificates]() {
+        if (!enableInstaller) {
+            StartupTimer::instance()->checkpoint("skipping installer");
+        } else {
+            setupInstaller(cfg->appImageMountDir(), caCertificates,
+                           std::bind(&DefaultConfiguration::applicationUserIdSeparation, cfg,
+                                     std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+        }
+    });
+
+    graph.addStage("intents", StartupGraph::MainThread, { "installer" }, [this, cfg]() {
+        if (!cfg->disableIntents())
+            setupIntents(cfg->intentTimeouts());
+    });
+
+    graph.addStage("ui", StartupGraph::MainThread, { "qml-engine", "singletons" }, [this, cfg]() {
+        setupWindowTitle(QString(), cfg->windowIcon());
+        setupWindowManager(cfg->waylandSocketName(), cfg->slowAnimations(), cfg->noUiWatchdog());
+        setupTouchEmulation(cfg->enableTouchEmulation());
+        setupShellServer(cfg->telnetAddress(), cfg->telnetPort());
+        setupSSDPService();
+    });
+
+    // declared late on purpose: gives the dbus-daemon as much time as possible to start up
+    graph.addStage("session-bus", StartupGraph::MainThread, { "session-bus-launch" }, [this, startSessionBus]() {
+        setupDBus(startSessionBus);
+    });
+
+    graph.addStage("dbus-interfaces", StartupGraph::MainThread, { "session-bus", "installer", "intents", "ui" },
+                   [this, cfg]() {
+        registerDBusInterfaces(std::bind(&DefaultConfiguration::dbusRegistration, cfg, std::placeholders::_1),
+                               std::bind(&DefaultConfiguration::dbusPolicy, cfg, std::placeholders::_1));
+    });
+
+    graph.run();
 }
 
 bool Main::isSingleProcessMode() const
@@ -281,16 +391,20 @@ void Main::shutDown(int exitCode)
         }
     };
 
+    // the apps and the quick-launcher pool are stopped in parallel and share the same deadline
+    auto coordinator = new StopCoordinator(m_applicationManager ? m_applicationManager->stopGracePeriod() : 0, this);
+
     if (m_applicationManager) {
         connect(m_applicationManager, &ApplicationManager::shutDownFinished,
                 this, []() { checkShutDownFinished(ApplicationManagerDown); });
-        m_applicationManager->shutDown();
+        m_applicationManager->shutDown(coordinator);
     }
     if (m_quickLauncher) {
         connect(m_quickLauncher, &QuickLauncher::shutDownFinished,
                 this, []() { checkShutDownFinished(QuickLauncherDown); });
-        m_quickLauncher->shutDown();
+        m_quickLauncher->shutDown(coordinator);
     }
+    coordinator->start();
 #if !defined(AM_HEADLESS)
     if (m_windowManager) {
         connect(m_windowManager, &WindowManager::shutDownFinished,
@@ -332,11 +446,21 @@ void Main::parseSystemProperties(const QVariantMap &rawSystemProperties)
         iface->initialize(m_systemProperties.at(SP_SystemUi));
 }
 
+void Main::launchDBus(bool startSessionBus) Q_DECL_NOEXCEPT_EXPR(false)
+{
+#if defined(QT_DBUS_LIB) && !defined(AM_DISABLE_EXTERNAL_DBUS_INTERFACES)
+    if (Q_LIKELY(startSessionBus))
+        DBusDaemonProcess::launch();
+#else
+    Q_UNUSED(startSessionBus)
+#endif
+}
+
 void Main::setupDBus(bool startSessionBus) Q_DECL_NOEXCEPT_EXPR(false)
 {
 #if defined(QT_DBUS_LIB) && !defined(AM_DISABLE_EXTERNAL_DBUS_INTERFACES)
     if (Q_LIKELY(startSessionBus)) {
-        DBusDaemonProcess::start();
+        DBusDaemonProcess::waitForAddress();
 
         StartupTimer::instance()->checkpoint("after starting session D-Bus");
     }
@@ -413,13 +537,14 @@ void Main::setupRuntimesAndContainers(const QVariantMap &runtimeConfigurations,
 void Main::setupInstallationLocations(const QVariantList &installationLocations)
 {
     m_installationLocations = InstallationLocation::parseInstallationLocations(installationLocations,
-                                                                               hardwareId());
+                                                                               m_hardwareId);
     if (m_installationLocations.isEmpty())
         qCWarning(LogDeployment) << "No installation locations defined in config file";
 }
 
-void Main::loadApplicationDatabase(const QString &databasePath, bool recreateDatabase,
-                                   const QString &singleApp) Q_DECL_NOEXCEPT_EXPR(false)
+void Main::loadApplicationDatabase(const QString &databasePath, bool recreateDatabase, bool manifestChecksums,
+                                   const QString &singleApp, const QVector<ApplicationDirectory> &appDirs,
+                                   const QMap<QString, QByteArray> &fingerprints) Q_DECL_NOEXCEPT_EXPR(false)
 {
     if (singleApp.isEmpty()) {
         if (!QFile::exists(databasePath)) // make sure to create a database on the first run
@@ -431,11 +556,19 @@ void Main::loadApplicationDatabase(const QString &databasePath, bool recreateDat
                 throw Exception("could not create application database directory %1").arg(dbDir);
         }
         m_applicationDatabase.reset(new ApplicationDatabase(databasePath));
+
+        if (m_applicationDatabase->isOutdated()) {
+            qCDebug(LogSystem) << "The application database" << databasePath << "was created by an"
+                                  " incompatible version of the application-manager: recreating it.";
+            recreateDatabase = true;
+        }
     } else {
         m_applicationDatabase.reset(new ApplicationDatabase());
         recreateDatabase = true;
     }
 
+    m_manifestChecksums = manifestChecksums;
+
     if (Q_UNLIKELY(!m_applicationDatabase->isValid() && !recreateDatabase)) {
         throw Exception("database file %1 is not a valid application database: %2")
             .arg(m_applicationDatabase->name(), m_applicationDatabase->errorString());
@@ -447,9 +580,8 @@ void Main::loadApplicationDatabase(const QString &databasePath, bool recreateDat
         if (!singleApp.isEmpty()) {
             apps = scanForApplication(singleApp, m_builtinAppsManifestDirs);
         } else {
-            apps = scanForApplications(m_builtinAppsManifestDirs,
-                                       m_installedAppsManifestDir,
-                                       m_installationLocations);
+            apps = scanApplicationDirectories(appDirs, m_installationLocations);
+            m_applicationDatabase->setFingerprints(fingerprints);
         }
 
         if (LogSystem().isDebugEnabled()) {
@@ -465,11 +597,117 @@ void Main::loadApplicationDatabase(const QString &databasePath, bool recreateDat
 
         m_applicationDatabase->write(apps);
         qDeleteAll(apps);
+    } else {
+        updateApplicationDatabase(appDirs, fingerprints);
     }
 
     StartupTimer::instance()->checkpoint("after application database loading");
 }
 
+/*! \internal
+    Compares the \a fingerprints of all application directories \a appDirs to the ones stored in
+    the database and only rescans the directories that were added or changed, instead of
+    re-creating the complete database.
+*/
+void Main::updateApplicationDatabase(const QVector<ApplicationDirectory> &appDirs,
+                                     const QMap<QString, QByteArray> &fingerprints) Q_DECL_NOEXCEPT_EXPR(false)
+{
+    const auto dbFingerprints = m_applicationDatabase->fingerprints();
+
+    if (fingerprints == dbFingerprints)
+        return;
+
+    // a changed scan configuration invalidates all directories
+    const bool rescanAll = (fingerprints.value(QString()) != dbFingerprints.value(QString()));
+
+    // the directory name is the application id for both built-in and installed applications,
+    // so we can match the database content to the directories without deserializing it
+    auto appDirKey = [](AbstractApplicationInfo *app) {
+        bool builtIn = app->isAlias() || static_cast<ApplicationInfo *>(app)->isBuiltIn();
+        return qMakePair(app->id().section(qL1C('@'), 0, 0), builtIn);
+    };
+
+    QHash<QPair<QString, bool>, QVector<AbstractApplicationInfo *>> dbAppsByDir;
+    if (!rescanAll) {
+        const auto dbApps = m_applicationDatabase->readInfos();
+        for (AbstractApplicationInfo *app : dbApps)
+            dbAppsByDir[appDirKey(app)].append(app);
+    }
+
+    QVector<ApplicationDirectory> changedAppDirs;
+    for (const ApplicationDirectory &appDir : appDirs) {
+        if (rescanAll || (fingerprints.value(appDir.path) != dbFingerprints.value(appDir.path)))
+            changedAppDirs.append(appDir);
+    }
+
+    QHash<QPair<QString, bool>, QVector<AbstractApplicationInfo *>> scannedAppsByDir;
+    QVector<AbstractApplicationInfo *> apps;
+
+    try {
+        const auto scannedApps = scanApplicationDirectories(changedAppDirs, m_installationLocations);
+        for (AbstractApplicationInfo *app : scannedApps)
+            scannedAppsByDir[appDirKey(app)].append(app);
+
+        for (const ApplicationDirectory &appDir : appDirs) {
+            const auto key = qMakePair(appDir.id, appDir.builtIn);
+            QVector<AbstractApplicationInfo *> dbApps = dbAppsByDir.take(key);
+
+            if (rescanAll || (fingerprints.value(appDir.path) != dbFingerprints.value(appDir.path))) {
+                qDeleteAll(dbApps);
+                apps += scannedAppsByDir.take(key);
+            } else {
+                apps += dbApps;
+            }
+        }
+    } catch (...) {
+        qDeleteAll(apps);
+        for (const auto &dbApps : qAsConst(dbAppsByDir))
+            qDeleteAll(dbApps);
+        for (const auto &scannedApps : qAsConst(scannedAppsByDir))
+            qDeleteAll(scannedApps);
+        throw;
+    }
+
+    // whatever is left belonged to application directories that do not exist anymore
+    for (const auto &dbApps : qAsConst(dbAppsByDir))
+        qDeleteAll(dbApps);
+    for (const auto &scannedApps : qAsConst(scannedAppsByDir))
+        qDeleteAll(scannedApps);
+
+    qCDebug(LogSystem) << "Updated the application database: rescanned" << changedAppDirs.size() << "of"
+                       << appDirs.size() << "application directories";
+
+    m_applicationDatabase->setFingerprints(fingerprints);
+    m_applicationDatabase->write(apps);
+    qDeleteAll(apps);
+}
+
+/*! \internal
+    The installer changes the installed application directories behind our back, so their
+    fingerprints have to be refreshed whenever the database is written at runtime. The built-in
+    ones are kept as-is: any change to those has not been picked up and needs a rescan.
+*/
+void Main::updateInstalledApplicationFingerprints()
+{
+    auto fingerprints = m_applicationDatabase->fingerprints();
+    if (fingerprints.isEmpty())
+        return; // the next start will rescan everything anyway
+
+    const QString installedPrefix = QDir(m_installedAppsManifestDir).absolutePath() + qL1C('/');
+    for (auto it = fingerprints.begin(); it != fingerprints.end(); ) {
+        if (!it.key().isEmpty() && it.key().startsWith(installedPrefix))
+            it = fingerprints.erase(it);
+        else
+            ++it;
+    }
+
+    const auto installedAppDirs = findApplicationDirectories(QStringList(), m_installedAppsManifestDir);
+    for (const ApplicationDirectory &appDir : installedAppDirs)
+        fingerprints.insert(appDir.path, applicationDirectoryFingerprint(appDir, m_manifestChecksums));
+
+    m_applicationDatabase->setFingerprints(fingerprints);
+}
+
 void Main::setupIntents(const QMap<QString, int> &timeouts) Q_DECL_NOEXCEPT_EXPR(false)
 {
     m_intentServer = IntentAMImplementation::createIntentServerAndClientInstance(timeouts);
@@ -537,8 +775,10 @@ void Main::setupApplicationManagerWithDatabase()
     connect(&m_applicationManager->internalSignals, &ApplicationManagerInternalSignals::applicationsChanged,
             this, [this]() {
         try {
-            if (m_applicationDatabase)
+            if (m_applicationDatabase) {
+                updateInstalledApplicationFingerprints();
                 m_applicationDatabase->write(m_applicationManager->applications());
+            }
         } catch (const Exception &e) {
             qCCritical(LogInstaller) << "Failed to write the application database to disk:" << e.errorString();
             m_applicationDatabase->invalidate(); // make sure that the next AM start will rebuild the DB
@@ -546,7 +786,23 @@ void Main::setupApplicationManagerWithDatabase()
     });
 }
 
-void Main::setupInstaller(const QString &appImageMountDir, const QStringList &caCertificatePaths,
+QList<QByteArray> Main::loadCACertificates(const QStringList &caCertificatePaths) Q_DECL_NOEXCEPT_EXPR(false)
+{
+    QList<QByteArray> caCertificateList;
+
+    for (const auto &caFile : caCertificatePaths) {
+        QFile f(caFile);
+        if (Q_UNLIKELY(!f.open(QFile::ReadOnly)))
+            throw Exception(f, "could not open CA-certificate file");
+        QByteArray cert = f.readAll();
+        if (Q_UNLIKELY(cert.isEmpty()))
+            throw Exception(f, "CA-certificate file is empty");
+        caCertificateList << cert;
+    }
+    return caCertificateList;
+}
+
+void Main::setupInstaller(const QString &appImageMountDir, const QList<QByteArray> &caCertificates,
                           const std::function<bool(uint *, uint *, uint *)> &userIdSeparation) Q_DECL_NOEXCEPT_EXPR(false)
 {
 #if !defined(AM_DISABLE_INSTALLER)
@@ -556,7 +812,7 @@ void Main::setupInstaller(const QString &appImageMountDir, const QStringList &ca
                                     "even automatically switching to C.UTF-8 or en_US.UTF-8 failed.";
     }
 
-    if (Q_UNLIKELY(hardwareId().isEmpty()))
+    if (Q_UNLIKELY(m_hardwareId.isEmpty()))
         throw Exception("the installer is enabled, but the device-id is empty");
 
     if (Q_UNLIKELY(!QDir::root().mkpath(m_installedAppsManifestDir)))
@@ -571,7 +827,7 @@ void Main::setupInstaller(const QString &appImageMountDir, const QStringList &ca
     m_applicationInstaller = ApplicationInstaller::createInstance(m_installationLocations,
                                                                   m_installedAppsManifestDir,
                                                                   appImageMountDir,
-                                                                  hardwareId(),
+                                                                  m_hardwareId,
                                                                   &error);
     if (Q_UNLIKELY(!m_applicationInstaller))
         throw Exception(Error::System, error);
@@ -579,22 +835,10 @@ void Main::setupInstaller(const QString &appImageMountDir, const QStringList &ca
     if (m_developmentMode)
         m_applicationInstaller->setDevelopmentMode(true);
 
-    if (m_noSecurity) {
+    if (m_noSecurity)
         m_applicationInstaller->setAllowInstallationOfUnsignedPackages(true);
-    } else {
-        QList<QByteArray> caCertificateList;
-
-        for (const auto &caFile : caCertificatePaths) {
-            QFile f(caFile);
-            if (Q_UNLIKELY(!f.open(QFile::ReadOnly)))
-                throw Exception(f, "could not open CA-certificate file");
-            QByteArray cert = f.readAll();
-            if (Q_UNLIKELY(cert.isEmpty()))
-                throw Exception(f, "CA-certificate file is empty");
-            caCertificateList << cert;
-        }
-        m_applicationInstaller->setCACertificates(caCertificateList);
-    }
+    else
+        m_applicationInstaller->setCACertificates(caCertificates);
 
     uint minUserId, maxUserId, commonGroupId;
     if (userIdSeparation && userIdSeparation(&minUserId, &maxUserId, &commonGroupId)) {
@@ -606,6 +850,26 @@ void Main::setupInstaller(const QString &appImageMountDir, const QStringList &ca
 #  endif // Q_OS_LINUX
     }
 
+    QStringList precompileQmlRuntimeIds;
+    const QStringList runtimeIds = RuntimeFactory::instance()->runtimeIds();
+    for (const QString &runtimeId : runtimeIds) {
+        if (RuntimeFactory::instance()->manager(runtimeId)->configuration().value(qSL("precompileQml")).toBool())
+            precompileQmlRuntimeIds << runtimeId;
+    }
+    if (!precompileQmlRuntimeIds.isEmpty()) {
+        const QString qmlCacheGen = qSL("qmlcachegen");
+        QString qmlCacheGenPath = QStandardPaths::findExecutable(qmlCacheGen, { QLibraryInfo::location(QLibraryInfo::BinariesPath) });
+        if (qmlCacheGenPath.isEmpty())
+            qmlCacheGenPath = QStandardPaths::findExecutable(qmlCacheGen);
+
+        if (qmlCacheGenPath.isEmpty()) {
+            qCWarning(LogDeployment) << "QML pre-compilation at installation time was requested for the runtimes"
+                                     << precompileQmlRuntimeIds << "but the qmlcachegen tool could not be found.";
+        } else {
+            m_applicationInstaller->setQmlCacheGenerator(qmlCacheGenPath, precompileQmlRuntimeIds);
+        }
+    }
+
     //TODO: this could be delayed, but needs to have a lock on the app-db in this case
     m_applicationInstaller->cleanupBrokenInstallations();
 
@@ -634,6 +898,11 @@ void Main::setupQmlEngine(const QStringList &importPaths, const QString &quickCo
     qmlRegisterType<MonitorModel>("QtApplicationManager", 2, 0, "MonitorModel");
     qmlRegisterType<ProcessStatus>("QtApplicationManager.SystemUI", 2, 0, "ProcessStatus");
 
+    qmlRegisterSingletonType<LaunchStatistics>("QtApplicationManager.SystemUI", 2, 0, "LaunchStatistics",
+                                               &LaunchStatistics::instanceForQml);
+    qmlRegisterSingletonType<QuickLauncher>("QtApplicationManager.SystemUI", 2, 0, "QuickLauncher",
+                                            &QuickLauncher::instanceForQml);
+
     StartupTimer::instance()->checkpoint("after QML registrations");
 
     m_engine = new QQmlApplicationEngine(this);
@@ -1069,10 +1338,16 @@ QVector<AbstractApplicationInfo *> Main::scanForApplication(const QString &singl
 QVector<AbstractApplicationInfo *> Main::scanForApplications(const QStringList &builtinAppsDirs, const QString &installedAppsDir,
         const QVector<InstallationLocation> &installationLocations) Q_DECL_NOEXCEPT_EXPR(false)
 {
-    QVector<AbstractApplicationInfo *> result;
-    YamlApplicationScanner yas;
+    return scanApplicationDirectories(findApplicationDirectories(builtinAppsDirs, installedAppsDir),
+                                      installationLocations);
+}
+
+QVector<Main::ApplicationDirectory> Main::findApplicationDirectories(const QStringList &builtinAppsDirs,
+                                                                     const QString &installedAppsDir)
+{
+    QVector<ApplicationDirectory> result;
 
-    auto scan = [&result, &yas, &installationLocations](const QDir &baseDir, bool scanningBuiltinApps) {
+    auto find = [&result](const QDir &baseDir, bool scanningBuiltinApps) {
         auto flags = scanningBuiltinApps ? QDir::Dirs | QDir::NoDotAndDotDot
                                          : QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks;
         const QStringList appDirNames = baseDir.entryList(flags);
@@ -1086,84 +1361,192 @@ QVector<AbstractApplicationInfo *> Main::scanForApplications(const QStringList &
                                    << ": not a valid application-id:" << qPrintable(appIdError);
                 continue;
             }
-            QDir appDir = baseDir.absoluteFilePath(appDirName);
-            if (!appDir.exists())
-                continue;
-            if (!appDir.exists(qSL("info.yaml"))) {
-                qCDebug(LogSystem) << "Couldn't find a info.yaml in:" << appDir;
-                continue;
-            }
-            if (!scanningBuiltinApps && !appDir.exists(qSL("installation-report.yaml")))
-                continue;
+            result.append({ baseDir.absoluteFilePath(appDirName), appDirName, scanningBuiltinApps });
+        }
+    };
 
-            QScopedPointer<ApplicationInfo> a(yas.scan(appDir.absoluteFilePath(qSL("info.yaml"))));
-            Q_ASSERT(a);
+    for (const QString &dir : builtinAppsDirs)
+        find(dir, true);
+#if !defined(AM_DISABLE_INSTALLER)
+    if (!installedAppsDir.isEmpty())
+        find(installedAppsDir, false);
+#else
+    Q_UNUSED(installedAppsDir)
+#endif
+    return result;
+}
 
-            AbstractRuntimeManager *runtimeManager = RuntimeFactory::instance()->manager(a->runtimeName());
-            if (!runtimeManager) {
-                qCDebug(LogSystem) << "Ignoring application" << a->id() << ", because it uses an unknown runtime:" << a->runtimeName();
-                continue;
-            }
-            if (runtimeManager->supportsQuickLaunch()) {
-                if (a->supportsApplicationInterface())
-                    qCDebug(LogSystem) << "Ignoring supportsApplicationInterface for application" << a->id() <<
-                                          "as the runtime launcher supports it by default";
-                a->setSupportsApplicationInterface(true);
-            }
-            if (a->id() != appDirName) {
-                throw Exception(Error::Parse, "an info.yaml for built-in applications must be in a directory "
-                                              "that has the same name as the application's id: found %1 in %2")
-                    .arg(a->id(), appDirName);
-            }
-            if (scanningBuiltinApps) {
-                a->setBuiltIn(true);
-                QStringList aliasPaths = appDir.entryList(QStringList(qSL("info-*.yaml")));
-                std::vector<std::unique_ptr<AbstractApplicationInfo>> aliases;
+QVector<AbstractApplicationInfo *> Main::scanApplicationDirectories(const QVector<ApplicationDirectory> &appDirs,
+        const QVector<InstallationLocation> &installationLocations) Q_DECL_NOEXCEPT_EXPR(false)
+{
+    struct Scan
+    {
+        const ApplicationDirectory *appDir;
+        QVector<AbstractApplicationInfo *> infos;
+    };
+    QVector<Scan> scans;
+    scans.reserve(appDirs.size());
+    for (const ApplicationDirectory &appDir : appDirs)
+        scans.append({ &appDir, { } });
 
-                for (int i = 0; i < aliasPaths.size(); ++i) {
-                    std::unique_ptr<AbstractApplicationInfo> alias(yas.scanAlias(appDir.absoluteFilePath(aliasPaths.at(i)), a.data()));
+    const int uniqueNumberCounter = AbstractApplicationInfo::uniqueNumberCounter();
 
-                    Q_ASSERT(alias);
-                    Q_ASSERT(alias->isAlias());
+    // scans a single directory - defined as lambda to be usable both via QtConcurrent and
+    // via std:for_each
+    auto scan = [&installationLocations](Scan &s) {
+        s.infos = scanApplicationDirectory(*s.appDir, installationLocations);
+    };
 
-                    aliases.push_back(std::move(alias));
-                }
-                result << a.take();
-                for (auto &&alias : aliases)
-                    result << alias.release();
-            } else { // 3rd-party apps
-                QFile f(appDir.absoluteFilePath(qSL("installation-report.yaml")));
-                if (!f.open(QFile::ReadOnly))
-                    continue;
+    try {
+        if (scans.size() > ParallelScanThreshold)
+            QtConcurrent::blockingMap(scans, scan);
+        else
+            std::for_each(scans.begin(), scans.end(), scan);
+    } catch (...) {
+        for (const Scan &s : qAsConst(scans))
+            qDeleteAll(s.infos);
+        throw;
+    }
 
-                QScopedPointer<InstallationReport> report(new InstallationReport(a->id()));
-                if (!report->deserialize(&f))
-                    continue;
+    // merge in directory order, independent of the order the scans finished in
+    QVector<AbstractApplicationInfo *> result;
+    for (const Scan &s : qAsConst(scans))
+        result += s.infos;
 
-#if !defined(AM_DISABLE_INSTALLER)
-                // fix the basedir of the application
-                for (const InstallationLocation &il : installationLocations) {
-                    if (il.id() == report->installationLocationId()) {
-                        a->setCodeDir(il.installationPath() + a->id());
-                        break;
-                    }
-                }
-#endif
-                a->setInstallationReport(report.take());
-                result << a.take();
-            }
+    // the uniqueNumbers were handed out in random order by the worker threads
+    AbstractApplicationInfo::renumber(result, uniqueNumberCounter);
+    return result;
+}
+
+QVector<AbstractApplicationInfo *> Main::scanApplicationDirectory(const ApplicationDirectory &appDirectory,
+        const QVector<InstallationLocation> &installationLocations) Q_DECL_NOEXCEPT_EXPR(false)
+{
+    QVector<AbstractApplicationInfo *> result;
+    YamlApplicationScanner yas;
+    const QDir appDir(appDirectory.path);
+
+    if (!appDir.exists())
+        return result;
+    if (!appDir.exists(qSL("info.yaml"))) {
+        qCDebug(LogSystem) << "Couldn't find a info.yaml in:" << appDir;
+        return result;
+    }
+    if (!appDirectory.builtIn && !appDir.exists(qSL("installation-report.yaml")))
+        return result;
+
+    QScopedPointer<ApplicationInfo> a(yas.scan(appDir.absoluteFilePath(qSL("info.yaml"))));
+    Q_ASSERT(a);
+
+    AbstractRuntimeManager *runtimeManager = RuntimeFactory::instance()->manager(a->runtimeName());
+    if (!runtimeManager) {
+        qCDebug(LogSystem) << "Ignoring application" << a->id() << ", because it uses an unknown runtime:" << a->runtimeName();
+        return result;
+    }
+    if (runtimeManager->supportsQuickLaunch()) {
+        if (a->supportsApplicationInterface())
+            qCDebug(LogSystem) << "Ignoring supportsApplicationInterface for application" << a->id() <<
+                                  "as the runtime launcher supports it by default";
+        a->setSupportsApplicationInterface(true);
+    }
+    if (a->id() != appDirectory.id) {
+        throw Exception(Error::Parse, "an info.yaml for built-in applications must be in a directory "
+                                      "that has the same name as the application's id: found %1 in %2")
+            .arg(a->id(), appDirectory.id);
+    }
+    if (appDirectory.builtIn) {
+        a->setBuiltIn(true);
+        QStringList aliasPaths = appDir.entryList(QStringList(qSL("info-*.yaml")));
+        std::vector<std::unique_ptr<AbstractApplicationInfo>> aliases;
+
+        for (int i = 0; i < aliasPaths.size(); ++i) {
+            std::unique_ptr<AbstractApplicationInfo> alias(yas.scanAlias(appDir.absoluteFilePath(aliasPaths.at(i)), a.data()));
+
+            Q_ASSERT(alias);
+            Q_ASSERT(alias->isAlias());
+
+            aliases.push_back(std::move(alias));
         }
-    };
+        result << a.take();
+        for (auto &&alias : aliases)
+            result << alias.release();
+    } else { // 3rd-party apps
+        QFile f(appDir.absoluteFilePath(qSL("installation-report.yaml")));
+        if (!f.open(QFile::ReadOnly))
+            return result;
+
+        QScopedPointer<InstallationReport> report(new InstallationReport(a->id()));
+        if (!report->deserialize(&f))
+            return result;
 
-    for (const QString &dir : builtinAppsDirs)
-        scan(dir, true);
 #if !defined(AM_DISABLE_INSTALLER)
-    if (!installedAppsDir.isEmpty())
-        scan(installedAppsDir, false);
+        // fix the basedir of the application
+        for (const InstallationLocation &il : installationLocations) {
+            if (il.id() == report->installationLocationId()) {
+                a->setCodeDir(il.installationPath() + a->id());
+                break;
+            }
+        }
+#else
+        Q_UNUSED(installationLocations)
 #endif
+        a->setInstallationReport(report.take());
+        result << a.take();
+    }
     return result;
 }
 
+QByteArray Main::applicationDirectoryFingerprint(const ApplicationDirectory &appDirectory, bool withChecksums)
+{
+    // the inode, modification time and size of every file that is relevant to the scanner
+    QByteArray fingerprint;
+    QDataStream ds(&fingerprint, QIODevice::WriteOnly);
+    const QDir appDir(appDirectory.path);
+
+    static const QStringList nameFilters = { qSL("info.yaml"), qSL("info-*.yaml"), qSL("installation-report.yaml") };
+    const QStringList fileNames = appDir.entryList(nameFilters, QDir::Files, QDir::Name);
+
+    for (const QString &fileName : fileNames) {
+        const QString filePath = appDir.absoluteFilePath(fileName);
+        quint64 inode = 0;
+#if defined(Q_OS_UNIX)
+        struct stat statBuf;
+        if (::stat(QFile::encodeName(filePath).constData(), &statBuf) == 0)
+            inode = quint64(statBuf.st_ino);
+#endif
+        const QFileInfo fi(filePath);
+        ds << fileName << inode << fi.lastModified().toMSecsSinceEpoch() << fi.size();
+
+        if (withChecksums) {
+            QFile f(filePath);
+            QByteArray checksum;
+            if (f.open(QFile::ReadOnly))
+                checksum = QCryptographicHash::hash(f.readAll(), QCryptographicHash::Sha1);
+            ds << checksum;
+        }
+    }
+    return fingerprint;
+}
+
+QMap<QString, QByteArray> Main::applicationDirectoryFingerprints(const QVector<ApplicationDirectory> &appDirs,
+                                                                 bool withChecksums) const
+{
+    QMap<QString, QByteArray> fingerprints;
+
+    // the empty key covers everything that affects the scan result of all directories
+    QByteArray scanConfiguration;
+    QDataStream ds(&scanConfiguration, QIODevice::WriteOnly);
+    ds << m_builtinAppsManifestDirs << m_installedAppsManifestDir << withChecksums
+       << RuntimeFactory::instance()->runtimeIds();
+    for (const InstallationLocation &il : m_installationLocations)
+        ds << il.id() << il.installationPath();
+    fingerprints.insert(QString(), scanConfiguration);
+
+    for (const ApplicationDirectory &appDir : appDirs)
+        fingerprints.insert(appDir.path, applicationDirectoryFingerprint(appDir, withChecksums));
+
+    return fingerprints;
+}
+
 QString Main::hardwareId() const
 {
 #if defined(AM_HARDWARE_ID)
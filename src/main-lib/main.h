@@ -62,6 +62,7 @@ typedef QGuiApplication MainBase;
 #include <QtAppManInstaller/installationlocation.h>
 #include <QtAppManSharedMain/sharedmain.h>
 #include <QVector>
+#include <QMap>
 
 QT_FORWARD_DECLARE_CLASS(QQmlApplicationEngine)
 QT_FORWARD_DECLARE_CLASS(QQuickView)
@@ -107,6 +108,7 @@ public:
 protected:
     void loadStartupPlugins(const QStringList &startupPluginPaths) Q_DECL_NOEXCEPT_EXPR(false);
     void parseSystemProperties(const QVariantMap &rawSystemProperties);
+    void launchDBus(bool startSessionBus) Q_DECL_NOEXCEPT_EXPR(false);
     void setupDBus(bool startSessionBus) Q_DECL_NOEXCEPT_EXPR(false);
     void registerDBusInterfaces(const std::function<QString(const char *)> &busForInterface,
                                 const std::function<QVariantMap(const char *)> &policyForInterface);
@@ -116,13 +118,25 @@ protected:
                                     const QVariantMap &containerConfigurations, const QStringList &containerPluginPaths,
                                     const QStringList &iconThemeSearchPaths, const QString &iconThemeName);
     void setupInstallationLocations(const QVariantList &installationLocations);
-    void loadApplicationDatabase(const QString &databasePath, bool recreateDatabase,
-                                 const QString &singleApp) Q_DECL_NOEXCEPT_EXPR(false);
+
+    struct ApplicationDirectory
+    {
+        QString path; // absolute
+        QString id;   // the directory name, which has to match the application's id
+        bool builtIn;
+    };
+    void loadApplicationDatabase(const QString &databasePath, bool recreateDatabase, bool manifestChecksums,
+                                 const QString &singleApp, const QVector<ApplicationDirectory> &appDirs,
+                                 const QMap<QString, QByteArray> &fingerprints) Q_DECL_NOEXCEPT_EXPR(false);
+    void updateApplicationDatabase(const QVector<ApplicationDirectory> &appDirs,
+                                   const QMap<QString, QByteArray> &fingerprints) Q_DECL_NOEXCEPT_EXPR(false);
+    void updateInstalledApplicationFingerprints();
     void setupIntents(const QMap<QString, int> &timeouts) Q_DECL_NOEXCEPT_EXPR(false);
     void setupSingletons(const QList<QPair<QString, QString>> &containerSelectionConfiguration,
                          int quickLaunchRuntimesPerContainer, qreal quickLaunchIdleLoad,
                          const QString &singleApp) Q_DECL_NOEXCEPT_EXPR(false);
-    void setupInstaller(const QString &appImageMountDir, const QStringList &caCertificatePaths,
+    static QList<QByteArray> loadCACertificates(const QStringList &caCertificatePaths) Q_DECL_NOEXCEPT_EXPR(false);
+    void setupInstaller(const QString &appImageMountDir, const QList<QByteArray> &caCertificates,
                         const std::function<bool(uint *, uint *, uint *)> &userIdSeparation) Q_DECL_NOEXCEPT_EXPR(false);
 
     void setupQmlEngine(const QStringList &importPaths, const QString &quickControlsStyle = QString());
@@ -153,6 +167,16 @@ private:
             const QString &installedAppsDir,
             const QVector<InstallationLocation> &installationLocations) Q_DECL_NOEXCEPT_EXPR(false);
 
+    static QVector<ApplicationDirectory> findApplicationDirectories(const QStringList &builtinAppsDirs,
+                                                                    const QString &installedAppsDir);
+    static QVector<AbstractApplicationInfo *> scanApplicationDirectories(const QVector<ApplicationDirectory> &appDirs,
+            const QVector<InstallationLocation> &installationLocations) Q_DECL_NOEXCEPT_EXPR(false);
+    static QVector<AbstractApplicationInfo *> scanApplicationDirectory(const ApplicationDirectory &appDirectory,
+            const QVector<InstallationLocation> &installationLocations) Q_DECL_NOEXCEPT_EXPR(false);
+    static QByteArray applicationDirectoryFingerprint(const ApplicationDirectory &appDirectory, bool withChecksums);
+    QMap<QString, QByteArray> applicationDirectoryFingerprints(const QVector<ApplicationDirectory> &appDirs,
+                                                               bool withChecksums) const;
+
     void setupApplicationManagerWithDatabase();
 
 private:
@@ -179,6 +203,8 @@ private:
     bool m_developmentMode = false;
     QStringList m_builtinAppsManifestDirs;
     QString m_installedAppsManifestDir;
+    bool m_manifestChecksums = false;
+    QString m_hardwareId;
 };
 
 QT_END_NAMESPACE_AM
@@ -0,0 +1,181 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <exception>
+
+#include "global.h"
+#include "logging.h"
+#include "exception.h"
+#include "startupgraph.h"
+#include "startuptimer.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+void StartupGraph::addStage(const char *name, Affinity affinity, const QVector<const char *> &dependencies,
+                            const std::function<void()> &function) Q_DECL_NOEXCEPT_EXPR(false)
+{
+    Stage stage { name, affinity, { }, function, Stage::Pending };
+
+    for (const char *dependency : dependencies) {
+        auto it = std::find_if(m_stages.cbegin(), m_stages.cend(), [dependency](const Stage &s) {
+            return s.name == dependency;
+        });
+        if (it == m_stages.cend())
+            throw Exception("startup stage %1 depends on the unknown stage %2")
+                .arg(stage.name).arg(QByteArray(dependency));
+        stage.dependencies << int(it - m_stages.cbegin());
+    }
+    m_stages << stage;
+}
+
+void StartupGraph::run() Q_DECL_NOEXCEPT_EXPR(false)
+{
+    struct WorkerResult
+    {
+        int index;
+        std::exception_ptr error;
+    };
+
+    QMutex mutex;
+    QWaitCondition workerFinished;
+    QVector<WorkerResult> workerResults; // protected by mutex
+
+    int runningWorkers = 0;
+    int finishedStages = 0;
+    std::exception_ptr error;
+
+    auto isReady = [this](const Stage &stage) {
+        if (stage.state != Stage::Pending)
+            return false;
+        for (int dependency : stage.dependencies) {
+            if (m_stages.at(dependency).state != Stage::Finished)
+                return false;
+        }
+        return true;
+    };
+
+    while (!error && (finishedStages < m_stages.size())) {
+        QVector<WorkerResult> results;
+        {
+            QMutexLocker locker(&mutex);
+            results.swap(workerResults);
+        }
+        for (const WorkerResult &result : qAsConst(results)) {
+            m_stages[result.index].state = Stage::Finished;
+            --runningWorkers;
+            ++finishedStages;
+            if (result.error && !error)
+                error = result.error;
+        }
+        if (error || (finishedStages == m_stages.size()))
+            break;
+
+        // dispatch all worker stages that became ready
+        for (int i = 0; i < m_stages.size(); ++i) {
+            Stage &stage = m_stages[i];
+            if ((stage.affinity != WorkerThread) || !isReady(stage))
+                continue;
+
+            qCDebug(LogSystem) << "Starting startup stage" << stage.name << "in a worker thread";
+            stage.state = Stage::Running;
+            ++runningWorkers;
+
+            auto name = stage.name;
+            auto function = stage.function;
+            QtConcurrent::run([i, name, function, &mutex, &workerFinished, &workerResults]() {
+                std::exception_ptr error;
+                StartupTimer::instance()->beginSpan(name);
+                try {
+                    function();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                StartupTimer::instance()->endSpan(name);
+                QMutexLocker locker(&mutex);
+                workerResults.append({ i, error });
+                workerFinished.wakeOne();
+            });
+        }
+
+        // run the first main thread stage that is ready
+        auto it = std::find_if(m_stages.begin(), m_stages.end(), [&isReady](const Stage &stage) {
+            return (stage.affinity == MainThread) && isReady(stage);
+        });
+        if (it != m_stages.end()) {
+            it->state = Stage::Running;
+            StartupTimer::instance()->beginSpan(it->name);
+            try {
+                it->function();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            StartupTimer::instance()->endSpan(it->name);
+            if (error)
+                break;
+            it->state = Stage::Finished;
+            ++finishedStages;
+            continue;
+        }
+
+        // nothing to do on this thread: wait for a worker to finish
+        Q_ASSERT(runningWorkers > 0);
+        QMutexLocker locker(&mutex);
+        while (workerResults.isEmpty())
+            workerFinished.wait(&mutex);
+    }
+
+    // never leave stages running in the background, even if we failed
+    {
+        QMutexLocker locker(&mutex);
+        while (workerResults.size() < runningWorkers)
+            workerFinished.wait(&mutex);
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+QT_END_NAMESPACE_AM
@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+#include <QtAppManCommon/global.h>
+#include <functional>
+
+QT_BEGIN_NAMESPACE_AM
+
+// A minimal task graph for the System-UI startup: every stage declares the stages it depends on,
+// so stages that are independent of each other can run concurrently.
+// Stages with MainThread affinity (anything that creates QObjects, or touches the QML engine or
+// the GUI) are run on the thread calling run(): always the first one in declaration order that
+// has all its dependencies fulfilled. WorkerThread stages are dispatched to the global thread pool
+// as soon as their dependencies are finished.
+
+class StartupGraph
+{
+public:
+    enum Affinity {
+        MainThread,
+        WorkerThread
+    };
+
+    // dependencies have to be added before the stages that depend on them
+    void addStage(const char *name, Affinity affinity, const QVector<const char *> &dependencies,
+                  const std::function<void()> &function) Q_DECL_NOEXCEPT_EXPR(false);
+
+    // blocks until all stages are finished: the first exception thrown by any stage is re-thrown
+    // as soon as all stages that were running at this point are finished
+    void run() Q_DECL_NOEXCEPT_EXPR(false);
+
+private:
+    struct Stage
+    {
+        enum State { Pending, Running, Finished };
+
+        QByteArray name;
+        Affinity affinity;
+        QVector<int> dependencies;
+        std::function<void()> function;
+        State state;
+    };
+    QVector<Stage> m_stages;
+};
+
+QT_END_NAMESPACE_AM
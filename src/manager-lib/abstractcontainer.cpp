@@ -90,6 +90,12 @@ bool AbstractContainer::setControlGroup(const QString &groupName)
     return false;
 }
 
+bool AbstractContainer::setFrozen(bool frozen)
+{
+    Q_UNUSED(frozen)
+    return false;
+}
+
 bool AbstractContainer::setProgram(const QString &program)
 {
     if (!m_program.isEmpty())
@@ -109,6 +109,8 @@ public:
 
     virtual QString controlGroup() const;
     virtual bool setControlGroup(const QString &groupName);
+    // pauses (or resumes) all the processes of the container: returns false if not supported
+    virtual bool setFrozen(bool frozen);
 
     virtual bool setProgram(const QString &program);
     virtual void setBaseDirectory(const QString &baseDirectory);
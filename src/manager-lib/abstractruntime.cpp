@@ -150,6 +150,34 @@ bool AbstractRuntime::attachApplicationToQuickLauncher(Application *app)
     return false;
 }
 
+bool AbstractRuntime::preloadApplication(Application *app)
+{
+    Q_UNUSED(app)
+    return false;
+}
+
+bool AbstractRuntime::suspend()
+{
+    if (m_state == Am::Suspended)
+        return true;
+    if ((m_state != Am::Running) || !m_container || !m_container->setFrozen(true))
+        return false;
+
+    setState(Am::Suspended);
+    return true;
+}
+
+bool AbstractRuntime::resume()
+{
+    if (m_state != Am::Suspended)
+        return (m_state == Am::Running);
+    if (!m_container || !m_container->setFrozen(false))
+        return false;
+
+    setState(Am::Running);
+    return true;
+}
+
 Am::RunState AbstractRuntime::state() const
 {
     return m_state;
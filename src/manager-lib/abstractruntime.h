@@ -119,6 +119,8 @@ public:
     virtual bool needsLauncher() const;
     virtual bool isQuickLauncher() const;
     virtual bool attachApplicationToQuickLauncher(Application *app);
+    // hint for quick-launchers: app will most likely be attached next
+    virtual bool preloadApplication(Application *app);
 
     Am::RunState state() const;
 
@@ -139,10 +141,17 @@ public:
     virtual bool start() = 0;
     virtual void stop(bool forceKill = false) = 0;
 
+    // freezes a running application via its container and thaws it again
+    virtual bool suspend();
+    virtual bool resume();
+
 signals:
     void stateChanged(QT_PREPEND_NAMESPACE_AM(Am::RunState) newState);
     void finished(int exitCode, Am::ExitStatus status);
 
+    // emitted by quick-launchers as soon as they are ready to have an application attached
+    void readyForQuickLaunch();
+
 #if !defined(AM_HEADLESS)
     // these signals are for in-process mode runtimes only
     void inProcessSurfaceItemReady(QSharedPointer<InProcessSurfaceItem> window);
@@ -70,6 +70,7 @@ public:
         StartingUp,
         Running,
         ShuttingDown,
+        Suspended,
     };
     Q_ENUM(RunState)
 
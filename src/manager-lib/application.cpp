@@ -224,6 +224,7 @@
     \li Am.Running - the application is running.
     \li Am.ShuttingDown - the application has been stopped and is cleaning up (in multi-process mode
                           this state is only reached, if the application is terminating gracefully).
+    \li Am.Suspended - the application is running, but its processes have been frozen via suspend().
     \endlist
 */
 /*!
@@ -264,6 +265,22 @@
 
     \sa ApplicationManager::stopApplication
 */
+/*!
+    \qmlmethod ApplicationObject::suspend()
+
+    Suspends the running application: all of its processes are frozen, so that it does not use
+    any CPU time anymore, until resume() is called. This is only supported for applications running
+    in a \c process container on Linux.
+
+    \sa ApplicationManager::suspendApplication
+*/
+/*!
+    \qmlmethod ApplicationObject::resume()
+
+    Resumes the application, after it has been suspended.
+
+    \sa ApplicationManager::resumeApplication
+*/
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -383,6 +400,16 @@ void AbstractApplication::stop(bool forceKill)
     emit requests.stopRequested(forceKill);
 }
 
+void AbstractApplication::suspend()
+{
+    emit requests.suspendRequested();
+}
+
+void AbstractApplication::resume()
+{
+    emit requests.resumeRequested();
+}
+
 QVector<AbstractApplication *> AbstractApplication::fromApplicationInfoVector(
         QVector<AbstractApplicationInfo *> &appInfoVector)
 {
@@ -63,6 +63,8 @@ signals:
     void startRequested(const QString &documentUrl);
     void debugRequested(const QString &debugWrapper, const QString &documentUrl);
     void stopRequested(bool forceKill);
+    void suspendRequested();
+    void resumeRequested();
 };
 
 class AbstractApplication : public QObject
@@ -106,6 +108,8 @@ public:
     Q_INVOKABLE void start(const QString &documentUrl = QString());
     Q_INVOKABLE void debug(const QString &debugWrapper, const QString &documentUrl = QString());
     Q_INVOKABLE void stop(bool forceKill = false);
+    Q_INVOKABLE void suspend();
+    Q_INVOKABLE void resume();
 
     virtual Application *nonAliased() = 0;
 
@@ -203,6 +207,7 @@ public:
     void setBaseInfo(ApplicationInfo*);
     void setUpdatedInfo(ApplicationInfo*);
     ApplicationInfo *updatedInfo() const { return m_updatedInfo.data(); }
+    ApplicationInfo *baseInfo() const { return static_cast<ApplicationInfo *>(m_info.data()); }
     ApplicationInfo *takeBaseInfo();
 
     void setState(State);
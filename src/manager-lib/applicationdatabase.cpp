@@ -42,16 +42,120 @@
 
 #include <QFile>
 #include <QDataStream>
+#include <QSaveFile>
 #include <QTemporaryFile>
 #include <QScopedPointer>
+#include <QSharedPointer>
+#include <QHash>
 
 #include "application.h"
 #include "applicationdatabase.h"
 #include "exception.h"
 #include "logging.h"
 
+/*
+    The database file is a memory-mappable cache with the following layout (all integers are
+    stored in host byte order, since the file is never shared between devices):
+
+      DatabaseHeader
+      DatabaseRecord[recordCount]        fixed size records, one per AbstractApplicationInfo
+      QChar[stringPoolSize]              interned UTF-16 string pool (application ids)
+      char[dataSize]                     QDataStream serialized AbstractApplicationInfo objects
+      char[fingerprintsSize]             QDataStream serialized fingerprints (see setFingerprints())
+
+    Opening the database only needs to validate the header: the records are then turned into
+    "deferred" AbstractApplicationInfo objects, which only decode their serialized data on first
+    access.
+*/
+
 QT_BEGIN_NAMESPACE_AM
 
+namespace {
+
+const char databaseMagic[8] = { 'A', 'M', 'A', 'P', 'P', 'D', 'B', '\0' };
+const quint32 databaseVersion = 3;
+const quint32 byteOrderMark = 0x01020304;
+
+enum RecordFlag : quint32 {
+    RecordIsAlias   = 0x01,
+    RecordIsBuiltIn = 0x02,
+};
+
+struct DatabaseHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    qint32 dataStreamVersion;
+    quint32 recordCount;
+    quint32 stringPoolOffset; // in bytes, relative to the start of the file
+    quint32 stringPoolSize;   // in QChars
+    quint32 dataOffset;       // in bytes, relative to the start of the file
+    quint32 dataSize;         // in bytes
+    quint32 fingerprintsOffset; // in bytes, relative to the start of the file
+    quint32 fingerprintsSize;   // in bytes
+};
+
+struct DatabaseRecord
+{
+    quint32 idOffset;       // in QChars, relative to the string pool
+    quint32 idSize;         // in QChars
+    qint32 uniqueNumber;
+    quint32 flags;
+    quint32 dataOffset;     // in bytes, relative to DatabaseHeader::dataOffset
+    quint32 dataSize;       // in bytes
+};
+
+Q_STATIC_ASSERT(sizeof(DatabaseHeader) == 48);
+Q_STATIC_ASSERT(sizeof(DatabaseRecord) == 24);
+
+bool isCompatibleHeader(const DatabaseHeader &header)
+{
+    return (memcmp(header.magic, databaseMagic, sizeof(databaseMagic)) == 0)
+            && (header.version == databaseVersion)
+            && (header.byteOrderMark == byteOrderMark)
+            && (header.dataStreamVersion == QDataStream::Qt_DefaultCompiledVersion);
+}
+
+} // anonymous namespace
+
+// Keeps the file mapped for as long as there are deferred AbstractApplicationInfo objects
+// referencing its data.
+class MappedApplicationDatabase
+{
+public:
+    MappedApplicationDatabase(const QString &fileName)
+        : m_file(fileName)
+    { }
+
+    ~MappedApplicationDatabase()
+    {
+        if (m_mapped)
+            m_file.unmap(m_mapped);
+    }
+
+    bool open()
+    {
+        if (!m_file.open(QFile::ReadOnly))
+            return false;
+
+        m_mapped = m_file.size() > 0 ? m_file.map(0, m_file.size()) : nullptr;
+        if (m_mapped)
+            m_data = QByteArray::fromRawData(reinterpret_cast<const char *>(m_mapped), int(m_file.size()));
+        else
+            m_data = m_file.readAll(); // not all files can be mapped (e.g. on some special filesystems)
+        return true;
+    }
+
+    const QByteArray &data() const { return m_data; }
+    QString fileName() const { return m_file.fileName(); }
+
+private:
+    QFile m_file;
+    uchar *m_mapped = nullptr;
+    QByteArray m_data;
+};
+
 class ApplicationDatabasePrivate
 {
 public:
@@ -59,18 +163,173 @@ public:
     {
         if (!file || !file->isOpen() || !file->isWritable())
             throw Exception("application database %1 is not opened for writing").arg(file ? file->fileName() : qSL("<null>"));
-        if (!file->seek(0))
-            throw Exception(*file, "could not not seek to position 0 in the application database");
-        if (!file->resize(0))
-            throw Exception(*file, "could not truncate the application database");
+    }
+
+    const DatabaseHeader *validateHeader(const QByteArray &data) const
+    {
+        if (data.size() < int(sizeof(DatabaseHeader)))
+            return nullptr;
+
+        auto header = reinterpret_cast<const DatabaseHeader *>(data.constData());
+        if (!isCompatibleHeader(*header))
+            return nullptr;
+
+        quint64 recordsEnd = quint64(sizeof(DatabaseHeader)) + quint64(header->recordCount) * sizeof(DatabaseRecord);
+        quint64 stringPoolEnd = quint64(header->stringPoolOffset) + quint64(header->stringPoolSize) * sizeof(QChar);
+        quint64 dataEnd = quint64(header->dataOffset) + header->dataSize;
+        quint64 fingerprintsEnd = quint64(header->fingerprintsOffset) + header->fingerprintsSize;
+
+        if ((recordsEnd > header->stringPoolOffset) || (header->stringPoolOffset % sizeof(QChar))
+                || (stringPoolEnd > header->dataOffset) || (dataEnd > header->fingerprintsOffset)
+                || (fingerprintsEnd > quint64(data.size()))) {
+            return nullptr;
+        }
+        return header;
+    }
+
+    void serialize(const QVector<const AbstractApplicationInfo *> &infos, QByteArray &out)
+    {
+        QVector<DatabaseRecord> records;
+        records.reserve(infos.size());
+        QString stringPool;
+        QHash<QString, quint32> internedStrings;
+        QByteArray data;
+
+        auto intern = [&stringPool, &internedStrings](const QString &str) -> quint32 {
+            auto it = internedStrings.constFind(str);
+            if (it != internedStrings.cend())
+                return it.value();
+            quint32 offset = quint32(stringPool.size());
+            stringPool.append(str);
+            internedStrings.insert(str, offset);
+            return offset;
+        };
+
+        for (const AbstractApplicationInfo *info : infos) {
+            DatabaseRecord record;
+            record.idOffset = intern(info->id());
+            record.idSize = quint32(info->id().size());
+            record.uniqueNumber = info->uniqueNumber();
+            record.flags = info->isAlias() ? RecordIsAlias : 0;
+            if (!info->isAlias() && static_cast<const ApplicationInfo *>(info)->isBuiltIn())
+                record.flags |= RecordIsBuiltIn;
+            record.dataOffset = quint32(data.size());
+
+            // deferred objects can be written as-is, without having to load them first
+            if (auto deferredLoad = info->m_deferredLoad.loadAcquire()) {
+                data.append(deferredLoad->data);
+            } else {
+                QDataStream ds(&data, QIODevice::WriteOnly | QIODevice::Append);
+                info->writeToDataStream(ds);
+                if (ds.status() != QDataStream::Ok)
+                    throw Exception("could not serialize application %1").arg(info->id());
+            }
+            record.dataSize = quint32(data.size()) - record.dataOffset;
+            records.append(record);
+        }
+
+        QByteArray serializedFingerprints;
+        if (!fingerprints.isEmpty()) {
+            QDataStream ds(&serializedFingerprints, QIODevice::WriteOnly);
+            ds << fingerprints;
+        }
+
+        DatabaseHeader header;
+        memcpy(header.magic, databaseMagic, sizeof(databaseMagic));
+        header.version = databaseVersion;
+        header.byteOrderMark = byteOrderMark;
+        header.dataStreamVersion = QDataStream::Qt_DefaultCompiledVersion;
+        header.recordCount = quint32(records.size());
+        header.stringPoolOffset = quint32(sizeof(DatabaseHeader) + records.size() * sizeof(DatabaseRecord));
+        header.stringPoolSize = quint32(stringPool.size());
+        header.dataOffset = header.stringPoolOffset + header.stringPoolSize * sizeof(QChar);
+        header.dataSize = quint32(data.size());
+        header.fingerprintsOffset = header.dataOffset + header.dataSize;
+        header.fingerprintsSize = quint32(serializedFingerprints.size());
+
+        out.reserve(int(header.fingerprintsOffset + header.fingerprintsSize));
+        out.append(reinterpret_cast<const char *>(&header), int(sizeof(header)));
+        out.append(reinterpret_cast<const char *>(records.constData()), records.size() * int(sizeof(DatabaseRecord)));
+        out.append(reinterpret_cast<const char *>(stringPool.constData()), stringPool.size() * int(sizeof(QChar)));
+        out.append(data);
+        out.append(serializedFingerprints);
+    }
+
+    QMap<QString, QByteArray> readFingerprints()
+    {
+        QMap<QString, QByteArray> result;
+
+        if (!file || !file->isOpen() || !file->isReadable() || !file->seek(0))
+            return result;
+
+        QByteArray headerData = file->read(sizeof(DatabaseHeader));
+        if (headerData.size() != int(sizeof(DatabaseHeader)))
+            return result;
+        DatabaseHeader header;
+        memcpy(&header, headerData.constData(), sizeof(header));
+
+        if (!isCompatibleHeader(header) || !header.fingerprintsSize || !file->seek(header.fingerprintsOffset))
+            return result;
+
+        QByteArray serializedFingerprints = file->read(header.fingerprintsSize);
+        QDataStream ds(serializedFingerprints);
+        ds >> result;
+        if (ds.status() != QDataStream::Ok)
+            result.clear();
+        return result;
+    }
+
+    void write(const QVector<const AbstractApplicationInfo *> &infos)
+    {
+        // keep the fingerprints of the existing database, if none were set explicitly
+        if (!fingerprintsValid) {
+            fingerprints = readFingerprints();
+            fingerprintsValid = true;
+        }
+
+        validateWritableFile();
+
+        QByteArray out;
+        serialize(infos, out);
+
+        // Deferred objects (not only the ones in infos) might still reference the currently
+        // mapped data, so the file must never be modified in place. Instead, the new database
+        // replaces the old file atomically, while the old data stays valid for as long as it is
+        // mapped by a MappedApplicationDatabase.
+        const QString fileName = file->fileName();
+        QSaveFile saveFile(fileName);
+        if (!saveFile.open(QIODevice::WriteOnly) || (saveFile.write(out) != out.size()))
+            throw Exception("could not write to application database %1: %2").arg(fileName, saveFile.errorString());
+
+        // some platforms cannot rename over a file that is still open
+        file->close();
+        const bool committed = saveFile.commit();
+
+        // QTemporaryFile keeps its descriptor across close() and open(), which would still
+        // refer to the replaced file: access the new file via a plain QFile instead
+        if (file == temporaryFile)
+            file = new QFile(fileName);
+        const bool reopened = file->open(QFile::ReadWrite);
+
+        if (!committed)
+            throw Exception("could not replace application database %1: %2").arg(fileName, saveFile.errorString());
+        if (!reopened)
+            throw Exception(*file, "could not re-open the application database");
     }
 
     QFile *file = nullptr;
+    QTemporaryFile *temporaryFile = nullptr; // removes the (replaced) file on destruction
+    QMap<QString, QByteArray> fingerprints;
+    bool fingerprintsValid = false;
 
     ApplicationDatabasePrivate()
     { }
     ~ApplicationDatabasePrivate()
-    { delete file; }
+    {
+        if (file != temporaryFile)
+            delete file;
+        delete temporaryFile;
+    }
 };
 
 ApplicationDatabase::ApplicationDatabase(const QString &fileName)
@@ -83,8 +342,9 @@ ApplicationDatabase::ApplicationDatabase(const QString &fileName)
 ApplicationDatabase::ApplicationDatabase()
     : d(new ApplicationDatabasePrivate())
 {
-    d->file = new QTemporaryFile(qSL("am-apps-db"));
-    d->file->open(QFile::ReadWrite);
+    d->temporaryFile = new QTemporaryFile(qSL("am-apps-db"));
+    d->temporaryFile->open(QFile::ReadWrite);
+    d->file = d->temporaryFile;
 }
 
 ApplicationDatabase::~ApplicationDatabase()
@@ -99,7 +359,18 @@ bool ApplicationDatabase::isValid() const
 
 bool ApplicationDatabase::isTemporary() const
 {
-    return qobject_cast<QTemporaryFile *>(d->file);
+    return d->temporaryFile;
+}
+
+bool ApplicationDatabase::isOutdated() const
+{
+    if (!isValid() || (d->file->size() == 0))
+        return false;
+
+    DatabaseHeader header;
+    if (!d->file->seek(0) || (d->file->read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header)))
+        return true;
+    return !isCompatibleHeader(header);
 }
 
 QString ApplicationDatabase::errorString() const
@@ -112,61 +383,94 @@ QString ApplicationDatabase::name() const
     return d->file->fileName();
 }
 
+QMap<QString, QByteArray> ApplicationDatabase::fingerprints() const
+{
+    return d->fingerprintsValid ? d->fingerprints : d->readFingerprints();
+}
+
+void ApplicationDatabase::setFingerprints(const QMap<QString, QByteArray> &fingerprints)
+{
+    d->fingerprints = fingerprints;
+    d->fingerprintsValid = true;
+}
+
 QVector<AbstractApplication *> ApplicationDatabase::read() Q_DECL_NOEXCEPT_EXPR(false)
+{
+    QVector<AbstractApplicationInfo *> appInfoVector = readInfos();
+    return AbstractApplication::fromApplicationInfoVector(appInfoVector);
+}
+
+QVector<AbstractApplicationInfo *> ApplicationDatabase::readInfos() Q_DECL_NOEXCEPT_EXPR(false)
 {
     if (!d->file || !d->file->isOpen() || !d->file->isReadable())
         throw Exception("application database %1 is not opened for reading").arg(d->file ? d->file->fileName() : qSL("<null>"));
 
     QVector<AbstractApplicationInfo *> appInfoVector;
 
-    if (d->file->seek(0)) {
-        QDataStream ds(d->file);
-        forever {
-            QScopedPointer<AbstractApplicationInfo> appInfo(AbstractApplicationInfo::readFromDataStream(ds));
-
-            if (ds.status() != QDataStream::Ok) {
-                if (ds.status() != QDataStream::ReadPastEnd) {
-                    qDeleteAll(appInfoVector);
-                    throw Exception("could not read from application database %1").arg(d->file->fileName());
-                }
-                break;
+    if (d->file->size() > 0) {
+        QSharedPointer<MappedApplicationDatabase> mapped(new MappedApplicationDatabase(d->file->fileName()));
+        if (!mapped->open())
+            throw Exception("could not open application database %1 for reading").arg(d->file->fileName());
+
+        const QByteArray &fileData = mapped->data();
+        const DatabaseHeader *header = d->validateHeader(fileData);
+        if (!header)
+            throw Exception("could not read from application database %1: invalid format").arg(d->file->fileName());
+
+        auto records = reinterpret_cast<const DatabaseRecord *>(fileData.constData() + sizeof(DatabaseHeader));
+        auto stringPool = reinterpret_cast<const QChar *>(fileData.constData() + header->stringPoolOffset);
+        const char *data = fileData.constData() + header->dataOffset;
+
+        appInfoVector.reserve(int(header->recordCount));
+
+        for (quint32 i = 0; i < header->recordCount; ++i) {
+            const DatabaseRecord &record = records[i];
+
+            if ((quint64(record.idOffset) + record.idSize > header->stringPoolSize)
+                    || (quint64(record.dataOffset) + record.dataSize > header->dataSize)) {
+                qDeleteAll(appInfoVector);
+                throw Exception("could not read from application database %1: invalid record").arg(d->file->fileName());
             }
 
-            appInfoVector.append(appInfo.take());
+            appInfoVector.append(AbstractApplicationInfo::createDeferred(
+                                     record.flags & RecordIsAlias,
+                                     QString(stringPool + record.idOffset, int(record.idSize)),
+                                     record.uniqueNumber,
+                                     record.flags & RecordIsBuiltIn,
+                                     QByteArray::fromRawData(data + record.dataOffset, int(record.dataSize)),
+                                     mapped));
         }
     }
 
-    return AbstractApplication::fromApplicationInfoVector(appInfoVector);
+    return appInfoVector;
 }
 
 void ApplicationDatabase::write(const QVector<AbstractApplicationInfo *> &apps) Q_DECL_NOEXCEPT_EXPR(false)
 {
-    d->validateWritableFile();
-
-    QDataStream ds(d->file);
+    QVector<const AbstractApplicationInfo *> infos;
+    infos.reserve(apps.size());
     for (auto *app : apps)
-        app->writeToDataStream(ds);
+        infos << app;
 
-    if (ds.status() != QDataStream::Ok)
-        throw Exception(*d->file, "could not write to application database");
+    d->write(infos);
 }
 
 void ApplicationDatabase::write(const QVector<AbstractApplication *> &apps) Q_DECL_NOEXCEPT_EXPR(false)
 {
-    d->validateWritableFile();
-
-    QDataStream ds(d->file);
+    QVector<const AbstractApplicationInfo *> infos;
+    infos.reserve(apps.size());
     for (auto *app : apps) {
-        app->info()->writeToDataStream(ds);
         if (!app->isAlias()) {
             auto fullApp = static_cast<Application*>(app);
+            infos << fullApp->baseInfo();
             if (fullApp->updatedInfo())
-                fullApp->updatedInfo()->writeToDataStream(ds);
+                infos << fullApp->updatedInfo();
+        } else {
+            infos << app->info();
         }
     }
 
-    if (ds.status() != QDataStream::Ok)
-        throw Exception(*d->file, "could not write to application database");
+    d->write(infos);
 }
 
 void ApplicationDatabase::invalidate()
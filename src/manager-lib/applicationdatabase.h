@@ -44,12 +44,14 @@
 
 #include <QtAppManCommon/global.h>
 #include <QList>
+#include <QMap>
 #include <QString>
 
 QT_BEGIN_NAMESPACE_AM
 
 class Application;
 class AbstractApplication;
+class AbstractApplicationInfo;
 class ApplicationDatabasePrivate;
 
 class ApplicationDatabase
@@ -61,15 +63,22 @@ public:
 
     bool isValid() const;
     bool isTemporary() const;
+    bool isOutdated() const;
     QString errorString() const;
     QString name() const;
 
     QVector<AbstractApplication *> read() Q_DECL_NOEXCEPT_EXPR(false);
+    QVector<AbstractApplicationInfo *> readInfos() Q_DECL_NOEXCEPT_EXPR(false);
     void write(const QVector<AbstractApplication *> &apps) Q_DECL_NOEXCEPT_EXPR(false);
     void write(const QVector<AbstractApplicationInfo *> &apps) Q_DECL_NOEXCEPT_EXPR(false);
 
     void invalidate();
 
+    // Opaque per-directory fingerprints of the manifests the database was created from. They are
+    // written together with the applications and are kept across write() calls.
+    QMap<QString, QByteArray> fingerprints() const;
+    void setFingerprints(const QMap<QString, QByteArray> &fingerprints);
+
 private:
     ApplicationDatabasePrivate *d;
     Q_DISABLE_COPY(ApplicationDatabase)
@@ -46,7 +46,9 @@
 #include <QProcess>
 #include <QDir>
 #include <QMetaObject>
+#include <QSharedPointer>
 #include <QUuid>
+#include <QTimer>
 #include <QThread>
 #include <QMimeDatabase>
 #if defined(QT_GUI_LIB)
@@ -67,6 +69,9 @@
 #include "runtimefactory.h"
 #include "containerfactory.h"
 #include "quicklauncher.h"
+#include "launchstatistics.h"
+#include "applicationstartbatch.h"
+#include "stopcoordinator.h"
 #include "abstractruntime.h"
 #include "abstractcontainer.h"
 #include "qml-utilities.h"
@@ -74,6 +79,7 @@
 #include "qtyaml.h"
 #include "debugwrapper.h"
 #include "amnamespace.h"
+#include "startuptimer.h"
 
 /*!
     \qmltype ApplicationManager
@@ -122,6 +128,11 @@
         \li \c isShuttingDown
         \li bool
         \li A boolean value indicating whether the application is currently shutting down.
+    \row
+        \li \c isSuspended
+        \li bool
+        \li A boolean value indicating whether the application is currently suspended (see
+            ApplicationObject::suspend()). A suspended application is not reported as running.
     \row
         \li \c isBlocked
         \li bool
@@ -273,6 +284,28 @@
     See also Application::runState
 */
 
+/*!
+    \qmlsignal ApplicationManager::applicationsStarted(string batchId, var results)
+
+    This signal is emitted when all the applications of a batch started via startApplications
+    have either finished starting up or failed to do so. The batch is identified by \a batchId,
+    as returned by startApplications. The \a results map contains an entry for every requested
+    application id: a map with a boolean \c started field and an optional \c error string.
+
+    \sa startApplications
+*/
+
+/*!
+    \qmlsignal ApplicationManager::applicationsStopped(var results)
+
+    This signal is emitted when all the applications stopped via stopAllApplications are not
+    running anymore. The \a results map contains an entry for every application id: a map with
+    the \c stopTime in milliseconds and a boolean \c killed field, which is set if the application
+    did not stop within the grace period and had to be killed.
+
+    \sa stopAllApplications
+*/
+
 /*!
     \qmlsignal ApplicationManager::applicationAdded(string id)
 
@@ -327,6 +360,7 @@ enum Roles
     IsRunning,
     IsStartingUp,
     IsShuttingDown,
+    IsSuspended,
     IsBlocked,
     IsUpdating,
     IsRemovable,
@@ -356,6 +390,7 @@ ApplicationManagerPrivate::ApplicationManagerPrivate()
     roleNames.insert(IsRunning, "isRunning");
     roleNames.insert(IsStartingUp, "isStartingUp");
     roleNames.insert(IsShuttingDown, "isShuttingDown");
+    roleNames.insert(IsSuspended, "isSuspended");
     roleNames.insert(IsBlocked, "isBlocked");
     roleNames.insert(IsUpdating, "isUpdating");
     roleNames.insert(IsRemovable, "isRemovable");
@@ -376,6 +411,9 @@ ApplicationManagerPrivate::~ApplicationManagerPrivate()
     qDeleteAll(apps);
 }
 
+// upper bound for the number of indirect child processes that fromProcessId() remembers
+static const int MaxCachedProcessAncestries = 256;
+
 ApplicationManager *ApplicationManager::s_instance = nullptr;
 
 ApplicationManager *ApplicationManager::createInstance(bool singleProcess)
@@ -448,6 +486,16 @@ bool ApplicationManager::isShuttingDown() const
     return d->shuttingDown;
 }
 
+int ApplicationManager::stopGracePeriod() const
+{
+    return d->stopGracePeriod;
+}
+
+void ApplicationManager::setStopGracePeriod(int gracePeriod)
+{
+    d->stopGracePeriod = qMax(0, gracePeriod);
+}
+
 bool ApplicationManager::securityChecksEnabled() const
 {
     return d->securityChecksEnabled;
@@ -506,24 +554,62 @@ QVector<AbstractApplication *> ApplicationManager::applications() const
 
 AbstractApplication *ApplicationManager::fromId(const QString &id) const
 {
-    for (AbstractApplication *app : d->apps) {
-        if (app->id() == id)
-            return app;
-    }
-    return nullptr;
+    int row = d->rowById.value(id, -1);
+    return (row < 0) ? nullptr : d->apps.at(row);
 }
 
 AbstractApplication *ApplicationManager::fromProcessId(qint64 pid) const
 {
-    // pid could be an indirect child (e.g. when started via gdbserver)
     qint64 appmanPid = QCoreApplication::applicationPid();
+    if ((pid <= 1) || (pid == appmanPid))
+        return nullptr;
+    if (AbstractApplication *app = d->appByPid.value(pid))
+        return app;
+
+    // pid could be an indirect child (e.g. when started via gdbserver): walking up the process
+    // tree is expensive, so the result is cached until the next app process starts or exits.
+    // Only hits are cached, since a process could still be reparented or be a child of an app
+    // that has not been indexed yet. The start time makes sure that the pid was not reused.
+    const quint64 startTime = getProcessStartTime(pid);
+    auto it = d->appPidByDescendantPid.constFind(pid);
+    if (it != d->appPidByDescendantPid.cend()) {
+        if (it->startTime == startTime)
+            return d->appByPid.value(it->appPid);
+        d->appPidByDescendantPid.erase(it);
+    }
 
-    while ((pid > 1) && (pid != appmanPid)) {
-        for (AbstractApplication *app : d->apps) {
-            if (app->currentRuntime() && (app->currentRuntime()->applicationProcessId() == pid))
+    // The pid of an app is usually only known after it entered StartingUp, so it is missing from
+    // the index until the app is running: there are only a few starting apps, so just check
+    // their live pids directly.
+    QVector<AbstractApplication *> startingApps;
+    for (AbstractApplication *app : qAsConst(d->apps)) {
+        AbstractRuntime *rt = app->isAlias() ? nullptr : app->currentRuntime();
+        if (rt && (rt->state() == Am::StartingUp))
+            startingApps.append(app);
+    }
+    auto startingAppByPid = [&startingApps](qint64 processId) -> AbstractApplication * {
+        for (AbstractApplication *app : qAsConst(startingApps)) {
+            if (app->currentRuntime()->applicationProcessId() == processId)
                 return app;
         }
-        pid = getParentPid(pid);
+        return nullptr;
+    };
+
+    if (AbstractApplication *app = startingAppByPid(pid))
+        return app;
+
+    for (qint64 ppid = getParentPid(pid); (ppid > 1) && (ppid != appmanPid); ppid = getParentPid(ppid)) {
+        if (AbstractApplication *app = d->appByPid.value(ppid)) {
+            if (startTime) {
+                if (d->appPidByDescendantPid.size() >= MaxCachedProcessAncestries)
+                    d->appPidByDescendantPid.clear();
+                d->appPidByDescendantPid.insert(pid, { ppid, startTime });
+            }
+            return app;
+        }
+        // not cached, since the index is updated as soon as the app is running
+        if (AbstractApplication *app = startingAppByPid(ppid))
+            return app;
     }
     return nullptr;
 }
@@ -533,67 +619,96 @@ AbstractApplication *ApplicationManager::fromSecurityToken(const QByteArray &sec
     if (securityToken.size() != AbstractRuntime::SecurityTokenSize)
         return nullptr;
 
-    for (AbstractApplication *app : d->apps) {
-        if (app->currentRuntime() && app->currentRuntime()->securityToken() == securityToken)
-            return app;
-    }
-    return nullptr;
+    return d->appBySecurityToken.value(securityToken);
 }
 
 QVector<AbstractApplication *> ApplicationManager::schemeHandlers(const QString &scheme) const
 {
-    QVector<AbstractApplication *> handlers;
+    return d->appsByScheme.value(scheme);
+}
+
+QVector<AbstractApplication *> ApplicationManager::mimeTypeHandlers(const QString &mimeType) const
+{
+    return d->appsByMimeType.value(mimeType);
+}
+
+void ApplicationManager::updateRowIndex()
+{
+    d->rowById.clear();
+    d->rowById.reserve(d->apps.size());
+    for (int row = 0; row < d->apps.size(); ++row) {
+        const QString id = d->apps.at(row)->id();
+        if (!d->rowById.contains(id)) // the first one wins, like it did with a linear search
+            d->rowById.insert(id, row);
+    }
+}
 
-    for (AbstractApplication *app : d->apps) {
+void ApplicationManager::updateMimeTypeIndex()
+{
+    d->appsByMimeType.clear();
+    d->appsByScheme.clear();
+
+    for (AbstractApplication *app : qAsConst(d->apps)) {
         if (app->isAlias())
             continue;
 
         const auto mimeTypes = app->supportedMimeTypes();
         for (const QString &mime : mimeTypes) {
+            auto &mimeHandlers = d->appsByMimeType[mime];
+            if (mimeHandlers.isEmpty() || (mimeHandlers.constLast() != app))
+                mimeHandlers << app;
+
             int pos = mime.indexOf(QLatin1Char('/'));
 
-            if ((pos > 0)
-                    && (mime.left(pos) == qL1S("x-scheme-handler"))
-                    && (mime.mid(pos + 1) == scheme)) {
-                handlers << app;
+            if ((pos > 0) && (mime.leftRef(pos) == qL1S("x-scheme-handler"))) {
+                auto &schemeHandlers = d->appsByScheme[mime.mid(pos + 1)];
+                if (schemeHandlers.isEmpty() || (schemeHandlers.constLast() != app))
+                    schemeHandlers << app;
             }
         }
     }
-    return handlers;
 }
 
-QVector<AbstractApplication *> ApplicationManager::mimeTypeHandlers(const QString &mimeType) const
+void ApplicationManager::updateSecurityTokenIndex(AbstractApplication *app)
 {
-    QVector<AbstractApplication *> handlers;
+    // there is at most one entry per app and only running apps are in this index, so
+    // a reverse lookup is cheap
+    d->appBySecurityToken.remove(d->appBySecurityToken.key(app));
 
-    for (AbstractApplication *app : d->apps) {
-        if (app->isAlias())
-            continue;
+    if (app->currentRuntime())
+        d->appBySecurityToken.insert(app->currentRuntime()->securityToken(), app);
+}
 
-        if (app->supportedMimeTypes().contains(mimeType))
-            handlers << app;
-    }
-    return handlers;
+void ApplicationManager::updateProcessIdIndex(AbstractApplication *app)
+{
+    AbstractRuntime *rt = app->currentRuntime();
+    qint64 pid = (rt && (rt->state() != Am::NotRunning)) ? rt->applicationProcessId() : 0;
+    if (pid == QCoreApplication::applicationPid()) // in-process runtimes cannot be identified by pid
+        pid = 0;
+
+    qint64 oldPid = d->appByPid.key(app);
+    if (pid == oldPid)
+        return;
+
+    d->appByPid.remove(oldPid);
+    if (pid > 0)
+        d->appByPid.insert(pid, app);
+
+    // an exited app process invalidates all the cached descendants
+    d->appPidByDescendantPid.clear();
 }
 
 void ApplicationManager::registerMimeTypes()
 {
+    updateMimeTypeIndex();
+
 #if defined(QT_GUI_LIB)
     QSet<QString> schemes;
     schemes << qSL("file") << qSL("http") << qSL("https");
 
-    for (AbstractApplication *app : qAsConst(d->apps)) {
-        if (app->isAlias())
-            continue;
-
-        const auto mimeTypes = app->supportedMimeTypes();
-        for (const QString &mime : mimeTypes) {
-            int pos = mime.indexOf(QLatin1Char('/'));
+    for (auto it = d->appsByScheme.cbegin(); it != d->appsByScheme.cend(); ++it)
+        schemes << it.key();
 
-            if ((pos > 0) && (mime.left(pos) == qL1S("x-scheme-handler")))
-                schemes << mime.mid(pos + 1);
-        }
-    }
     QSet<QString> registerSchemes = schemes;
     registerSchemes.subtract(d->registeredMimeSchemes);
     QSet<QString> unregisterSchemes = d->registeredMimeSchemes;
@@ -608,6 +723,38 @@ void ApplicationManager::registerMimeTypes()
 #endif
 }
 
+QString ApplicationManager::containerIdForApplication(AbstractApplication *app) const Q_DECL_NOEXCEPT_EXPR(false)
+{
+    QString containerId;
+
+    if (d->containerSelectionConfig.isEmpty()) {
+        containerId = qSL("process");
+    } else {
+        // check config file
+        for (const auto &it : qAsConst(d->containerSelectionConfig)) {
+            const QString &key = it.first;
+            const QString &value = it.second;
+            bool hasAsterisk = key.contains(qL1C('*'));
+
+            if ((hasAsterisk && key.length() == 1)
+                    || (!hasAsterisk && key == app->id())
+                    || QRegExp(key, Qt::CaseSensitive, QRegExp::Wildcard).exactMatch(app->id())) {
+                containerId = value;
+                break;
+            }
+        }
+    }
+
+    if (d->containerSelectionFunction.isCallable()) {
+        QJSValueList args = { QJSValue(app->id()), QJSValue(containerId) };
+        containerId = d->containerSelectionFunction.call(args).toString();
+    }
+
+    if (!ContainerFactory::instance()->manager(containerId))
+        throw Exception("No ContainerManager found for container: %1").arg(containerId);
+    return containerId;
+}
+
 bool ApplicationManager::startApplicationInternal(AbstractApplication *app, const QString &documentUrl,
                                                   const QString &documentMimeType,
                                                   const QString &debugWrapperSpecification,
@@ -663,6 +810,11 @@ bool ApplicationManager::startApplicationInternal(AbstractApplication *app, cons
 
     if (runtime) {
         switch (runtime->state()) {
+        case Am::Suspended:
+            // starting a suspended application brings it back to the foreground
+            if (!runtime->resume())
+                return false;
+            Q_FALLTHROUGH();
         case Am::StartingUp:
         case Am::Running:
             if (!debugWrapperCommand.isEmpty()) {
@@ -686,36 +838,15 @@ bool ApplicationManager::startApplicationInternal(AbstractApplication *app, cons
         }
     }
 
+    LaunchStatistics *launchStatistics = LaunchStatistics::instance();
+    launchStatistics->beginLaunch(realApp->id());
+
     AbstractContainer *container = nullptr;
     QString containerId;
 
-    if (!inProcess) {
-        if (d->containerSelectionConfig.isEmpty()) {
-            containerId = qSL("process");
-        } else {
-            // check config file
-            for (const auto &it : qAsConst(d->containerSelectionConfig)) {
-                const QString &key = it.first;
-                const QString &value = it.second;
-                bool hasAsterisk = key.contains(qL1C('*'));
-
-                if ((hasAsterisk && key.length() == 1)
-                        || (!hasAsterisk && key == app->id())
-                        || QRegExp(key, Qt::CaseSensitive, QRegExp::Wildcard).exactMatch(app->id())) {
-                    containerId = value;
-                    break;
-                }
-            }
-        }
-
-        if (d->containerSelectionFunction.isCallable()) {
-            QJSValueList args = { QJSValue(app->id()), QJSValue(containerId) };
-            containerId = d->containerSelectionFunction.call(args).toString();
-        }
-
-        if (!ContainerFactory::instance()->manager(containerId))
-            throw Exception("No ContainerManager found for container: %1").arg(containerId);
-    }
+    if (!inProcess)
+        containerId = containerIdForApplication(app);
+    launchStatistics->mark(realApp->id(), LaunchStatistics::ContainerSelection);
     bool attachRuntime = false;
 
     if (!runtime) {
@@ -742,7 +873,7 @@ bool ApplicationManager::startApplicationInternal(AbstractApplication *app, cons
             } else {
                 // check quicklaunch pool
                 QPair<AbstractContainer *, AbstractRuntime *> quickLaunch =
-                        QuickLauncher::instance()->take(containerId, app->nonAliasedInfo()->runtimeName());
+                        QuickLauncher::instance()->take(containerId, app->nonAliasedInfo()->runtimeName(), realApp->id());
                 container = quickLaunch.first;
                 runtime = quickLaunch.second;
 
@@ -764,10 +895,13 @@ bool ApplicationManager::startApplicationInternal(AbstractApplication *app, cons
             }
             if (!container) {
                 qCCritical(LogSystem) << "ERROR: Couldn't create Container for Application (" << app->id() <<")!";
+                launchStatistics->abortLaunch(realApp->id());
                 return false;
             }
             if (runtime)
                 attachRuntime = true;
+            launchStatistics->setQuickLaunched(realApp->id(), attachRuntime);
+            launchStatistics->mark(realApp->id(), LaunchStatistics::ContainerCreation);
         }
         if (!runtime)
             runtime = RuntimeFactory::instance()->create(container, realApp);
@@ -778,6 +912,7 @@ bool ApplicationManager::startApplicationInternal(AbstractApplication *app, cons
 
     if (!runtime) {
         qCCritical(LogSystem) << "ERROR: Couldn't create Runtime for Application (" << app->id() <<")!";
+        launchStatistics->abortLaunch(realApp->id());
         return false;
     }
 
@@ -798,13 +933,34 @@ bool ApplicationManager::startApplicationInternal(AbstractApplication *app, cons
         }
 
         static_cast<Application*>(nonAliasedApp)->setRunState(newRuntimeState);
+        updateProcessIdIndex(nonAliasedApp);
+
+        // the app did not get to show its first frame
+        if (newRuntimeState == Am::NotRunning)
+            LaunchStatistics::instance()->abortLaunch(nonAliasedApp->id());
 
         for (AbstractApplication *app : qAsConst(apps)) {
             emit applicationRunStateChanged(app->id(), newRuntimeState);
-            emitDataChanged(app, QVector<int> { IsRunning, IsStartingUp, IsShuttingDown });
+            emitDataChanged(app, QVector<int> { IsRunning, IsStartingUp, IsShuttingDown, IsSuspended });
         }
     });
 
+    if (StartupTimer::instance()->isTracing()) {
+        // the span ends as soon as the application is up and running (or failed to start)
+        const QByteArray spanName = "starting " + app->id().toUtf8();
+        const quint64 spanId = quintptr(runtime);
+        StartupTimer::instance()->beginAsyncSpan(spanName, spanId);
+
+        auto connection = QSharedPointer<QMetaObject::Connection>::create();
+        *connection = connect(runtime, &AbstractRuntime::stateChanged, this,
+                              [spanName, spanId, connection](Am::RunState newRuntimeState) {
+            if ((newRuntimeState == Am::Running) || (newRuntimeState == Am::NotRunning)) {
+                StartupTimer::instance()->endAsyncSpan(spanName, spanId);
+                QObject::disconnect(*connection);
+            }
+        });
+    }
+
     if (!documentUrl.isNull())
         runtime->openDocument(documentUrl, documentMimeType);
     else if (!app->documentUrl().isNull())
@@ -819,7 +975,9 @@ bool ApplicationManager::startApplicationInternal(AbstractApplication *app, cons
 
     if (inProcess) {
         bool ok = runtime->start();
-        if (!ok)
+        if (ok)
+            launchStatistics->mark(realApp->id(), LaunchStatistics::RuntimeStart);
+        else
             runtime->deleteLater();
         return ok;
     } else {
@@ -830,7 +988,9 @@ bool ApplicationManager::startApplicationInternal(AbstractApplication *app, cons
         auto doStartInContainer = [realApp, attachRuntime, runtime]() -> bool {
             bool successfullyStarted = attachRuntime ? runtime->attachApplicationToQuickLauncher(realApp)
                                                      : runtime->start();
-            if (!successfullyStarted)
+            if (successfullyStarted)
+                LaunchStatistics::instance()->mark(realApp->id(), LaunchStatistics::RuntimeStart);
+            else
                 runtime->deleteLater(); // ~Runtime() will clean realApp->m_runtime
 
             return successfullyStarted;
@@ -899,6 +1059,77 @@ bool ApplicationManager::startApplication(const QString &id, const QString &docu
     }
 }
 
+/*!
+    \qmlmethod string ApplicationManager::startApplications(list applications, var options)
+
+    Starts all the given \a applications, but - in contrast to calling startApplication for each
+    of them - the application manager limits the number of applications that are starting up at
+    the same time. This avoids overloading the system when many applications are needed at once,
+    e.g. right after booting. An application counts as starting up until its run-state changes
+    to \c Am.Running.
+
+    Every entry in \a applications can either be an application id or a map with these fields:
+    \table
+    \header
+        \li Name
+        \li Type
+        \li Description
+    \row
+        \li \c id
+        \li string
+        \li The id of the application.
+    \row
+        \li \c documentUrl
+        \li string
+        \li An optional document, as in startApplication.
+    \row
+        \li \c priority
+        \li int
+        \li Applications with a higher priority are started first (default: \c 0). Applications
+            with the same priority are started in the order given.
+    \endtable
+
+    The optional \a options map supports these fields:
+    \table
+    \header
+        \li Name
+        \li Type
+        \li Description
+    \row
+        \li \c maximumConcurrentStarts
+        \li int
+        \li The maximum number of applications starting up at the same time (default: \c 2).
+    \row
+        \li \c idleLoad
+        \li real
+        \li If set to a value between 0 and 1, only one application at a time is started as long
+            as the system's CPU load is above this value (default: \c 0, which disables the check).
+    \row
+        \li \c startTimeout
+        \li int
+        \li The time in milliseconds after which an application that is still starting up does
+            not count against \c maximumConcurrentStarts anymore (default: \c 10000). \c 0 disables
+            the timeout.
+    \endtable
+
+    Returns a unique id for this batch. The applicationsStarted signal is emitted with the same id
+    and the per-application results, once all applications of the batch have been handled.
+
+    \sa startApplication, applicationsStarted
+*/
+QString ApplicationManager::startApplications(const QVariantList &applications, const QVariantMap &options)
+{
+    const QString batchId = QUuid::createUuid().toString();
+
+    auto batch = new ApplicationStartBatch(batchId, applications, options, this);
+    connect(batch, &ApplicationStartBatch::finished,
+            this, &ApplicationManager::applicationsStarted);
+
+    // the caller should get the batch id before any result is reported
+    QTimer::singleShot(0, batch, &ApplicationStartBatch::start);
+    return batchId;
+}
+
 /*!
     \qmlmethod bool ApplicationManager::debugApplication(string id, string debugWrapper, string document)
 
@@ -934,6 +1165,43 @@ void ApplicationManager::stopApplication(const QString &id, bool forceKill)
     return stopApplicationInternal(fromId(id), forceKill);
 }
 
+/*!
+    \qmlmethod bool ApplicationManager::suspendApplication(string id)
+
+    Suspends the running application identified by its \a id: all of its processes are frozen via
+    the cgroup freezer, so that the application does not use any CPU time anymore, while it stays
+    in memory. Its runState changes to \c Am.Suspended.
+
+    Returns \c true on success, or \c false if the application is not running or its container does
+    not support freezing (e.g. in single-process mode). See \l{Container Integration Configuration}
+    for the requirements of the \c process container.
+
+    \sa resumeApplication, ApplicationObject::suspend
+*/
+bool ApplicationManager::suspendApplication(const QString &id)
+{
+    AbstractApplication *app = fromId(id);
+    AbstractRuntime *rt = app ? app->currentRuntime() : nullptr;
+    return rt && rt->suspend();
+}
+
+/*!
+    \qmlmethod bool ApplicationManager::resumeApplication(string id)
+
+    Resumes the application identified by its \a id, after it has been suspended via
+    suspendApplication. Its runState changes back to \c Am.Running.
+
+    Returns \c true on success, or if the application was running already.
+
+    \sa suspendApplication, ApplicationObject::resume
+*/
+bool ApplicationManager::resumeApplication(const QString &id)
+{
+    AbstractApplication *app = fromId(id);
+    AbstractRuntime *rt = app ? app->currentRuntime() : nullptr;
+    return rt && rt->resume();
+}
+
 /*!
     \qmlmethod ApplicationManager::stopAllApplications(bool forceKill)
 
@@ -941,16 +1209,21 @@ void ApplicationManager::stopApplication(const QString &id, bool forceKill)
     parameter is runtime dependent, but in general you should always try to stop an application
     with \a forceKill set to \c false first in order to allow a clean shutdown.
     Use \a forceKill set to \c true only as a last resort to kill hanging applications.
+
+    All applications are asked to stop at the same time. Applications that are still running after
+    the grace period configured via \c applications/stopGracePeriod are killed. The
+    applicationsStopped signal reports how long each application took to stop.
 */
 void ApplicationManager::stopAllApplications(bool forceKill)
 {
+    auto coordinator = new StopCoordinator(d->stopGracePeriod, this);
     for (AbstractApplication *app : qAsConst(d->apps)) {
-        if (!app->isAlias()) {
-            AbstractRuntime *rt = app->currentRuntime();
-            if (rt)
-                rt->stop(forceKill);
-        }
+        if (!app->isAlias())
+            coordinator->addRuntime(app->currentRuntime(), app->id());
     }
+    connect(coordinator, &StopCoordinator::finished,
+            this, &ApplicationManager::applicationsStopped);
+    coordinator->start(forceKill);
 }
 
 /*!
@@ -1125,6 +1398,45 @@ void ApplicationManager::rejectOpenUrlRequest(const QString &requestId)
     }
 }
 
+/*!
+    \qmlmethod bool ApplicationManager::preloadApplication(string id)
+
+    Tells the application manager that the application identified by \a id will most likely be
+    started next. An idle quick-launcher for the application's runtime will then resolve the
+    application's import paths and compile its main QML file in the background, without
+    instantiating it. When the application is started afterwards, this quick-launcher is
+    preferred and only the instantiation cost remains.
+
+    Only runtimes that support quick-launching and that are started via a launcher (like the
+    \c qml runtime) act on this hint.
+
+    Returns \c true if a quick-launcher accepted the hint, or \c false otherwise.
+
+    \sa startApplication
+*/
+bool ApplicationManager::preloadApplication(const QString &id)
+{
+    AbstractApplication *app = fromId(id);
+    if (!app || app->isBlocked() || app->currentRuntime() || d->shuttingDown)
+        return false;
+
+    // the same restrictions as for using the quick-launch pool in startApplicationInternal apply
+    auto runtimeManager = RuntimeFactory::instance()->manager(app->runtimeName());
+    if (!runtimeManager || runtimeManager->inProcess() || !runtimeManager->supportsQuickLaunch())
+        return false;
+    if (!app->runtimeParameters().value(qSL("environmentVariables")).toMap().isEmpty()
+            || (app->nonAliasedInfo()->openGLConfiguration() != runtimeManager->systemOpenGLConfiguration())) {
+        return false;
+    }
+
+    try {
+        return QuickLauncher::instance()->preload(containerIdForApplication(app), app->nonAliased());
+    } catch (const Exception &e) {
+        qCWarning(LogSystem) << e.what();
+        return false;
+    }
+}
+
 /*!
     \qmlmethod list<string> ApplicationManager::capabilities(string id)
 
@@ -1205,6 +1517,7 @@ bool ApplicationManager::startingApplicationInstallation(ApplicationInfo *info)
         }
         app->setState(Application::BeingUpdated);
         app->setProgress(0);
+        updateMimeTypeIndex();
         emitDataChanged(app);
     } else { // installation
         Application *app = new Application(newInfo.take(), Application::BeingInstalled);
@@ -1214,6 +1527,7 @@ bool ApplicationManager::startingApplicationInstallation(ApplicationInfo *info)
         beginInsertRows(QModelIndex(), d->apps.count(), d->apps.count());
         addApplication(app);
         endInsertRows();
+        updateMimeTypeIndex();
 
         emitDataChanged(app);
 
@@ -1313,8 +1627,11 @@ bool ApplicationManager::finishedApplicationInstall(const QString &id)
             emit applicationAboutToBeRemoved(app->id());
             beginRemoveRows(QModelIndex(), row, row);
             d->apps.removeAt(row);
+            updateRowIndex();
             endRemoveRows();
         }
+        d->appBySecurityToken.remove(d->appBySecurityToken.key(app));
+        d->appByPid.remove(d->appByPid.key(app));
         delete app;
         registerMimeTypes();
         break;
@@ -1345,9 +1662,13 @@ bool ApplicationManager::canceledApplicationInstall(const QString &id)
             emit applicationAboutToBeRemoved(app->id());
             beginRemoveRows(QModelIndex(), row, row);
             d->apps.removeAt(row);
+            updateRowIndex();
             endRemoveRows();
         }
+        d->appBySecurityToken.remove(d->appBySecurityToken.key(app));
+        d->appByPid.remove(d->appByPid.key(app));
         delete app;
+        updateMimeTypeIndex();
         break;
     }
     case Application::BeingUpdated:
@@ -1386,7 +1707,7 @@ void ApplicationManager::startSingleAppAndQuitWhenStopped()
     }
 }
 
-void ApplicationManager::shutDown()
+void ApplicationManager::shutDown(StopCoordinator *coordinator)
 {
     d->shuttingDown = true;
     emit shuttingDownChanged();
@@ -1404,14 +1725,20 @@ void ApplicationManager::shutDown()
             emit shutDownFinished();
     };
 
+    const bool ownCoordinator = !coordinator;
+    if (ownCoordinator)
+        coordinator = new StopCoordinator(d->stopGracePeriod, this);
+
     for (AbstractApplication *app : qAsConst(d->apps)) {
         AbstractRuntime *rt = app->currentRuntime();
         if (rt) {
             connect(rt, &AbstractRuntime::destroyed,
                     this, shutdownHelper);
-            rt->stop();
+            coordinator->addRuntime(rt, app->nonAliased()->id());
         }
     }
+    if (ownCoordinator)
+        coordinator->start();
     shutdownHelper();
 }
 
@@ -1426,8 +1753,8 @@ void ApplicationManager::openUrlRelay(const QUrl &url)
 
 void ApplicationManager::emitDataChanged(AbstractApplication *app, const QVector<int> &roles)
 {
-    int row = d->apps.indexOf(app);
-    if (row >= 0) {
+    int row = d->rowById.value(app->id(), -1);
+    if ((row >= 0) && (d->apps.at(row) == app)) {
         emit dataChanged(index(row), index(row), roles);
 
         static const auto appChanged = QMetaMethod::fromSignal(&ApplicationManager::applicationChanged);
@@ -1489,6 +1816,8 @@ QVariant ApplicationManager::data(const QModelIndex &index, int role) const
         return app->currentRuntime() ? (app->currentRuntime()->state() == Am::StartingUp) : false;
     case IsShuttingDown:
         return app->currentRuntime() ? (app->currentRuntime()->state() == Am::ShuttingDown) : false;
+    case IsSuspended:
+        return app->currentRuntime() ? (app->currentRuntime()->state() == Am::Suspended) : false;
     case IsBlocked:
         return app->isBlocked();
     case IsUpdating:
@@ -1601,11 +1930,7 @@ AbstractApplication *ApplicationManager::application(const QString &id) const
 */
 int ApplicationManager::indexOfApplication(const QString &id) const
 {
-    for (int i = 0; i < d->apps.size(); ++i) {
-        if (d->apps.at(i)->id() == id)
-            return i;
-    }
-    return -1;
+    return d->rowById.value(id, -1);
 }
 
 /*!
@@ -1670,6 +1995,26 @@ void ApplicationManager::addApplication(AbstractApplication *app)
         stopApplication(app->id(), forceKill);
     });
 
+    connect (&app->requests, &ApplicationRequests::suspendRequested,
+            this, [this, app]() {
+        suspendApplication(app->id());
+    });
+
+    connect (&app->requests, &ApplicationRequests::resumeRequested,
+            this, [this, app]() {
+        resumeApplication(app->id());
+    });
+
+    // aliases share the runtime of their application, so only the latter is indexed
+    if (!app->isAlias()) {
+        connect(app, &AbstractApplication::runtimeChanged, this, [this, app]() {
+            updateSecurityTokenIndex(app);
+            updateProcessIdIndex(app);
+        });
+    }
+
+    if (!d->rowById.contains(app->id()))
+        d->rowById.insert(app->id(), d->apps.size());
     d->apps << app;
 }
 
@@ -58,6 +58,7 @@ QT_BEGIN_NAMESPACE_AM
 class ApplicationManagerPrivate;
 class AbstractRuntime;
 class IpcProxyObject;
+class StopCoordinator;
 
 // A place to collect signals used internally by appman without polluting
 // ApplicationManager's public QML API.
@@ -117,6 +118,10 @@ public:
                                   const QVector<int> &stdioRedirections = QVector<int>()) Q_DECL_NOEXCEPT_EXPR(false);
     void stopApplicationInternal(AbstractApplication *app, bool forceKill = false);
 
+    // runtimes still alive this many msec after being asked to stop are killed (0: never)
+    int stopGracePeriod() const;
+    void setStopGracePeriod(int gracePeriod);
+
     // only use these two functions for development!
     bool securityChecksEnabled() const;
     void setSecurityChecksEnabled(bool enabled);
@@ -143,13 +148,17 @@ public:
 
     Q_INVOKABLE void acknowledgeOpenUrlRequest(const QString &requestId, const QString &appId);
     Q_INVOKABLE void rejectOpenUrlRequest(const QString &requestId);
+    Q_INVOKABLE bool preloadApplication(const QString &id);
 
     // DBus interface
     Q_SCRIPTABLE QStringList applicationIds() const;
     Q_SCRIPTABLE QVariantMap get(const QString &id) const;
     Q_SCRIPTABLE bool startApplication(const QString &id, const QString &documentUrl = QString());
+    Q_SCRIPTABLE QString startApplications(const QVariantList &applications, const QVariantMap &options = QVariantMap());
     Q_SCRIPTABLE bool debugApplication(const QString &id, const QString &debugWrapper, const QString &documentUrl = QString());
     Q_SCRIPTABLE void stopApplication(const QString &id, bool forceKill = false);
+    Q_SCRIPTABLE bool suspendApplication(const QString &id);
+    Q_SCRIPTABLE bool resumeApplication(const QString &id);
     Q_SCRIPTABLE void stopAllApplications(bool forceKill = false);
     Q_SCRIPTABLE bool openUrl(const QString &url);
     Q_SCRIPTABLE QStringList capabilities(const QString &id) const;
@@ -161,7 +170,8 @@ public:
     void enableSingleAppMode();
 
 public slots:
-    void shutDown();
+    // If a coordinator is given, the runtimes are only added to it and the caller has to start it
+    void shutDown(QT_PREPEND_NAMESPACE_AM(StopCoordinator) *coordinator = nullptr);
 
 signals:
     Q_SCRIPTABLE void applicationRunStateChanged(const QString &id, QT_PREPEND_NAMESPACE_AM(Am::RunState) runState);
@@ -171,6 +181,8 @@ signals:
     Q_SCRIPTABLE void applicationAdded(const QString &id);
     Q_SCRIPTABLE void applicationAboutToBeRemoved(const QString &id);
     Q_SCRIPTABLE void applicationChanged(const QString &id, const QStringList &changedRoles);
+    Q_SCRIPTABLE void applicationsStarted(const QString &batchId, const QVariantMap &results);
+    Q_SCRIPTABLE void applicationsStopped(const QVariantMap &results);
 
     void openUrlRequested(const QString &requestId, const QString &url, const QString &mimeType, const QStringList &possibleAppIds);
 
@@ -207,6 +219,11 @@ private:
     void emitDataChanged(AbstractApplication *app, const QVector<int> &roles = QVector<int>());
     void emitActivated(AbstractApplication *app);
     void registerMimeTypes();
+    void updateRowIndex();
+    void updateMimeTypeIndex();
+    void updateSecurityTokenIndex(AbstractApplication *app);
+    void updateProcessIdIndex(AbstractApplication *app);
+    QString containerIdForApplication(AbstractApplication *app) const Q_DECL_NOEXCEPT_EXPR(false);
 
     ApplicationManager(bool singleProcess, QObject *parent = nullptr);
     ApplicationManager(const ApplicationManager &);
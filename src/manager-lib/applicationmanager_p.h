@@ -46,6 +46,7 @@
 #include <QVariantMap>
 #include <QJSValue>
 #include <QSet>
+#include <QHash>
 #include <QtAppManCommon/global.h>
 #include <QtAppManManager/applicationmanager.h>
 
@@ -57,11 +58,25 @@ public:
     bool securityChecksEnabled = true;
     bool singleProcess;
     bool shuttingDown = false;
+    int stopGracePeriod = 5000;
     bool windowManagerCompositorReady = false;
     QVariantMap systemProperties;
 
     QVector<AbstractApplication *> apps;
 
+    // lookup indices for apps, to avoid linear scans on every D-Bus call, notification or openUrl
+    QHash<QString, int> rowById;
+    QHash<QByteArray, AbstractApplication *> appBySecurityToken; // only running apps
+    QHash<qint64, AbstractApplication *> appByPid; // only running, out-of-process apps
+    struct ProcessAncestry
+    {
+        qint64 appPid;
+        quint64 startTime; // of the descendant, to detect pid reuse
+    };
+    QHash<qint64, ProcessAncestry> appPidByDescendantPid; // fromProcessId() cache: only hits
+    QHash<QString, QVector<AbstractApplication *>> appsByMimeType;
+    QHash<QString, QVector<AbstractApplication *>> appsByScheme;
+
     QString currentLocale;
     QHash<int, QByteArray> roleNames;
 
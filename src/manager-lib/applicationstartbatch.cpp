@@ -0,0 +1,221 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include <QTimerEvent>
+
+#include <algorithm>
+
+#include "logging.h"
+#include "exception.h"
+#include "applicationmanager.h"
+#include "application.h"
+#include "systemreader.h"
+#include "applicationstartbatch.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+ApplicationStartBatch::ApplicationStartBatch(const QString &batchId, const QVariantList &applications,
+                                             const QVariantMap &options, QObject *parent)
+    : QObject(parent)
+    , m_batchId(batchId)
+{
+    // every entry is either just an application id, or a map with id, documentUrl and priority
+    for (const QVariant &application : applications) {
+        Entry entry;
+        if (application.type() == QVariant::String) {
+            entry.m_id = application.toString();
+        } else {
+            const QVariantMap map = application.toMap();
+            entry.m_id = map.value(qSL("id")).toString();
+            entry.m_documentUrl = map.value(qSL("documentUrl")).toString();
+            entry.m_priority = map.value(qSL("priority"), 0).toInt();
+        }
+        m_queue.append(entry);
+    }
+    std::stable_sort(m_queue.begin(), m_queue.end(), [](const Entry &e1, const Entry &e2) {
+        return e1.m_priority > e2.m_priority;
+    });
+
+    m_maximumConcurrentStarts = qMax(1, options.value(qSL("maximumConcurrentStarts"), m_maximumConcurrentStarts).toInt());
+    m_startTimeout = qMax(0, options.value(qSL("startTimeout"), m_startTimeout).toInt());
+    m_idleThreshold = qBound(qreal(0), options.value(qSL("idleLoad"), 0).toReal(), qreal(1));
+    if (m_idleThreshold > 0)
+        m_idleCpu = new CpuReader();
+}
+
+ApplicationStartBatch::~ApplicationStartBatch()
+{
+    delete m_idleCpu;
+}
+
+QString ApplicationStartBatch::batchId() const
+{
+    return m_batchId;
+}
+
+void ApplicationStartBatch::start()
+{
+    connect(ApplicationManager::instance(), &ApplicationManager::applicationRunStateChanged,
+            this, &ApplicationStartBatch::onRunStateChanged);
+
+    if (m_idleCpu) {
+        m_idleCpu->readLoadValue(); // the first value is meaningless
+        m_isIdle = false;
+    }
+    // polls the CPU load and checks the start-up timeouts
+    m_pollTimerId = startTimer(250);
+
+    schedule();
+}
+
+void ApplicationStartBatch::timerEvent(QTimerEvent *te)
+{
+    if (!te || (te->timerId() != m_pollTimerId))
+        return;
+
+    if (m_idleCpu)
+        m_isIdle = (m_idleCpu->readLoadValue() <= m_idleThreshold);
+
+    if (m_startTimeout > 0) {
+        for (int i = m_inFlight.size() - 1; i >= 0; --i) {
+            if (m_inFlight.at(i).m_timer.hasExpired(m_startTimeout)) {
+                // the app is still starting up, but it should not block the rest of the batch
+                qCDebug(LogSystem) << "Batch start" << m_batchId << "- application" << m_inFlight.at(i).m_id
+                                   << "did not finish its start-up within" << m_startTimeout << "ms";
+                finishEntry(m_inFlight.at(i).m_id, true);
+            }
+        }
+    }
+    schedule();
+}
+
+void ApplicationStartBatch::schedule()
+{
+    // starting an app might synchronously change its run-state, which would call us recursively
+    if (m_scheduling)
+        return;
+    m_scheduling = true;
+
+    // as long as the system is not idle, we only start one application at a time
+    const bool busy = m_idleCpu && !m_isIdle;
+    const int concurrency = busy ? 1 : m_maximumConcurrentStarts;
+
+    while (!m_queue.isEmpty() && (m_inFlight.size() < concurrency)) {
+        const Entry entry = m_queue.takeFirst();
+
+        if (m_results.contains(entry.m_id) || std::any_of(m_inFlight.cbegin(), m_inFlight.cend(),
+                                                           [entry](const InFlight &f) { return f.m_id == entry.m_id; })) {
+            continue; // duplicate entry
+        }
+
+        ApplicationManager *am = ApplicationManager::instance();
+        AbstractApplication *app = am->fromId(entry.m_id);
+        if (!app) {
+            m_results.insert(entry.m_id, QVariantMap { { qSL("started"), false },
+                                                       { qSL("error"), qSL("unknown application") } });
+            continue;
+        }
+
+        InFlight inFlight;
+        inFlight.m_id = entry.m_id;
+        inFlight.m_nonAliasedId = app->nonAliased()->id();
+        inFlight.m_timer.start();
+        m_inFlight.append(inFlight);
+
+        try {
+            if (!am->startApplicationInternal(app, entry.m_documentUrl))
+                throw Exception("could not start application %1").arg(entry.m_id);
+
+            // already running apps will not report any run-state change
+            if (app->runState() == Am::Running)
+                finishEntry(entry.m_id, true);
+        } catch (const Exception &e) {
+            finishEntry(entry.m_id, false, e.errorString());
+        }
+    }
+    m_scheduling = false;
+
+    if (m_queue.isEmpty() && m_inFlight.isEmpty()) {
+        if (m_pollTimerId) {
+            killTimer(m_pollTimerId);
+            m_pollTimerId = 0;
+        }
+        disconnect(ApplicationManager::instance(), nullptr, this, nullptr);
+
+        qCDebug(LogSystem) << "Batch start" << m_batchId << "finished:" << m_results;
+        emit finished(m_batchId, m_results);
+        deleteLater();
+    }
+}
+
+void ApplicationStartBatch::onRunStateChanged(const QString &id, Am::RunState runState)
+{
+    for (const InFlight &inFlight : qAsConst(m_inFlight)) {
+        if (inFlight.m_nonAliasedId != id)
+            continue;
+
+        if (runState == Am::Running)
+            finishEntry(inFlight.m_id, true);
+        else if (runState == Am::NotRunning)
+            finishEntry(inFlight.m_id, false, qSL("application stopped while starting up"));
+        else
+            continue;
+
+        schedule();
+        return;
+    }
+}
+
+void ApplicationStartBatch::finishEntry(const QString &id, bool started, const QString &error)
+{
+    auto it = std::find_if(m_inFlight.begin(), m_inFlight.end(), [id](const InFlight &f) { return f.m_id == id; });
+    if (it == m_inFlight.end())
+        return;
+    m_inFlight.erase(it);
+
+    QVariantMap result { { qSL("started"), started } };
+    if (!error.isEmpty())
+        result.insert(qSL("error"), error);
+    m_results.insert(id, result);
+}
+
+QT_END_NAMESPACE_AM
@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <QtAppManCommon/global.h>
+#include <QtAppManManager/amnamespace.h>
+
+QT_BEGIN_NAMESPACE_AM
+
+class CpuReader;
+
+// Starts a list of applications in priority order, while limiting the number of applications
+// that are starting up at the same time. Used by ApplicationManager::startApplications().
+class ApplicationStartBatch : public QObject
+{
+    Q_OBJECT
+
+public:
+    ApplicationStartBatch(const QString &batchId, const QVariantList &applications, const QVariantMap &options,
+                          QObject *parent = nullptr);
+    ~ApplicationStartBatch() override;
+
+    QString batchId() const;
+    void start();
+
+signals:
+    void finished(const QString &batchId, const QVariantMap &results);
+
+protected:
+    void timerEvent(QTimerEvent *te) override;
+
+private:
+    void schedule();
+    void onRunStateChanged(const QString &id, QT_PREPEND_NAMESPACE_AM(Am::RunState) runState);
+    void finishEntry(const QString &id, bool started, const QString &error = QString());
+
+    struct Entry
+    {
+        QString m_id;
+        QString m_documentUrl;
+        int m_priority = 0;
+    };
+
+    struct InFlight
+    {
+        QString m_id;
+        QString m_nonAliasedId; // the run-state is only reported for the real application
+        QElapsedTimer m_timer;
+    };
+
+    QString m_batchId;
+    QVector<Entry> m_queue; // sorted by descending priority
+    QVector<InFlight> m_inFlight;
+    QVariantMap m_results;
+
+    int m_maximumConcurrentStarts = 2;
+    int m_startTimeout = 10000;
+    qreal m_idleThreshold = 0;
+    CpuReader *m_idleCpu = nullptr;
+    bool m_isIdle = true;
+    int m_pollTimerId = 0;
+    bool m_scheduling = false;
+};
+
+QT_END_NAMESPACE_AM
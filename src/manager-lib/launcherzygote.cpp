@@ -0,0 +1,327 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QUuid>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "global.h"
+#include "logging.h"
+#include "zygoteprotocol.h"
+#include "launcherzygote.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+QHash<QString, LauncherZygote *> LauncherZygote::s_zygotes;
+
+LauncherZygote *LauncherZygote::start(const QString &program, const QStringList &preloadLibraries)
+{
+    // a zygote that failed to start is not retried (it is recorded as nullptr)
+    auto it = s_zygotes.constFind(program);
+    if (it != s_zygotes.cend())
+        return *it;
+
+    LauncherZygote *zygote = new LauncherZygote(program, qApp);
+    if (!zygote->startZygote(preloadLibraries)) {
+        delete zygote;
+        zygote = nullptr;
+    }
+    s_zygotes.insert(program, zygote);
+    return zygote;
+}
+
+LauncherZygote *LauncherZygote::readyForProgram(const QString &program)
+{
+    LauncherZygote *zygote = s_zygotes.value(program);
+    return (zygote && zygote->isReady()) ? zygote : nullptr;
+}
+
+LauncherZygote::LauncherZygote(const QString &program, QObject *parent)
+    : QObject(parent)
+    , m_program(program)
+{ }
+
+LauncherZygote::~LauncherZygote()
+{
+    // closing the connection makes the zygote exit, but the children are left alone
+    if (m_socket)
+        m_socket->disconnect(this);
+    if (m_process)
+        m_process->disconnect(this);
+    if (s_zygotes.value(m_program) == this)
+        s_zygotes.remove(m_program);
+}
+
+QString LauncherZygote::program() const
+{
+    return m_program;
+}
+
+bool LauncherZygote::isReady() const
+{
+    return m_socket && (m_socket->state() == QLocalSocket::ConnectedState);
+}
+
+bool LauncherZygote::startZygote(const QStringList &preloadLibraries)
+{
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+
+    const QString socketPath = qSL("/tmp/qtam-zygote-") + QUuid::createUuid().toString().mid(1, 36);
+    if (!m_server->listen(socketPath)) {
+        qCWarning(LogSystem) << "ERROR: could not create the zygote socket" << socketPath << ":"
+                             << m_server->errorString();
+        return false;
+    }
+    connect(m_server, &QLocalServer::newConnection, this, &LauncherZygote::onNewConnection);
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    // resolve all symbols upfront, instead of lazily in every single child
+    env.insert(qSL("LD_BIND_NOW"), qSL("1"));
+    if (!preloadLibraries.isEmpty())
+        env.insert(qSL("AM_ZYGOTE_PRELOAD"), preloadLibraries.join(qL1C(':')));
+
+    // the children inherit the stdio channels of the zygote
+    m_process = new QProcess(this);
+    m_process->setProcessChannelMode(QProcess::ForwardedChannels);
+    m_process->setInputChannelMode(QProcess::ForwardedInputChannel);
+    m_process->setProcessEnvironment(env);
+
+    connect(m_process, static_cast<void (QProcess::*)(QProcess::ProcessError)>(&QProcess::error),
+            this, &LauncherZygote::onZygoteFinished);
+    connect(m_process, static_cast<void (QProcess::*)(int,QProcess::ExitStatus)>(&QProcess::finished),
+            this, &LauncherZygote::onZygoteFinished);
+
+    qCDebug(LogSystem) << "Starting a zygote for" << m_program;
+    m_process->start(m_program, { qSL("--zygote"), m_server->fullServerName() });
+    return true;
+}
+
+void LauncherZygote::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        bool accept = !m_socket;
+#if defined(Q_OS_LINUX)
+        // only the zygote we started ourselves is allowed to connect
+        struct ucred ucred;
+        socklen_t ucredSize = sizeof(struct ucred);
+        accept = accept && (getsockopt(int(socket->socketDescriptor()), SOL_SOCKET, SO_PEERCRED, &ucred, &ucredSize) == 0)
+                && (ucred.pid == m_process->processId());
+#endif
+        if (!accept) {
+            qCWarning(LogSystem) << "Rejected an unexpected connection on the zygote socket for" << m_program;
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+
+        m_socket = socket;
+        connect(m_socket, &QLocalSocket::readyRead, this, &LauncherZygote::onReadyRead);
+        connect(m_socket, &QLocalSocket::disconnected, this, &LauncherZygote::onZygoteFinished);
+
+        qCDebug(LogSystem) << "The zygote for" << m_program << "is ready (pid:" << m_process->processId() << ")";
+    }
+    // we do not need any further connections
+    if (m_socket)
+        m_server->close();
+}
+
+ZygoteProcess *LauncherZygote::fork(const QStringList &arguments, const QProcessEnvironment &environment,
+                                    const QString &workingDirectory)
+{
+    if (!isReady())
+        return nullptr;
+
+    const quint32 requestId = ++m_lastRequestId;
+
+    QByteArray payload;
+    QDataStream ds(&payload, QIODevice::WriteOnly);
+    ds << qint32(ZygoteProtocol::Fork) << requestId << arguments << environment.toStringList()
+       << workingDirectory;
+    m_socket->write(ZygoteProtocol::frame(payload));
+
+    auto *process = new ZygoteProcess;
+    m_pendingForks.insert(requestId, process);
+    return process;
+}
+
+void LauncherZygote::onReadyRead()
+{
+    m_buffer.append(m_socket->readAll());
+
+    QByteArray payload;
+    while (ZygoteProtocol::takeFrame(m_buffer, payload)) {
+        QDataStream ds(payload);
+        qint32 type = 0;
+        ds >> type;
+
+        switch (type) {
+        case ZygoteProtocol::Forked: {
+            quint32 requestId;
+            qint64 pid;
+            ds >> requestId >> pid;
+
+            QPointer<ZygoteProcess> process = m_pendingForks.take(requestId);
+            if (pid > 0) {
+                if (process)
+                    m_children.insert(pid, process);
+                else // nobody is interested in this process anymore
+                    ::kill(pid_t(pid), SIGKILL);
+            }
+            if (process)
+                process->setForked(pid);
+            break;
+        }
+        case ZygoteProtocol::Finished: {
+            qint64 pid;
+            qint32 exitCode;
+            bool crashed;
+            ds >> pid >> exitCode >> crashed;
+
+            QPointer<ZygoteProcess> process = m_children.take(pid);
+            if (process)
+                process->setFinished(exitCode, crashed);
+            break;
+        }
+        default:
+            qCWarning(LogSystem) << "Received an unknown message from the zygote for" << m_program;
+            break;
+        }
+    }
+}
+
+void LauncherZygote::onZygoteFinished()
+{
+    if (m_socket) {
+        m_socket->disconnect(this);
+        m_socket->deleteLater();
+        m_socket = nullptr;
+    }
+    if (m_process)
+        m_process->disconnect(this);
+
+    qCWarning(LogSystem) << "The zygote for" << m_program << "is gone: new processes will be started directly";
+
+    // without the zygote there is no way to get notified when the children exit
+    for (const auto &process : qAsConst(m_pendingForks)) {
+        if (process)
+            process->setForked(-ECHILD);
+    }
+    for (auto it = m_children.cbegin(); it != m_children.cend(); ++it) {
+        ::kill(pid_t(it.key()), SIGKILL);
+        if (it.value())
+            it.value()->setFinished(SIGKILL, true);
+    }
+    m_pendingForks.clear();
+    m_children.clear();
+}
+
+
+ZygoteProcess::~ZygoteProcess()
+{ }
+
+qint64 ZygoteProcess::processId() const
+{
+    return m_pid;
+}
+
+Am::RunState ZygoteProcess::state() const
+{
+    return m_state;
+}
+
+void ZygoteProcess::kill()
+{
+    sendSignal(SIGKILL);
+}
+
+void ZygoteProcess::terminate()
+{
+    sendSignal(SIGTERM);
+}
+
+void ZygoteProcess::sendSignal(int sig)
+{
+    if (m_state == Am::NotRunning)
+        return;
+    if (m_pid > 0)
+        ::kill(pid_t(m_pid), sig);
+    else // the zygote has not forked yet
+        m_pendingSignal = sig;
+}
+
+void ZygoteProcess::setForked(qint64 pid)
+{
+    if (pid <= 0) {
+        qCWarning(LogSystem) << "ERROR: the zygote could not fork a new process:" << strerror(int(-pid));
+        m_state = Am::NotRunning;
+        emit errorOccured(Am::FailedToStart);
+        emit stateChanged(m_state);
+        return;
+    }
+
+    m_pid = pid;
+    m_state = Am::Running;
+    emit started();
+    emit stateChanged(m_state);
+
+    if (m_pendingSignal)
+        sendSignal(m_pendingSignal);
+}
+
+void ZygoteProcess::setFinished(int exitCode, bool crashed)
+{
+    m_state = Am::NotRunning;
+    emit stateChanged(m_state);
+    emit finished(exitCode, crashed ? Am::CrashExit : Am::NormalExit);
+}
+
+QT_END_NAMESPACE_AM
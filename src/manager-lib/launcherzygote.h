@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QProcessEnvironment>
+#include <QtAppManManager/abstractcontainer.h>
+#include <QtAppManManager/amnamespace.h>
+
+QT_FORWARD_DECLARE_CLASS(QLocalServer)
+QT_FORWARD_DECLARE_CLASS(QLocalSocket)
+QT_FORWARD_DECLARE_CLASS(QProcess)
+
+QT_BEGIN_NAMESPACE_AM
+
+class ZygoteProcess;
+
+// A pre-initialized runtime launcher (started with --zygote), that forks a new child for every
+// process that would otherwise be started via exec() of the same launcher executable.
+class LauncherZygote : public QObject
+{
+    Q_OBJECT
+
+public:
+    // starts a zygote for the given launcher executable, if there is none running yet
+    static LauncherZygote *start(const QString &program, const QStringList &preloadLibraries);
+    // returns the zygote for the given launcher executable, if it is ready to fork
+    static LauncherZygote *readyForProgram(const QString &program);
+
+    ~LauncherZygote() override;
+
+    QString program() const;
+    bool isReady() const;
+
+    ZygoteProcess *fork(const QStringList &arguments, const QProcessEnvironment &environment,
+                        const QString &workingDirectory);
+
+private:
+    LauncherZygote(const QString &program, QObject *parent = nullptr);
+    bool startZygote(const QStringList &preloadLibraries);
+    void onNewConnection();
+    void onReadyRead();
+    void onZygoteFinished();
+
+    QString m_program;
+    QLocalServer *m_server = nullptr;
+    QLocalSocket *m_socket = nullptr;
+    QProcess *m_process = nullptr;
+    QByteArray m_buffer;
+    quint32 m_lastRequestId = 0;
+    QHash<quint32, QPointer<ZygoteProcess>> m_pendingForks;
+    QHash<qint64, QPointer<ZygoteProcess>> m_children;
+
+    static QHash<QString, LauncherZygote *> s_zygotes;
+};
+
+class ZygoteProcess : public AbstractContainerProcess
+{
+    Q_OBJECT
+
+public:
+    ~ZygoteProcess() override;
+
+    qint64 processId() const override;
+    Am::RunState state() const override;
+
+public slots:
+    void kill() override;
+    void terminate() override;
+
+private:
+    ZygoteProcess() = default;
+    void setForked(qint64 pid);
+    void setFinished(int exitCode, bool crashed);
+    void sendSignal(int sig);
+
+    qint64 m_pid = 0;
+    Am::RunState m_state = Am::StartingUp;
+    int m_pendingSignal = 0;
+
+    friend class LauncherZygote;
+};
+
+QT_END_NAMESPACE_AM
@@ -0,0 +1,356 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include <algorithm>
+
+#include <QQmlEngine>
+
+#include "logging.h"
+#include "launchstatistics.h"
+
+/*!
+    \qmltype LaunchStatistics
+    \inqmlmodule QtApplicationManager.SystemUI
+    \ingroup system-ui-singletons
+    \brief Timing information about the phases of application launches.
+
+    The LaunchStatistics singleton records the time spent in each phase of every application
+    launch, starting with the call to ApplicationManager::startApplication and ending with the
+    first frame of the System UI that shows the application's first window. The following phases
+    are recorded, in milliseconds since the launch began:
+
+    \table
+    \header
+        \li Name
+        \li Description
+    \row
+        \li \c containerSelection
+        \li The container for the application has been selected.
+    \row
+        \li \c containerCreation
+        \li The container has either been created or taken from the quick-launch pool.
+    \row
+        \li \c runtimeStart
+        \li The runtime has been started or attached to a quick-launcher.
+    \row
+        \li \c processSpawn
+        \li The application's process is running (not for quick-launched applications).
+    \row
+        \li \c peerDBusConnection
+        \li The process connected to its peer D-Bus (not for quick-launched applications).
+    \row
+        \li \c startViaLauncher
+        \li The launcher has been told to start the application.
+    \row
+        \li \c surfaceMapped
+        \li The application's first window surface has been mapped.
+    \row
+        \li \c firstFrame
+        \li The System UI rendered its first frame after the surface has been mapped.
+    \endtable
+
+    The last 32 completed launches of each application are kept, in order to provide a rolling
+    histogram of the time to the first frame. The same data is also available via the
+    \c launchStatistics method of the ApplicationManager's D-Bus interface and the
+    \c show-launch-statistics command of \c appman-controller.
+*/
+
+/*!
+    \qmlsignal LaunchStatistics::launchFinished(string appId, var launch)
+
+    This signal is emitted, when the application identified by \a appId has rendered its first
+    frame after being started. The \a launch map has the same format as the one returned by
+    lastLaunch().
+*/
+
+QT_BEGIN_NAMESPACE_AM
+
+// how many completed launches per application are kept
+static const int HistorySize = 32;
+
+// the upper bounds (in msec) of the histogram buckets for the time to the first frame
+static const int HistogramBuckets[] = { 100, 250, 500, 1000, 2000, 5000, 10000 };
+
+static const char *PhaseNames[] = {
+    "containerSelection",
+    "containerCreation",
+    "runtimeStart",
+    "processSpawn",
+    "peerDBusConnection",
+    "startViaLauncher",
+    "surfaceMapped",
+    "firstFrame"
+};
+
+static QVariantMap durationStatistics(QVector<qint64> durations)
+{
+    std::sort(durations.begin(), durations.end());
+    auto percentile = [&durations](qreal p) {
+        return durations.at(qMin(durations.size() - 1, int(durations.size() * p)));
+    };
+
+    return QVariantMap {
+        { qSL("count"), durations.size() },
+        { qSL("min"), durations.constFirst() },
+        { qSL("median"), percentile(0.5) },
+        { qSL("p90"), percentile(0.9) },
+        { qSL("max"), durations.constLast() }
+    };
+}
+
+LaunchStatistics *LaunchStatistics::s_instance = nullptr;
+
+LaunchStatistics *LaunchStatistics::instance()
+{
+    if (!s_instance)
+        s_instance = new LaunchStatistics();
+    return s_instance;
+}
+
+QObject *LaunchStatistics::instanceForQml(QQmlEngine *, QJSEngine *)
+{
+    QQmlEngine::setObjectOwnership(instance(), QQmlEngine::CppOwnership);
+    return instance();
+}
+
+LaunchStatistics::LaunchStatistics(QObject *parent)
+    : QObject(parent)
+{
+    Q_STATIC_ASSERT(sizeof(PhaseNames) / sizeof(*PhaseNames) == PhaseCount);
+}
+
+LaunchStatistics::~LaunchStatistics()
+{
+    s_instance = nullptr;
+}
+
+void LaunchStatistics::beginLaunch(const QString &appId)
+{
+    // a previous launch that never got to show a frame is replaced
+    Launch &launch = m_active[appId];
+    launch.m_quickLaunched = false;
+    std::fill(launch.m_timestamps, launch.m_timestamps + PhaseCount, -1);
+    launch.m_timer.start();
+}
+
+void LaunchStatistics::setQuickLaunched(const QString &appId, bool quickLaunched)
+{
+    auto it = m_active.find(appId);
+    if (it != m_active.end())
+        it->m_quickLaunched = quickLaunched;
+}
+
+bool LaunchStatistics::isLaunching(const QString &appId) const
+{
+    return m_active.contains(appId);
+}
+
+void LaunchStatistics::mark(const QString &appId, Phase phase)
+{
+    auto it = m_active.find(appId);
+    if ((it == m_active.end()) || (phase < 0) || (phase >= PhaseCount))
+        return;
+
+    // only the first occurrence counts, e.g. for apps with multiple windows
+    if (it->m_timestamps[phase] >= 0)
+        return;
+    it->m_timestamps[phase] = it->m_timer.elapsed();
+
+    if (phase == FirstFrame) {
+        const Launch launch = *it;
+        m_active.erase(it);
+
+        QVector<Launch> &history = m_history[appId];
+        if (history.size() >= HistorySize)
+            history.removeFirst();
+        history.append(launch);
+
+        qCDebug(LogSystem).nospace() << "Application " << appId << " showed its first frame after "
+                                     << launch.m_timestamps[FirstFrame] << " msec"
+                                     << (launch.m_quickLaunched ? " (quick-launched)" : "");
+        emit launchFinished(appId, toVariantMap(launch));
+    }
+}
+
+void LaunchStatistics::abortLaunch(const QString &appId)
+{
+    m_active.remove(appId);
+}
+
+QVariantMap LaunchStatistics::toVariantMap(const Launch &launch)
+{
+    QVariantMap map;
+    map.insert(qSL("quickLaunched"), launch.m_quickLaunched);
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        if (launch.m_timestamps[phase] >= 0)
+            map.insert(qL1S(PhaseNames[phase]), launch.m_timestamps[phase]);
+    }
+    return map;
+}
+
+/*!
+    \qmlmethod list<string> LaunchStatistics::applicationIds()
+
+    Returns the ids of all applications that have at least one completed launch recorded.
+*/
+QStringList LaunchStatistics::applicationIds() const
+{
+    QStringList ids = m_history.keys();
+    ids.sort();
+    return ids;
+}
+
+/*!
+    \qmlmethod object LaunchStatistics::lastLaunch(string appId)
+
+    Returns the timestamps of the last completed launch of the application identified by \a appId.
+    The map contains the names of the reached phases as keys and the milliseconds since the
+    launch began as values. The \c quickLaunched field tells whether the application was started
+    in a quick-launcher. Returns an empty map, if no launch has been recorded for \a appId.
+*/
+QVariantMap LaunchStatistics::lastLaunch(const QString &appId) const
+{
+    const auto history = m_history.value(appId);
+    return history.isEmpty() ? QVariantMap() : toVariantMap(history.constLast());
+}
+
+/*!
+    \qmlmethod object LaunchStatistics::statistics(string appId)
+
+    Returns the statistics over the last completed launches of the application identified by
+    \a appId:
+
+    \table
+    \header
+        \li Name
+        \li Description
+    \row
+        \li \c launches
+        \li The number of launches these statistics are based on.
+    \row
+        \li \c quickLaunches
+        \li How many of these launches used a quick-launcher.
+    \row
+        \li \c lastLaunch
+        \li The same as lastLaunch().
+    \row
+        \li \c phases
+        \li A map from phase name to the \c count, \c min, \c median, \c p90 and \c max duration
+            of the phase in milliseconds. The duration of a phase is measured from the previous
+            phase that was reached.
+    \row
+        \li \c timeToFirstFrame
+        \li The same statistics for the complete launch.
+    \row
+        \li \c histogram
+        \li The time to the first frame as a histogram: \c bounds holds the upper bounds of the
+            buckets in milliseconds, while \c counts holds the number of launches in each bucket.
+            \c counts has one more entry than \c bounds for the launches that took longer.
+    \endtable
+*/
+QVariantMap LaunchStatistics::statistics(const QString &appId) const
+{
+    const auto history = m_history.value(appId);
+
+    QVariantMap result;
+    result.insert(qSL("launches"), history.size());
+    if (history.isEmpty())
+        return result;
+
+    int quickLaunches = 0;
+    QVector<qint64> durations[PhaseCount];
+    for (const Launch &launch : history) {
+        if (launch.m_quickLaunched)
+            ++quickLaunches;
+
+        qint64 previous = 0;
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            const qint64 timestamp = launch.m_timestamps[phase];
+            if (timestamp >= 0) {
+                durations[phase].append(timestamp - previous);
+                previous = timestamp;
+            }
+        }
+    }
+
+    QVariantMap phases;
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        if (!durations[phase].isEmpty())
+            phases.insert(qL1S(PhaseNames[phase]), durationStatistics(durations[phase]));
+    }
+
+    const int bucketCount = sizeof(HistogramBuckets) / sizeof(*HistogramBuckets);
+    QVariantList bounds;
+    QVariantList counts;
+    QVector<int> bucketCounts(bucketCount + 1);
+    QVector<qint64> timesToFirstFrame;
+    for (const Launch &launch : history) {
+        const qint64 total = launch.m_timestamps[FirstFrame];
+        timesToFirstFrame.append(total);
+        const int bucket = int(std::upper_bound(HistogramBuckets, HistogramBuckets + bucketCount, total - 1)
+                               - HistogramBuckets);
+        ++bucketCounts[bucket];
+    }
+    for (int bound : HistogramBuckets)
+        bounds.append(bound);
+    for (int count : qAsConst(bucketCounts))
+        counts.append(count);
+
+    result.insert(qSL("quickLaunches"), quickLaunches);
+    result.insert(qSL("lastLaunch"), toVariantMap(history.constLast()));
+    result.insert(qSL("phases"), phases);
+    result.insert(qSL("timeToFirstFrame"), durationStatistics(timesToFirstFrame));
+    result.insert(qSL("histogram"), QVariantMap { { qSL("bounds"), bounds }, { qSL("counts"), counts } });
+    return result;
+}
+
+/*!
+    \qmlmethod LaunchStatistics::clear()
+
+    Removes all recorded launches.
+*/
+void LaunchStatistics::clear()
+{
+    m_history.clear();
+}
+
+QT_END_NAMESPACE_AM
@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <QtAppManCommon/global.h>
+
+QT_FORWARD_DECLARE_CLASS(QQmlEngine)
+QT_FORWARD_DECLARE_CLASS(QJSEngine)
+
+QT_BEGIN_NAMESPACE_AM
+
+class LaunchStatistics : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("AM-QmlType", "QtApplicationManager.SystemUI/LaunchStatistics 2.0 SINGLETON")
+
+public:
+    // in the order they are normally reached
+    enum Phase {
+        ContainerSelection,
+        ContainerCreation,
+        RuntimeStart,
+        ProcessSpawn,
+        PeerDBusConnection,
+        StartViaLauncher,
+        SurfaceMapped,
+        FirstFrame,
+
+        PhaseCount
+    };
+    Q_ENUM(Phase)
+
+    ~LaunchStatistics() override;
+    static LaunchStatistics *instance();
+    static QObject *instanceForQml(QQmlEngine *qmlEngine, QJSEngine *);
+
+    void beginLaunch(const QString &appId);
+    void setQuickLaunched(const QString &appId, bool quickLaunched);
+    bool isLaunching(const QString &appId) const;
+    void mark(const QString &appId, Phase phase);
+    void abortLaunch(const QString &appId);
+
+    Q_INVOKABLE QStringList applicationIds() const;
+    Q_INVOKABLE QVariantMap lastLaunch(const QString &appId) const;
+    Q_INVOKABLE QVariantMap statistics(const QString &appId) const;
+    Q_INVOKABLE void clear();
+
+signals:
+    void launchFinished(const QString &appId, const QVariantMap &launch);
+
+private:
+    LaunchStatistics(QObject *parent = nullptr);
+    LaunchStatistics(const LaunchStatistics &);
+    LaunchStatistics &operator=(const LaunchStatistics &);
+    static LaunchStatistics *s_instance;
+
+    struct Launch
+    {
+        QElapsedTimer m_timer;
+        bool m_quickLaunched = false;
+        qint64 m_timestamps[PhaseCount]; // in msec since the launch began, -1 if not reached
+    };
+
+    static QVariantMap toVariantMap(const Launch &launch);
+
+    // launches that did not reach the first frame yet
+    QHash<QString, Launch> m_active;
+    // the last HistorySize completed launches of every app
+    QHash<QString, QVector<Launch>> m_history;
+};
+
+QT_END_NAMESPACE_AM
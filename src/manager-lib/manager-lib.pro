@@ -24,10 +24,12 @@ multi-process {
         nativeruntime.h \
         nativeruntime_p.h \
         processcontainer.h \
+        launcherzygote.h \
 
     SOURCES += \
         nativeruntime.cpp \
         processcontainer.cpp \
+        launcherzygote.cpp \
 
     CONFIG = dbus-adaptors-xml $$CONFIG
 
@@ -47,6 +49,11 @@ HEADERS += \
     abstractruntime.h \
     runtimefactory.h \
     quicklauncher.h \
+    quicklaunchhistory.h \
+    memorypressuretracker.h \
+    launchstatistics.h \
+    applicationstartbatch.h \
+    stopcoordinator.h \
     applicationipcmanager.h \
     applicationipcinterface.h \
     applicationipcinterface_p.h \
@@ -79,6 +86,11 @@ SOURCES += \
     abstractruntime.cpp \
     runtimefactory.cpp \
     quicklauncher.cpp \
+    quicklaunchhistory.cpp \
+    memorypressuretracker.cpp \
+    launchstatistics.cpp \
+    applicationstartbatch.cpp \
+    stopcoordinator.cpp \
     applicationipcmanager.cpp \
     applicationipcinterface.cpp \
     systemreader.cpp \
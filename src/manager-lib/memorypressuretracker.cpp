@@ -0,0 +1,138 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include <QTimerEvent>
+
+#include "logging.h"
+#include "systemreader.h"
+#include "memorypressuretracker.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+// only used, if the kernel cannot notify us about crossed memory thresholds (in msec)
+static const int MemoryPollInterval = 2000;
+
+MemoryPressureTracker::MemoryPressureTracker(const QString &name, QObject *parent)
+    : QObject(parent)
+    , m_name(name)
+{ }
+
+MemoryPressureTracker::~MemoryPressureTracker()
+{
+    if (m_memoryPollTimerId)
+        killTimer(m_memoryPollTimerId);
+    if (m_reclaimTimerId)
+        killTimer(m_reclaimTimerId);
+}
+
+void MemoryPressureTracker::setReclaimIntervals(int lowPressureInterval, int criticalPressureInterval)
+{
+    m_lowPressureInterval = qMax(1, lowPressureInterval);
+    m_criticalPressureInterval = qMax(1, criticalPressureInterval);
+}
+
+void MemoryPressureTracker::start(qreal lowThreshold, qreal criticalThreshold)
+{
+    if (m_memoryWatcher)
+        return;
+
+    m_memoryWatcher = new MemoryWatcher(this);
+    m_memoryWatcher->setThresholds(lowThreshold, criticalThreshold);
+    connect(m_memoryWatcher, &MemoryWatcher::memoryLow, this, &MemoryPressureTracker::updatePressure);
+    connect(m_memoryWatcher, &MemoryWatcher::memoryCritical, this, &MemoryPressureTracker::updatePressure);
+
+    if (!m_memoryWatcher->startWatching()) {
+        qCDebug(LogSystem).noquote() << "Memory threshold notifications are not available: polling the memory"
+                                        " usage for the" << m_name << "instead";
+        m_memoryPollTimerId = startTimer(MemoryPollInterval);
+    }
+}
+
+MemoryPressureTracker::Pressure MemoryPressureTracker::pressure() const
+{
+    return m_pressure;
+}
+
+void MemoryPressureTracker::timerEvent(QTimerEvent *te)
+{
+    if (te && ((te->timerId() == m_reclaimTimerId) || (te->timerId() == m_memoryPollTimerId))) {
+        const Pressure before = m_pressure;
+        const bool reclaimTimer = (te->timerId() == m_reclaimTimerId);
+        m_memoryWatcher->checkMemoryConsumption();
+        updatePressure();
+
+        // a change in pressure already requested a reclaim
+        if (reclaimTimer && (before != NoPressure) && (m_pressure == before))
+            emit reclaimRequested();
+    }
+}
+
+void MemoryPressureTracker::updatePressure()
+{
+    Pressure pressure = NoPressure;
+    if (m_memoryWatcher->isMemoryCritical())
+        pressure = CriticalPressure;
+    else if (m_memoryWatcher->isMemoryLow())
+        pressure = LowPressure;
+
+    if (pressure == m_pressure)
+        return;
+
+    static const char *pressureNames[] = { "none", "low", "critical" };
+    qCDebug(LogSystem).noquote() << "Memory pressure for the" << m_name << "changed from"
+                                 << pressureNames[m_pressure] << "to" << pressureNames[pressure];
+
+    m_pressure = pressure;
+    if (m_reclaimTimerId) {
+        killTimer(m_reclaimTimerId);
+        m_reclaimTimerId = 0;
+    }
+    emit pressureChanged(pressure);
+
+    if (pressure != NoPressure) {
+        m_reclaimTimerId = startTimer((pressure == CriticalPressure) ? m_criticalPressureInterval
+                                                                     : m_lowPressureInterval);
+        emit reclaimRequested();
+    }
+}
+
+QT_END_NAMESPACE_AM
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QtAppManCommon/global.h>
+
+QT_BEGIN_NAMESPACE_AM
+
+class MemoryWatcher;
+
+// Tracks the system's memory pressure via a MemoryWatcher. The threshold notifications only
+// report a rising usage, so the usage is polled as long as there is pressure. reclaimRequested()
+// is emitted as soon as the pressure rises and then periodically, as long as it persists.
+class MemoryPressureTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Pressure { NoPressure, LowPressure, CriticalPressure };
+    Q_ENUM(Pressure)
+
+    // name is only used for logging
+    MemoryPressureTracker(const QString &name, QObject *parent = nullptr);
+    ~MemoryPressureTracker() override;
+
+    // the intervals (in msec) in which reclaimRequested() is emitted under pressure
+    void setReclaimIntervals(int lowPressureInterval, int criticalPressureInterval);
+    void start(qreal lowThreshold, qreal criticalThreshold);
+
+    Pressure pressure() const;
+
+signals:
+    void pressureChanged(QT_PREPEND_NAMESPACE_AM(MemoryPressureTracker::Pressure) pressure);
+    void reclaimRequested();
+
+protected:
+    void timerEvent(QTimerEvent *te) override;
+
+private:
+    void updatePressure();
+
+    QString m_name;
+    int m_lowPressureInterval = 2000;
+    int m_criticalPressureInterval = 500;
+    MemoryWatcher *m_memoryWatcher = nullptr;
+    Pressure m_pressure = NoPressure;
+    int m_memoryPollTimerId = 0;
+    int m_reclaimTimerId = 0;
+};
+
+QT_END_NAMESPACE_AM
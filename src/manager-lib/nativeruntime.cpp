@@ -63,6 +63,8 @@
 #include "utilities.h"
 #include "notificationmanager.h"
 #include "dbus-utilities.h"
+#include "launcherzygote.h"
+#include "launchstatistics.h"
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -100,53 +102,98 @@ static qint64 getDBusPeerPid(const QDBusConnection &conn)
 
 #endif
 
+#if defined(AM_MULTI_PROCESS) && defined(Q_OS_LINUX)
+QDBusServer *NativeRuntime::s_applicationInterfaceServer = nullptr;
+QVector<NativeRuntime *> NativeRuntime::s_runtimes;
+#endif
+
 NativeRuntime::NativeRuntime(AbstractContainer *container, Application *app, NativeRuntimeManager *manager)
     : AbstractRuntime(container, app, manager)
     , m_isQuickLauncher(app == nullptr)
     , m_startedViaLauncher(manager->identifier() != qL1S("native"))
+{
+#if defined(AM_MULTI_PROCESS) && defined(Q_OS_LINUX)
+    s_runtimes.append(this);
+#endif
+}
+
+static QDBusServer *createApplicationInterfaceServer(QObject *parent)
 {
     QString dbusAddress = QUuid::createUuid().toString().mid(1,36);
-    m_applicationInterfaceServer = new QDBusServer(qSL("unix:path=/tmp/dbus-qtam-") + dbusAddress);
+    auto server = new QDBusServer(qSL("unix:path=/tmp/dbus-qtam-") + dbusAddress, parent);
+    if (!server->isConnected()) {
+        qCWarning(LogSystem) << "ERROR: could not create the peer D-Bus server:"
+                             << server->lastError().message();
+    }
+    return server;
+}
 
-    connect(m_applicationInterfaceServer, &QDBusServer::newConnection,
-            this, [this](const QDBusConnection &connection) {
 #if defined(AM_MULTI_PROCESS) && defined(Q_OS_LINUX)
-        qint64 pid = getDBusPeerPid(connection);
-        if (pid <= 0) {
-            QDBusConnection::disconnectFromPeer(connection.name());
-            qCWarning(LogSystem) << "Could not retrieve peer pid on D-Bus connection attempt.";
-            return;
-        }
 
-        // try direct PID mapping first, then check for sub-processes ... this happens when
-        // for example running the app via gdbserver
-        qint64 appmanPid = QCoreApplication::applicationPid();
+QDBusServer *NativeRuntime::sharedApplicationInterfaceServer()
+{
+    // All runtimes share a single peer-to-peer server, which is created at startup: this keeps
+    // the socket creation out of the critical launch path. New connections are dispatched to
+    // the runtime that started the connecting process.
+    if (!s_applicationInterfaceServer) {
+        s_applicationInterfaceServer = createApplicationInterfaceServer(QCoreApplication::instance());
+        QObject::connect(s_applicationInterfaceServer, &QDBusServer::newConnection,
+                         &NativeRuntime::onNewDBusPeerConnection);
+    }
+    return s_applicationInterfaceServer;
+}
+
+void NativeRuntime::onNewDBusPeerConnection(const QDBusConnection &connection)
+{
+    qint64 pid = getDBusPeerPid(connection);
+    if (pid <= 0) {
+        QDBusConnection::disconnectFromPeer(connection.name());
+        qCWarning(LogSystem) << "Could not retrieve peer pid on D-Bus connection attempt.";
+        return;
+    }
+
+    // try direct PID mapping first, then check for sub-processes ... this happens when
+    // for example running the app via gdbserver
+    qint64 appmanPid = QCoreApplication::applicationPid();
 
-        while ((pid > 1) && (pid != appmanPid)) {
-            if (applicationProcessId() == pid) {
-                onDBusPeerConnection(connection);
+    while ((pid > 1) && (pid != appmanPid)) {
+        for (NativeRuntime *rt : qAsConst(s_runtimes)) {
+            if (!rt->m_dbusConnection && (rt->applicationProcessId() == pid)) {
+                rt->onDBusPeerConnection(connection);
                 return;
             }
-            pid = getParentPid(pid);
         }
+        pid = getParentPid(pid);
+    }
 
-        QDBusConnection::disconnectFromPeer(connection.name());
-        qCWarning(LogSystem) << "Connection attempt on peer D-Bus from unknown pid:" << pid;
-#else
-        // getting the pid is not supported on e.g. macOS. Accepting everything is not secure
-        // but it at least works
-        onDBusPeerConnection(connection);
-#endif
-    });
+    QDBusConnection::disconnectFromPeer(connection.name());
+    qCWarning(LogSystem) << "Connection attempt on peer D-Bus from unknown pid:" << pid;
 }
 
-QDBusServer *NativeRuntime::applicationInterfaceServer() const
+#endif
+
+QDBusServer *NativeRuntime::applicationInterfaceServer()
 {
+#if defined(AM_MULTI_PROCESS) && defined(Q_OS_LINUX)
+    return sharedApplicationInterfaceServer();
+#else
+    // getting the pid is not supported on e.g. macOS, so connections cannot be dispatched from
+    // a shared server: every runtime gets its own one instead. Accepting everything is not
+    // secure but it at least works
+    if (!m_applicationInterfaceServer) {
+        m_applicationInterfaceServer = createApplicationInterfaceServer(this);
+        connect(m_applicationInterfaceServer, &QDBusServer::newConnection,
+                this, &NativeRuntime::onDBusPeerConnection);
+    }
     return m_applicationInterfaceServer;
+#endif
 }
 
 NativeRuntime::~NativeRuntime()
 {
+#if defined(AM_MULTI_PROCESS) && defined(Q_OS_LINUX)
+    s_runtimes.removeOne(this);
+#endif
     delete m_process;
 }
 
@@ -180,6 +227,22 @@ bool NativeRuntime::attachApplicationToQuickLauncher(Application *app)
     return ret;
 }
 
+bool NativeRuntime::preloadApplication(Application *app)
+{
+    // only launchers that are fully initialized are able to act on this hint
+    if (!app || !isQuickLauncher() || !m_startedViaLauncher || !m_runtimeInterface
+            || !m_connectedToRuntimeInterface) {
+        return false;
+    }
+
+    QString baseDir = m_container->mapHostPathToContainer(app->codeDir());
+    QString pathInContainer = m_container->mapHostPathToContainer(app->nonAliasedInfo()->absoluteCodeFilePath());
+
+    emit m_runtimeInterface->preloadApplication(baseDir, pathInContainer,
+                                                convertFromJSVariant(QVariant(app->info()->toVariantMap())).toMap());
+    return true;
+}
+
 bool NativeRuntime::initialize()
 {
     if (m_startedViaLauncher) {
@@ -205,6 +268,10 @@ bool NativeRuntime::initialize()
                 m_container->setProgram(fi.absoluteFilePath());
                 m_container->setBaseDirectory(fi.absolutePath());
                 qCDebug(LogSystem) << "Using runtime launcher"<< fi.absoluteFilePath();
+
+                // the zygote is only used once it is ready: until then the launcher is exec'ed
+                if (configuration().value(qSL("zygote")).toBool())
+                    LauncherZygote::start(fi.absoluteFilePath(), variantToStringList(configuration().value(qSL("zygotePreload"))));
                 return true;
             }
         }
@@ -244,6 +311,7 @@ bool NativeRuntime::start()
     switch (state()) {
     case Am::StartingUp:
     case Am::Running:
+    case Am::Suspended:
         return true;
     case Am::ShuttingDown:
         return false;
@@ -367,14 +435,18 @@ void NativeRuntime::stop(bool forceKill)
     if (!m_process)
         return;
 
+    // a frozen process could neither react to the quit request nor to SIGTERM
+    if ((m_state == Am::Suspended) && m_container)
+        m_container->setFrozen(false);
+
     setState(Am::ShuttingDown);
     emit aboutToStop();
 
-    if (!m_connectedToRuntimeInterface) {
+    if (forceKill) {
+        m_process->kill();
+    } else if (!m_connectedToRuntimeInterface) {
         //The launcher didn't connected to the RuntimeInterface yet, so it won't get the quit signal
         m_process->terminate();
-    } else if (forceKill) {
-        m_process->kill();
     } else {
         bool ok;
         int qt = configuration().value(qSL("quitTime")).toInt(&ok);
@@ -388,6 +460,9 @@ void NativeRuntime::stop(bool forceKill)
 
 void NativeRuntime::onProcessStarted()
 {
+    if (m_app)
+        LaunchStatistics::instance()->mark(m_app->id(), LaunchStatistics::ProcessSpawn);
+
     if (!m_startedViaLauncher && !application()->nonAliasedInfo()->supportsApplicationInterface())
         setState(Am::Running);
 }
@@ -395,7 +470,7 @@ void NativeRuntime::onProcessStarted()
 void NativeRuntime::onProcessError(Am::ProcessError error)
 {
     Q_UNUSED(error)
-    if (m_state != Am::Running && m_state != Am::ShuttingDown)
+    if (m_state != Am::Running && m_state != Am::ShuttingDown && m_state != Am::Suspended)
         shutdown(-1, Am::CrashExit);
 }
 
@@ -412,6 +487,8 @@ void NativeRuntime::onDBusPeerConnection(const QDBusConnection &connection)
 
     m_dbusConnection = true;
     m_dbusConnectionName = connection.name();
+    if (m_app)
+        LaunchStatistics::instance()->mark(m_app->id(), LaunchStatistics::PeerDBusConnection);
     QDBusConnection conn = connection;
 
     m_applicationInterface = new NativeRuntimeApplicationInterface(this);
@@ -454,6 +531,8 @@ void NativeRuntime::onApplicationFinishedInitialization()
             startApplicationViaLauncher();
 
         setState(Am::Running);
+    } else if (m_isQuickLauncher) {
+        emit readyForQuickLaunch();
     }
 }
 
@@ -468,6 +547,7 @@ bool NativeRuntime::startApplicationViaLauncher()
     emit m_runtimeInterface->startApplication(baseDir, pathInContainer, m_document, m_mimeType,
                                               convertFromJSVariant(QVariant(m_app->info()->toVariantMap())).toMap(),
                                               convertFromJSVariant(QVariant(systemProperties())).toMap());
+    LaunchStatistics::instance()->mark(m_app->id(), LaunchStatistics::StartViaLauncher);
     return true;
 }
 
@@ -564,7 +644,11 @@ NativeRuntimeManager::NativeRuntimeManager(QObject *parent)
 
 NativeRuntimeManager::NativeRuntimeManager(const QString &id, QObject *parent)
     : AbstractRuntimeManager(id, parent)
-{ }
+{
+#if defined(AM_MULTI_PROCESS) && defined(Q_OS_LINUX)
+    NativeRuntime::sharedApplicationInterfaceServer(); // bind the socket before the first app start
+#endif
+}
 
 QString NativeRuntimeManager::defaultIdentifier()
 {
@@ -84,6 +84,7 @@ public:
 
     bool isQuickLauncher() const override;
     bool attachApplicationToQuickLauncher(Application *app) override;
+    bool preloadApplication(Application *app) override;
 
     qint64 applicationProcessId() const override;
     void openDocument(const QString &document, const QString &mimeType) override;
@@ -116,7 +117,11 @@ protected:
 private:
     bool initialize();
     void shutdown(int exitCode, Am::ExitStatus status);
-    QDBusServer *applicationInterfaceServer() const;
+    QDBusServer *applicationInterfaceServer();
+#if defined(AM_MULTI_PROCESS) && defined(Q_OS_LINUX)
+    static QDBusServer *sharedApplicationInterfaceServer();
+    static void onNewDBusPeerConnection(const QDBusConnection &connection);
+#endif
     bool startApplicationViaLauncher();
 
     bool m_isQuickLauncher;
@@ -132,10 +137,16 @@ private:
     NativeRuntimeApplicationInterface *m_applicationInterface = nullptr;
     NativeRuntimeInterface *m_runtimeInterface = nullptr;
     AbstractContainerProcess *m_process = nullptr;
-    QDBusServer *m_applicationInterfaceServer;
     bool m_slowAnimations = false;
     QVariantMap m_openGLConfiguration;
 
+#if defined(AM_MULTI_PROCESS) && defined(Q_OS_LINUX)
+    static QDBusServer *s_applicationInterfaceServer;
+    static QVector<NativeRuntime *> s_runtimes;
+#else
+    QDBusServer *m_applicationInterfaceServer = nullptr;
+#endif
+
     friend class NativeRuntimeManager;
 };
 
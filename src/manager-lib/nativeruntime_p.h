@@ -84,6 +84,8 @@ signals:
     Q_SCRIPTABLE void startApplication(const QString &baseDir, const QString &app, const QString &document,
                                        const QString &mimeType, const QVariantMap &application,
                                        const QVariantMap &systemProperties);
+    Q_SCRIPTABLE void preloadApplication(const QString &baseDir, const QString &app,
+                                         const QVariantMap &application);
 
 private:
     NativeRuntime *m_runtime;
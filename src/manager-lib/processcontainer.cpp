@@ -40,6 +40,11 @@
 **
 ****************************************************************************/
 
+#include <QDir>
+#include <QFileInfo>
+
+#include <algorithm>
+
 #include "global.h"
 #include "logging.h"
 #include "containerfactory.h"
@@ -47,12 +52,26 @@
 #include "processcontainer.h"
 #include "systemreader.h"
 #include "debugwrapper.h"
+#include "launcherzygote.h"
 
 #if defined(Q_OS_UNIX)
 #  include <csignal>
 #  include <unistd.h>
 #  include <fcntl.h>
 #endif
+#if defined(Q_OS_LINUX)
+#  include <cerrno>
+#  include <cstring>
+#  include <pthread.h>
+#  include <sys/syscall.h>
+#  include <sys/wait.h>
+#  if !defined(SYS_pidfd_open)
+#    define SYS_pidfd_open 434
+#  endif
+#  include <QSocketNotifier>
+#  include <QStandardPaths>
+#  include <QFile>
+#endif
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -85,20 +104,64 @@ public:
 
 
 HostProcess::HostProcess()
-    : m_process(new HostQProcess)
-{
-    m_process->setProcessChannelMode(QProcess::ForwardedChannels);
-    m_process->setInputChannelMode(QProcess::ForwardedInputChannel);
-}
+{ }
 
 HostProcess::~HostProcess()
 {
-    m_process->disconnect(this);
-    delete m_process;
+    if (m_process) {
+        m_process->disconnect(this);
+        delete m_process;
+    }
+#if defined(Q_OS_LINUX)
+    delete m_pidFdNotifier;
+    if (m_pidFd >= 0)
+        ::close(m_pidFd);
+#endif
 }
 
 void HostProcess::start(const QString &program, const QStringList &arguments)
 {
+#if defined(Q_OS_UNIX)
+    // make sure that the redirection fds do not have a close-on-exec flag, since we need them
+    // in the child process.
+    for (int fd : qAsConst(m_stdioRedirections)) {
+        if (fd < 0)
+            continue;
+        int flags = fcntl(fd, F_GETFD);
+        if (flags & FD_CLOEXEC)
+            fcntl(fd, F_SETFD, flags & ~FD_CLOEXEC);
+    }
+#endif
+
+#if defined(Q_OS_LINUX)
+    // QProcess forks the whole System UI, which is expensive due to the huge number of mappings
+    // it has to copy. A vfork() does not copy anything, so we prefer it whenever we are able to
+    // reliably get notified about the child's exit.
+    if (!canSpawn() || !spawn(program, arguments))
+#endif
+        startQProcess(program, arguments);
+
+#if defined(Q_OS_UNIX)
+    // we are forked now and the child process has received a copy of all redirected fds
+    // now it's time to close our fds, since we don't need them anymore (plus we would block
+    // the tty where they originated from)
+    for (int fd : qAsConst(m_stdioRedirections)) {
+        if (fd >= 0)
+            ::close(fd);
+    }
+#endif
+}
+
+void HostProcess::startQProcess(const QString &program, const QStringList &arguments)
+{
+    m_process = new HostQProcess;
+    m_process->setProcessChannelMode(QProcess::ForwardedChannels);
+    m_process->setInputChannelMode(QProcess::ForwardedInputChannel);
+    m_process->setWorkingDirectory(m_workingDirectory);
+    m_process->setProcessEnvironment(m_environment);
+    m_process->m_stopBeforeExec = m_stopBeforeExec;
+    m_process->m_stdioRedirections = m_stdioRedirections;
+
     connect(m_process, &QProcess::started, this, [this]() {
          // we to cache the pid in order to have it available after the process crashed
         m_pid = m_process->processId();
@@ -117,49 +180,239 @@ void HostProcess::start(const QString &program, const QStringList &arguments)
         emit stateChanged(static_cast<Am::RunState>(newState));
     });
 
-#if defined(Q_OS_UNIX)
-    // make sure that the redirection fds do not have a close-on-exec flag, since we need them
-    // in the child process.
-    for (int fd : qAsConst(m_process->m_stdioRedirections)) {
+    m_process->start(program, arguments);
+}
+
+#if defined(Q_OS_LINUX)
+
+static int pidfdOpen(pid_t pid)
+{
+    return int(::syscall(SYS_pidfd_open, pid, 0));
+}
+
+bool HostProcess::canSpawn()
+{
+    // pidfds (Linux 5.3) let us watch for the exit of our children without a SIGCHLD handler,
+    // which would interfere with the one installed by QProcess
+    static const bool pidFdsSupported = []() {
+        int fd = pidfdOpen(getpid());
         if (fd < 0)
-            continue;
-        int flags = fcntl(fd, F_GETFD);
-        if (flags & FD_CLOEXEC)
-            fcntl(fd, F_SETFD, flags & ~FD_CLOEXEC);
+            return false;
+        ::close(fd);
+        return true;
+    }();
+    return pidFdsSupported;
+}
+
+bool HostProcess::spawn(const QString &program, const QStringList &arguments)
+{
+    // everything the child needs has to be prepared here: between vfork() and exec() the child
+    // shares our memory and is only allowed to call async-signal-safe functions
+    QString executable = program;
+    if (!executable.contains(qL1C('/')))
+        executable = QStandardPaths::findExecutable(program);
+    if (executable.isEmpty())
+        return false; // let QProcess report the error
+
+    const QByteArray path = QFile::encodeName(executable);
+    const QByteArray workingDirectory = QFile::encodeName(m_workingDirectory);
+
+    QVector<QByteArray> argStorage;
+    argStorage.reserve(arguments.size() + 1);
+    argStorage << QFile::encodeName(program);
+    for (const QString &arg : arguments)
+        argStorage << arg.toLocal8Bit();
+    QVector<char *> argv;
+    argv.reserve(argStorage.size() + 1);
+    for (QByteArray &arg : argStorage)
+        argv << arg.data();
+    argv << nullptr;
+
+    const QStringList environment = m_environment.toStringList();
+    QVector<QByteArray> envStorage;
+    envStorage.reserve(environment.size());
+    for (const QString &env : environment)
+        envStorage << env.toLocal8Bit();
+    QVector<char *> envp;
+    envp.reserve(envStorage.size() + 1);
+    for (QByteArray &env : envStorage)
+        envp << env.data();
+    envp << nullptr;
+
+    // the non-const QVector::data() might detach, which must not happen in the child
+    char * const *argvData = argv.data();
+    char * const *envpData = envp.data();
+
+    int redirections[3];
+    for (int i = 0; i < 3; ++i)
+        redirections[i] = m_stdioRedirections.value(i, -1);
+
+    static const char stopMessage[] = "\n*** a 'process' container was started in stopped state ***\n"
+                                      "the process is suspended via SIGSTOP and you can attach a debugger to it via\n\n"
+                                      "   gdb -p ";
+    const bool stopBeforeExec = m_stopBeforeExec;
+
+    struct sigaction defaultAction;
+    memset(&defaultAction, 0, sizeof(defaultAction));
+    defaultAction.sa_handler = SIG_DFL;
+
+    // no signal handler of ours must run in the child, while it still shares our memory
+    sigset_t allSignals, oldMask;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &oldMask);
+
+    volatile int childErrno = 0;
+
+    // stopping the child before the exec() would also block us with vfork(), but this is only
+    // used for debugging anyway
+    pid_t pid = stopBeforeExec ? ::fork() : ::vfork();
+
+    if (pid == 0) {
+        for (int sig = 1; sig < NSIG; ++sig) {
+            struct sigaction action;
+            if ((sigaction(sig, nullptr, &action) == 0) && (action.sa_handler != SIG_IGN)
+                    && (action.sa_handler != SIG_DFL)) {
+                sigaction(sig, &defaultAction, nullptr);
+            }
+        }
+        // same order as in HostQProcess: the message goes to our stderr, not the redirected one
+        if (stopBeforeExec) {
+            char pidStr[16];
+            int len = 0;
+            for (pid_t p = ::getpid(); p > 0 && len < 15; p /= 10)
+                pidStr[len++] = char('0' + p % 10);
+            std::reverse(pidStr, pidStr + len);
+            pidStr[len++] = '\n';
+            (void) !::write(STDERR_FILENO, stopMessage, sizeof(stopMessage) - 1);
+            (void) !::write(STDERR_FILENO, pidStr, size_t(len));
+            (void) !::write(STDERR_FILENO, "\n", 1);
+            ::raise(SIGSTOP);
+        }
+        for (int i = 0; i < 3; ++i) {
+            int fd = redirections[i];
+            if ((fd >= 0) && (fd != i)) {
+                ::dup2(fd, i);
+                if (fd > 2)
+                    ::close(fd);
+            }
+        }
+        if (!workingDirectory.isEmpty() && (::chdir(workingDirectory.constData()) != 0)) {
+            childErrno = errno;
+            ::_exit(127);
+        }
+        pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
+        ::execve(path.constData(), argvData, envpData);
+        childErrno = errno;
+        ::_exit(127);
     }
-#endif
 
-    m_process->start(program, arguments);
+    const int forkErrno = errno;
+    pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
 
-#if defined(Q_OS_UNIX)
-    // we are forked now and the child process has received a copy of all redirected fds
-    // now it's time to close our fds, since we don't need them anymore (plus we would block
-    // the tty where they originated from)
-    for (int fd : qAsConst(m_process->m_stdioRedirections)) {
-        if (fd >= 0)
-            ::close(fd);
+    if (pid < 0) {
+        qCWarning(LogSystem) << "ERROR: could not vfork:" << strerror(forkErrno);
+        return false;
     }
-#endif
+
+    if (childErrno) {
+        // only vfork() reports exec errors back to us: the child is gone already, so just reap it
+        ::waitpid(pid, nullptr, 0);
+        qCWarning(LogSystem) << "ERROR: could not execute" << executable << ":" << strerror(childErrno);
+
+        m_state = Am::NotRunning;
+        QMetaObject::invokeMethod(this, [this]() {
+            emit errorOccured(Am::FailedToStart);
+            emit stateChanged(m_state);
+        }, Qt::QueuedConnection);
+        return true;
+    }
+
+    m_pid = pid;
+    m_state = Am::StartingUp;
+
+    m_pidFd = pidfdOpen(pid);
+    if (m_pidFd >= 0) {
+        m_pidFdNotifier = new QSocketNotifier(m_pidFd, QSocketNotifier::Read);
+        connect(m_pidFdNotifier, &QSocketNotifier::activated,
+                this, &HostProcess::onSpawnedProcessExited);
+    } else {
+        // this cannot really happen, since canSpawn() succeeded
+        qCWarning(LogSystem) << "ERROR: could not watch the process" << pid << ":" << strerror(errno);
+    }
+
+    // QProcess also reports the start asynchronously: callers connect after start() returned
+    QMetaObject::invokeMethod(this, [this]() {
+        if (m_state != Am::StartingUp)
+            return;
+        m_state = Am::Running;
+        emit started();
+        emit stateChanged(m_state);
+    }, Qt::QueuedConnection);
+    return true;
 }
 
+void HostProcess::onSpawnedProcessExited()
+{
+    int status = 0;
+    pid_t pid = 0;
+    do {
+        pid = ::waitpid(pid_t(m_pid), &status, WNOHANG);
+    } while ((pid < 0) && (errno == EINTR));
+
+    if (pid == 0) // not exited yet
+        return;
+
+    m_pidFdNotifier->setEnabled(false);
+    m_pidFdNotifier->deleteLater();
+    m_pidFdNotifier = nullptr;
+    ::close(m_pidFd);
+    m_pidFd = -1;
+
+    const bool crashed = (pid < 0) || WIFSIGNALED(status);
+    const int exitCode = (pid < 0) ? -1 : (WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status));
+
+    const bool wasStarted = (m_state == Am::Running);
+    m_state = Am::NotRunning;
+    if (!wasStarted) {
+        // exited before the queued start notification was delivered
+        emit started();
+    }
+    if (crashed)
+        emit errorOccured(Am::Crashed);
+    emit stateChanged(m_state);
+    emit finished(exitCode, crashed ? Am::CrashExit : Am::NormalExit);
+}
+
+#endif // Q_OS_LINUX
+
 void HostProcess::setWorkingDirectory(const QString &dir)
 {
-    m_process->setWorkingDirectory(dir);
+    m_workingDirectory = dir;
 }
 
 void HostProcess::setProcessEnvironment(const QProcessEnvironment &environment)
 {
-    m_process->setProcessEnvironment(environment);
+    m_environment = environment;
 }
 
 void HostProcess::kill()
 {
-    m_process->kill();
+    if (m_process)
+        m_process->kill();
+#if defined(Q_OS_UNIX)
+    else if ((m_state != Am::NotRunning) && (m_pid > 0))
+        ::kill(pid_t(m_pid), SIGKILL);
+#endif
 }
 
 void HostProcess::terminate()
 {
-    m_process->terminate();
+    if (m_process)
+        m_process->terminate();
+#if defined(Q_OS_UNIX)
+    else if ((m_state != Am::NotRunning) && (m_pid > 0))
+        ::kill(pid_t(m_pid), SIGTERM);
+#endif
 }
 
 qint64 HostProcess::processId() const
@@ -169,17 +422,17 @@ qint64 HostProcess::processId() const
 
 Am::RunState HostProcess::state() const
 {
-    return static_cast<Am::RunState>(m_process->state());
+    return m_process ? static_cast<Am::RunState>(m_process->state()) : m_state;
 }
 
 void HostProcess::setStdioRedirections(const QVector<int> &stdioRedirections)
 {
-    m_process->m_stdioRedirections = stdioRedirections;
+    m_stdioRedirections = stdioRedirections;
 }
 
 void HostProcess::setStopBeforeExec(bool stopBeforeExec)
 {
-    m_process->m_stopBeforeExec = stopBeforeExec;
+    m_stopBeforeExec = stopBeforeExec;
 }
 
 
@@ -194,7 +447,11 @@ ProcessContainer::ProcessContainer(ProcessContainerManager *manager, AbstractApp
 { }
 
 ProcessContainer::~ProcessContainer()
-{ }
+{
+    // only succeeds once the group is empty, but the process is gone at this point anyway
+    if (!m_freezerGroup.isEmpty())
+        QDir().rmdir(m_freezerGroup);
+}
 
 QString ProcessContainer::controlGroup() const
 {
@@ -213,6 +470,41 @@ bool ProcessContainer::setControlGroup(const QString &groupName)
         QByteArray pidString = QByteArray::number(m_process->processId());
         pidString.append('\n');
 
+#if defined(Q_OS_LINUX)
+        if (isCGroupV2()) {
+            // In the unified hierarchy, a process is a member of exactly one group, which has all
+            // the controllers (memory, cpu, ...) attached. All the sub-system names should
+            // therefore map to the same group: if not, the memory group wins.
+            QStringList groups;
+            for (auto it = mapping.cbegin(); it != mapping.cend(); ++it) {
+                if (!groups.contains(it.value().toString()))
+                    groups << it.value().toString();
+            }
+            if (groups.isEmpty())
+                return false;
+
+            const QString group = mapping.value(qSL("memory"), groups.constFirst()).toString();
+            if (groups.size() > 1) {
+                qCWarning(LogSystem) << "WARNING: control group" << groupName << "maps to multiple cgroups"
+                                     << groups << ", but with cgroups v2 only" << group << "can be used";
+            }
+
+            QFile f(QString(qSL("/sys/fs/cgroup/%1/cgroup.procs")).arg(group));
+            bool ok = f.open(QFile::WriteOnly);
+            ok = ok && (f.write(pidString) == pidString.size());
+
+            if (!ok) {
+                qWarning() << "Failed setting cgroup for" << m_program << ", pid" << m_process->processId() << ":" << group;
+                return false;
+            }
+            watchMemory(group);
+
+            m_currentControlGroup = groupName;
+            checkFreezerGroup();
+            return true;
+        }
+#endif
+
         for (auto it = mapping.cbegin(); it != mapping.cend(); ++it) {
             const QString &resource = it.key();
             const QString &userclass = it.value().toString();
@@ -229,23 +521,125 @@ bool ProcessContainer::setControlGroup(const QString &groupName)
                 return false;
             }
 
-            if (resource == qSL("memory")) {
-                if (!m_memWatcher) {
-                    m_memWatcher = new MemoryWatcher(this);
-                    connect(m_memWatcher, &MemoryWatcher::memoryLow,
-                            this, &ProcessContainer::memoryLowWarning);
-                    connect(m_memWatcher, &MemoryWatcher::memoryCritical,
-                            this, &ProcessContainer::memoryCriticalWarning);
-                }
-                m_memWatcher->startWatching(userclass);
-            }
+            if (resource == qSL("memory"))
+                watchMemory(userclass);
         }
         m_currentControlGroup = groupName;
+#if defined(Q_OS_LINUX)
+        checkFreezerGroup();
+#endif
         return true;
     }
     return false;
 }
 
+bool ProcessContainer::setFrozen(bool frozen)
+{
+#if defined(Q_OS_LINUX)
+    if (!m_process || (m_process->processId() <= 0))
+        return false;
+    if (frozen == m_frozen)
+        return true;
+
+    // The freezer always acts on a whole cgroup, but control groups are normally shared between
+    // applications: the process is moved into a group of its own below its current one.
+    if (m_freezerGroup.isEmpty()) {
+        m_freezerGroup = createFreezerGroup();
+        if (m_freezerGroup.isEmpty())
+            return false;
+    }
+
+    const bool v2 = isCGroupV2();
+    QFile f(m_freezerGroup + (v2 ? qSL("/cgroup.freeze") : qSL("/freezer.state")));
+    const QByteArray state = v2 ? (frozen ? "1" : "0") : (frozen ? "FROZEN" : "THAWED");
+    bool ok = f.open(QFile::WriteOnly);
+    ok = ok && (f.write(state) == state.size());
+
+    if (!ok) {
+        qCWarning(LogSystem) << "WARNING: could not" << (frozen ? "freeze" : "thaw") << m_program
+                             << ", pid" << m_process->processId() << ":" << f.fileName() << f.errorString();
+        return false;
+    }
+    m_frozen = frozen;
+    return true;
+#else
+    Q_UNUSED(frozen)
+    return false;
+#endif
+}
+
+#if defined(Q_OS_LINUX)
+
+QString ProcessContainer::createFreezerGroup() const
+{
+    const qint64 pid = m_process->processId();
+    const bool v2 = isCGroupV2();
+    // the unified hierarchy is listed without a controller name in /proc/<pid>/cgroup
+    const QByteArray currentGroup = fetchCGroupProcessInfo(pid).value(v2 ? QByteArray() : QByteArray("freezer"));
+    if (currentGroup.isEmpty()) {
+        qCWarning(LogSystem) << "WARNING: cannot freeze" << m_program << ", pid" << pid
+                             << ": the process is not part of a" << (v2 ? "cgroup v2" : "freezer cgroup") << "hierarchy";
+        return QString();
+    }
+
+    QString group = (v2 ? qSL("/sys/fs/cgroup") : qSL("/sys/fs/cgroup/freezer"))
+            + QString::fromLocal8Bit(currentGroup);
+    if (!group.endsWith(qL1C('/')))
+        group.append(qL1C('/'));
+    group.append(qSL("am-frozen-%1").arg(pid));
+
+    QByteArray pidString = QByteArray::number(pid);
+    pidString.append('\n');
+
+    QFile f(group + qSL("/cgroup.procs"));
+    bool ok = (QDir().mkdir(group) || QFileInfo(group).isDir());
+    ok = ok && f.open(QFile::WriteOnly);
+    ok = ok && (f.write(pidString) == pidString.size());
+
+    if (!ok) {
+        qCWarning(LogSystem) << "WARNING: cannot freeze" << m_program << ", pid" << pid
+                             << ": failed to move it into" << group;
+        QDir().rmdir(group);
+        return QString();
+    }
+    return group;
+}
+
+// setControlGroup() might have moved the process out of its freezer group
+void ProcessContainer::checkFreezerGroup()
+{
+    if (m_freezerGroup.isEmpty() || !m_process)
+        return;
+
+    const bool v2 = isCGroupV2();
+    const QByteArray currentGroup = fetchCGroupProcessInfo(m_process->processId())
+            .value(v2 ? QByteArray() : QByteArray("freezer"));
+    if (m_freezerGroup.endsWith(QString::fromLocal8Bit(currentGroup)))
+        return;
+
+    QDir().rmdir(m_freezerGroup);
+    m_freezerGroup.clear();
+
+    if (m_frozen) {
+        m_frozen = false;
+        setFrozen(true);
+    }
+}
+
+#endif
+
+void ProcessContainer::watchMemory(const QString &group)
+{
+    if (!m_memWatcher) {
+        m_memWatcher = new MemoryWatcher(this);
+        connect(m_memWatcher, &MemoryWatcher::memoryLow,
+                this, &ProcessContainer::memoryLowWarning);
+        connect(m_memWatcher, &MemoryWatcher::memoryCritical,
+                this, &ProcessContainer::memoryCriticalWarning);
+    }
+    m_memWatcher->startWatching(group);
+}
+
 bool ProcessContainer::isReady()
 {
     return true;
@@ -279,10 +673,30 @@ AbstractContainerProcess *ProcessContainer::start(const QStringList &arguments,
             penv.insert(it.key(), it.value());
     }
 
+    const bool stopBeforeExec = configuration().value(qSL("stopBeforeExec")).toBool();
+
+    // Forking from a zygote is only possible, if nothing special has to happen before the exec()
+    LauncherZygote *zygote = nullptr;
+    if (!stopBeforeExec && m_debugWrapperCommand.isEmpty()
+            && std::all_of(m_stdioRedirections.cbegin(), m_stdioRedirections.cend(), [](int fd) { return fd < 0; })) {
+        zygote = LauncherZygote::readyForProgram(m_program);
+    }
+    if (zygote) {
+        qCDebug(LogSystem) << "Forking from the zygote:" << m_program << "arguments:" << arguments;
+
+        m_process = zygote->fork(arguments, penv, m_baseDirectory);
+
+        // the pid is only known after the zygote has forked
+        const QString defaultControlGroup = configuration().value(qSL("defaultControlGroup")).toString();
+        connect(m_process, &AbstractContainerProcess::started,
+                this, [this, defaultControlGroup]() { setControlGroup(defaultControlGroup); });
+        return m_process;
+    }
+
     HostProcess *process = new HostProcess();
     process->setWorkingDirectory(m_baseDirectory);
     process->setProcessEnvironment(penv);
-    process->setStopBeforeExec(configuration().value(qSL("stopBeforeExec")).toBool());
+    process->setStopBeforeExec(stopBeforeExec);
     process->setStdioRedirections(m_stdioRedirections);
 
     QString command = m_program;
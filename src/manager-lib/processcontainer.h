@@ -46,6 +46,8 @@
 #include <QtAppManManager/amnamespace.h>
 #include <QProcess>
 
+QT_FORWARD_DECLARE_CLASS(QSocketNotifier)
+
 QT_BEGIN_NAMESPACE_AM
 
 class MemoryWatcher;
@@ -91,8 +93,25 @@ public slots:
     void setStopBeforeExec(bool stopBeforeExec);
 
 private:
-    HostQProcess *m_process;
+    void startQProcess(const QString &program, const QStringList &arguments);
+#if defined(Q_OS_LINUX)
+    static bool canSpawn();
+    bool spawn(const QString &program, const QStringList &arguments);
+    void onSpawnedProcessExited();
+#endif
+
+    HostQProcess *m_process = nullptr;
     qint64 m_pid = 0;
+
+    bool m_stopBeforeExec = false;
+    QVector<int> m_stdioRedirections;
+    QString m_workingDirectory;
+    QProcessEnvironment m_environment = QProcessEnvironment::systemEnvironment();
+
+    // only used for processes started via spawn()
+    Am::RunState m_state = Am::NotRunning;
+    int m_pidFd = -1;
+    QSocketNotifier *m_pidFdNotifier = nullptr;
 };
 
 class ProcessContainer : public AbstractContainer
@@ -108,6 +127,7 @@ public:
 
     QString controlGroup() const override;
     bool setControlGroup(const QString &groupName) override;
+    bool setFrozen(bool frozen) override;
 
     bool isReady() override;
 
@@ -116,7 +136,15 @@ public:
                                     const QVariantMap &amConfig) override;
 
 private:
+    void watchMemory(const QString &group);
+#if defined(Q_OS_LINUX)
+    QString createFreezerGroup() const;
+    void checkFreezerGroup();
+#endif
+
     QString m_currentControlGroup;
+    QString m_freezerGroup; // absolute path of the process' own group in the freezer hierarchy
+    bool m_frozen = false;
     QVector<int> m_stdioRedirections;
     QMap<QString, QString> m_debugWrapperEnvironment;
     QStringList m_debugWrapperCommand;
@@ -43,19 +43,86 @@
 #include <QCoreApplication>
 #include <QTimer>
 #include <QMetaObject>
+#include <QFile>
+#include <QSaveFile>
+#include <QQmlEngine>
 
 #include "logging.h"
 #include "abstractcontainer.h"
 #include "abstractruntime.h"
+#include "application.h"
 #include "containerfactory.h"
 #include "runtimefactory.h"
 #include "quicklauncher.h"
 #include "systemreader.h"
+#include "memorypressuretracker.h"
+#include "stopcoordinator.h"
+
+/*!
+    \qmltype QuickLauncher
+    \inqmlmodule QtApplicationManager.SystemUI
+    \ingroup system-ui-singletons
+    \brief The state of the quick-launch pool.
+
+    The QuickLauncher singleton gives the System UI read-only access to the pool of idle
+    quick-launchers, which is configured via the \e quicklaunch section of the
+    \l{Configuration}{configuration}. It is meant for monitoring and tuning this
+    configuration, e.g. to check whether the pool keeps up with the application starts.
+
+    The pool is always empty, if quick-launching is disabled (e.g. in single-process mode).
+*/
+
+/*!
+    \qmlproperty int QuickLauncher::poolSize
+    \readonly
+
+    The number of quick-launchers the pool is currently trying to keep ready, summed up over all
+    container/runtime combinations. With \e quicklaunch/adaptive enabled, this number changes
+    with the launch history, the time since start-up and the memory pressure.
+*/
+
+/*!
+    \qmlproperty int QuickLauncher::occupancy
+    \readonly
+
+    The number of quick-launchers that are ready to be used for an application start.
+*/
+
+/*!
+    \qmlproperty int QuickLauncher::pendingStarts
+    \readonly
+
+    The number of quick-launchers that are currently starting up to refill the pool.
+*/
+
+/*!
+    \qmlproperty int QuickLauncher::lastRefillLatency
+    \readonly
+
+    The time in milliseconds it took the most recently started quick-launcher to become ready.
+*/
+
+/*!
+    \qmlproperty real QuickLauncher::averageRefillLatency
+    \readonly
+
+    The average of lastRefillLatency over all quick-launchers started so far.
+*/
 
 QT_BEGIN_NAMESPACE_AM
 
 QuickLauncher *QuickLauncher::s_instance = nullptr;
 
+// a quick-launcher that did not report back after this time (in msec) is not pending anymore
+static const int PendingStartTimeout = 5000;
+
+// under memory pressure, one quick-launcher is released per interval (in msec)
+static const int LowPressureReclaimInterval = 2000;
+static const int CriticalPressureReclaimInterval = 500;
+
+// refilling the pool right after the pressure is gone would most likely bring it right back
+static const int RefillHoldOff = 10000;
+
 QuickLauncher *QuickLauncher::instance()
 {
     if (!s_instance)
@@ -63,6 +130,12 @@ QuickLauncher *QuickLauncher::instance()
     return s_instance;
 }
 
+QObject *QuickLauncher::instanceForQml(QQmlEngine *, QJSEngine *)
+{
+    QQmlEngine::setObjectOwnership(instance(), QQmlEngine::CppOwnership);
+    return instance();
+}
+
 QuickLauncher::QuickLauncher(QObject *parent)
     : QObject(parent)
 { }
@@ -75,6 +148,37 @@ QuickLauncher::~QuickLauncher()
     s_instance = nullptr;
 }
 
+void QuickLauncher::enableAdaptiveSizing(const QString &historyFile, int memoryBudget, int memoryPerRuntime)
+{
+    m_adaptive = true;
+    m_historyFile = historyFile;
+    m_memoryBudget = qMax(0, memoryBudget);
+    m_memoryPerRuntime = qMax(1, memoryPerRuntime);
+}
+
+void QuickLauncher::enableMemoryPressureHandling(qreal lowThreshold, qreal criticalThreshold)
+{
+    if (m_memoryPressure)
+        return;
+
+    m_memoryPressure = new MemoryPressureTracker(qSL("quick-launch pool"), this);
+    m_memoryPressure->setReclaimIntervals(LowPressureReclaimInterval, CriticalPressureReclaimInterval);
+    connect(m_memoryPressure, &MemoryPressureTracker::pressureChanged,
+            this, [this](MemoryPressureTracker::Pressure pressure) {
+        if ((pressure == MemoryPressureTracker::NoPressure) && !m_shuttingDown) {
+            m_refillHoldOffEnd = m_uptime.elapsed() + RefillHoldOff;
+            triggerRebuild(RefillHoldOff);
+        }
+    });
+    connect(m_memoryPressure, &MemoryPressureTracker::reclaimRequested, this, &QuickLauncher::reclaim);
+    m_memoryPressure->start(lowThreshold, criticalThreshold);
+}
+
+bool QuickLauncher::isUnderMemoryPressure() const
+{
+    return m_memoryPressure && (m_memoryPressure->pressure() != MemoryPressureTracker::NoPressure);
+}
+
 void QuickLauncher::initialize(int runtimesPerContainer, qreal idleLoad)
 {
     ContainerFactory *cf = ContainerFactory::instance();
@@ -100,6 +204,7 @@ void QuickLauncher::initialize(int runtimesPerContainer, qreal idleLoad)
             QuickLaunchEntry entry;
             entry.m_containerId = containerId;
             entry.m_maximum = runtimesPerContainer;
+            entry.m_target = runtimesPerContainer;
 
             if (rf->manager(runtimeId)->supportsQuickLaunch())
                 entry.m_runtimeId = runtimeId;
@@ -117,9 +222,106 @@ void QuickLauncher::initialize(int runtimesPerContainer, qreal idleLoad)
         m_idleCpu = new CpuReader();
         m_idleTimerId = startTimer(1000);
     }
+
+    m_uptime.start();
+    if (m_adaptive) {
+        loadHistory();
+        updateTargets();
+
+        // the targets depend on the current phase
+        for (int phase = 0; phase < QuickLaunchHistory::PhaseCount - 1; ++phase) {
+            QTimer::singleShot(int(QuickLaunchHistory::phaseEnd(phase)), this,
+                               [this]() { updateTargets(); triggerRebuild(); });
+        }
+    }
     triggerRebuild();
 }
 
+int QuickLauncher::currentPhase() const
+{
+    return QuickLaunchHistory::phaseAt(m_uptime.isValid() ? m_uptime.elapsed() : 0);
+}
+
+QuickLaunchHistory::Key QuickLauncher::historyKey(const QuickLaunchEntry &entry)
+{
+    return qMakePair(entry.m_containerId, entry.m_runtimeId);
+}
+
+void QuickLauncher::updateTargets()
+{
+    if (!m_adaptive)
+        return;
+
+    const int phase = currentPhase();
+    const int budget = m_memoryBudget ? (m_memoryBudget / m_memoryPerRuntime) : -1;
+
+    QVector<QuickLaunchHistory::Key> keys;
+    QVector<int> maximums;
+    for (const auto &entry : qAsConst(m_quickLaunchPool)) {
+        keys << historyKey(entry);
+        maximums << entry.m_maximum;
+    }
+    const QVector<int> targets = m_history.targets(keys, maximums, phase, budget);
+    for (int i = 0; i < m_quickLaunchPool.size(); ++i)
+        m_quickLaunchPool[i].m_target = targets.at(i);
+
+    qCDebug(LogSystem) << "Quick-launch pool targets for phase" << phase << "(budget:"
+                       << budget << "runtimes):";
+    for (const auto &entry : qAsConst(m_quickLaunchPool)) {
+        qCDebug(LogSystem).nospace().noquote() << " * " << entry.m_containerId << " / "
+                                               << (entry.m_runtimeId.isEmpty() ? qSL("(no runtime)") : entry.m_runtimeId)
+                                               << " [target: " << entry.m_target << "]";
+    }
+}
+
+void QuickLauncher::recordTake(const QuickLaunchEntry &entry, bool hit)
+{
+    if (!m_adaptive)
+        return;
+
+    m_history.recordTake(historyKey(entry), currentPhase());
+    if (!hit) {
+        qCDebug(LogSystem).noquote() << "The quick-launch pool had no entry ready for"
+                                     << entry.m_containerId << "/"
+                                     << (entry.m_runtimeId.isEmpty() ? qSL("(no runtime)") : entry.m_runtimeId);
+    }
+
+    updateTargets();
+
+    // coalesce the writes, since a lot of apps might be started in a row
+    if (!m_historySavePending) {
+        m_historySavePending = true;
+        QTimer::singleShot(10000, this, &QuickLauncher::saveHistory);
+    }
+}
+
+void QuickLauncher::loadHistory()
+{
+    QFile f(m_historyFile);
+    if (m_historyFile.isEmpty() || !f.open(QIODevice::ReadOnly))
+        return;
+
+    if (!m_history.load(&f)) {
+        qCWarning(LogSystem) << "WARNING: ignoring the incompatible or corrupt quick-launch history in"
+                             << m_historyFile;
+        return;
+    }
+    qCDebug(LogSystem) << "Loaded the quick-launch history for" << m_history.size()
+                       << "container/runtime combinations from" << m_historyFile;
+}
+
+void QuickLauncher::saveHistory()
+{
+    m_historySavePending = false;
+    if (m_historyFile.isEmpty() || m_history.isEmpty())
+        return;
+
+    QSaveFile f(m_historyFile);
+    if (f.open(QIODevice::WriteOnly) && m_history.save(&f) && f.commit())
+        return;
+    qCWarning(LogSystem) << "WARNING: could not save the quick-launch history to" << m_historyFile;
+}
+
 void QuickLauncher::timerEvent(QTimerEvent *te)
 {
     if (te && te->timerId() == m_idleTimerId) {
@@ -138,20 +340,42 @@ void QuickLauncher::rebuild()
     if (m_shuttingDown)
         return;
 
+    // the pool only shrinks while the memory is low. reclaim() will take care of that
+    if (isUnderMemoryPressure())
+        return;
+    if (m_refillHoldOffEnd && (m_uptime.elapsed() < m_refillHoldOffEnd)) {
+        triggerRebuild(int(m_refillHoldOffEnd - m_uptime.elapsed()));
+        return;
+    }
+    m_refillHoldOffEnd = 0;
+
+    // as long as the system is not idle, we only start one quick-launcher at a time
+    const bool busy = m_idleCpu && !m_isIdle;
+    const int concurrency = busy ? 1 : m_maximumConcurrentStarts;
+    int containersCreated = 0;
     int todo = 0;
-    int done = 0;
+    bool failed = false;
 
     for (auto entry = m_quickLaunchPool.begin(); entry != m_quickLaunchPool.end(); ++entry) {
-        if (entry->m_containersAndRuntimes.size() < entry->m_maximum) {
-            todo += (entry->m_maximum - entry->m_containersAndRuntimes.size());
-            if (done >= 1)
-                continue;
+        // the adaptive targets might have shrunk since the last rebuild
+        while (entry->m_containersAndRuntimes.size() > entry->m_target) {
+            qCDebug(LogSystem).noquote() << "Releasing an unneeded entry from the quick-launch pool:"
+                                         << entry->m_containerId << "/"
+                                         << (entry->m_runtimeId.isEmpty() ? qSL("(no runtime)") : entry->m_runtimeId);
+            releaseEntry(entry->m_containersAndRuntimes.takeLast());
+        }
+
+        while (entry->m_containersAndRuntimes.size() < entry->m_target) {
+            // containers without a runtime are created synchronously, so they are not pending
+            if ((m_pendingStarts.size() + containersCreated) >= concurrency)
+                break;
 
             QScopedPointer<AbstractContainer> ac(ContainerFactory::instance()->create(entry->m_containerId, nullptr));
             if (!ac) {
                 qCWarning(LogSystem) << "ERROR: Could not create quick-launch container with id"
                                      << entry->m_containerId;
-                continue;
+                failed = true;
+                break;
             }
 
             QScopedPointer<AbstractRuntime> ar;
@@ -161,32 +385,174 @@ void QuickLauncher::rebuild()
                     qCWarning(LogSystem) << "ERROR: Could not create quick-launch runtime with id"
                                          << entry->m_runtimeId << "within container with id"
                                          << entry->m_containerId;
-                    continue;
+                    failed = true;
+                    break;
                 }
                 if (!ar->start()) {
                     qCWarning(LogSystem) << "ERROR: Could not start quick-launch runtime with id"
                                          << entry->m_runtimeId << "within container with id"
                                          << entry->m_containerId;
-                    continue;
+                    failed = true;
+                    break;
                 }
             }
             AbstractContainer *container = ar ? ar.data()->container() : ac.take();
             AbstractRuntime *runtime = ar.take();
 
             connect(container, &AbstractContainer::destroyed, this, [this, container]() { removeEntry(container, nullptr); });
-            if (runtime)
+            if (runtime) {
                 connect(runtime, &AbstractRuntime::destroyed, this, [this, runtime]() { removeEntry(nullptr, runtime); });
+                addPendingStart(runtime);
+            } else {
+                ++containersCreated;
+            }
 
             entry->m_containersAndRuntimes << qMakePair(container, runtime);
-            ++done;
 
             qCDebug(LogSystem).noquote() << "Added a new entry to the quick-launch pool:"
                                          << entry->m_containerId << "/"
                                          << (entry->m_runtimeId.isEmpty() ? qSL("(no runtime)") : entry->m_runtimeId);
         }
+        todo += qMax(0, entry->m_target - entry->m_containersAndRuntimes.size());
     }
-    if (todo > done)
+    emit occupancyChanged();
+
+    // finished pending starts will trigger the next rebuild by themselves
+    if (failed)
         triggerRebuild(1000);
+    else if (todo && m_pendingStarts.isEmpty())
+        triggerRebuild(busy ? 1000 : 0);
+}
+
+void QuickLauncher::addPendingStart(AbstractRuntime *runtime)
+{
+    const quint64 startId = ++m_lastStartId;
+    m_pendingStarts.insert(runtime, qMakePair(startId, m_uptime.elapsed()));
+
+    connect(runtime, &AbstractRuntime::readyForQuickLaunch,
+            this, [this, runtime]() { finishPendingStart(runtime, true); });
+
+    // not all runtimes are able to tell us when they are ready
+    QTimer::singleShot(PendingStartTimeout, this, [this, runtime, startId]() {
+        auto it = m_pendingStarts.constFind(runtime);
+        if ((it != m_pendingStarts.cend()) && (it->first == startId))
+            finishPendingStart(runtime, false);
+    });
+}
+
+void QuickLauncher::finishPendingStart(AbstractRuntime *runtime, bool ready)
+{
+    auto it = m_pendingStarts.find(runtime);
+    if (it == m_pendingStarts.end())
+        return;
+
+    if (ready) {
+        m_lastRefillLatency = int(m_uptime.elapsed() - it->second);
+        ++m_refillCount;
+        m_averageRefillLatency += (m_lastRefillLatency - m_averageRefillLatency) / m_refillCount;
+        qCDebug(LogSystem) << "Quick-launch runtime" << runtime << "is ready after" << m_lastRefillLatency << "msec";
+        emit refillLatencyChanged();
+    }
+    m_pendingStarts.erase(it);
+    emit occupancyChanged();
+
+    if (!m_shuttingDown)
+        triggerRebuild((m_idleCpu && !m_isIdle) ? 1000 : 0);
+}
+
+void QuickLauncher::setMaximumConcurrentStarts(int maximumConcurrentStarts)
+{
+    m_maximumConcurrentStarts = qMax(1, maximumConcurrentStarts);
+}
+
+void QuickLauncher::reclaim()
+{
+    // Idle containers without a runtime do not hold on to any noteworthy amount of memory, so
+    // only runtimes are released: the ones that are still starting up first, because they are
+    // not usable yet, but their memory usage is still growing. The ready ones are then released
+    // in the order of their estimated value, which is the demand for their container/runtime
+    // combination spread over all the ready launchers of that combination. On low pressure, the
+    // single most valuable launcher is kept.
+    if (m_shuttingDown)
+        return;
+
+    const int phase = currentPhase();
+    QuickLaunchEntry *victimEntry = nullptr;
+    int victimIndex = -1;
+    qreal victimValue = 0;
+    int readyRuntimes = 0;
+
+    for (auto entry = m_quickLaunchPool.begin(); entry != m_quickLaunchPool.end(); ++entry) {
+        int entryReady = 0;
+        for (const auto &car : qAsConst(entry->m_containersAndRuntimes)) {
+            if (car.second && !m_pendingStarts.contains(car.second))
+                ++entryReady;
+        }
+        readyRuntimes += entryReady;
+
+        for (int i = 0; i < entry->m_containersAndRuntimes.size(); ++i) {
+            AbstractRuntime *runtime = entry->m_containersAndRuntimes.at(i).second;
+            if (!runtime)
+                continue;
+
+            qreal value = -1;
+            if (!m_pendingStarts.contains(runtime)) {
+                value = (m_history.demand(historyKey(*entry), phase) + 1) / entryReady;
+                // it already did some work for the app that will most likely be started next
+                if (m_preloads.contains(runtime))
+                    value *= 2;
+            }
+            if (!victimEntry || (value < victimValue)) {
+                victimEntry = entry;
+                victimIndex = i;
+                victimValue = value;
+            }
+        }
+    }
+
+    if (!victimEntry)
+        return;
+    if ((m_memoryPressure->pressure() == MemoryPressureTracker::LowPressure) && (victimValue >= 0)
+            && (readyRuntimes <= 1)) {
+        return;
+    }
+
+    qCDebug(LogSystem).noquote() << "Releasing an entry from the quick-launch pool due to memory pressure:"
+                                 << victimEntry->m_containerId << "/" << victimEntry->m_runtimeId
+                                 << ((victimValue < 0) ? "(pending)" : "");
+    releaseEntry(victimEntry->m_containersAndRuntimes.takeAt(victimIndex));
+    emit occupancyChanged();
+}
+
+int QuickLauncher::poolSize() const
+{
+    int size = 0;
+    for (const auto &entry : m_quickLaunchPool)
+        size += entry.m_target;
+    return size;
+}
+
+int QuickLauncher::occupancy() const
+{
+    int ready = 0;
+    for (const auto &entry : m_quickLaunchPool)
+        ready += entry.m_containersAndRuntimes.size();
+    return ready - m_pendingStarts.size();
+}
+
+int QuickLauncher::pendingStarts() const
+{
+    return m_pendingStarts.size();
+}
+
+int QuickLauncher::lastRefillLatency() const
+{
+    return m_lastRefillLatency;
+}
+
+qreal QuickLauncher::averageRefillLatency() const
+{
+    return m_averageRefillLatency;
 }
 
 void QuickLauncher::triggerRebuild(int delay)
@@ -194,6 +560,19 @@ void QuickLauncher::triggerRebuild(int delay)
     QTimer::singleShot(delay, this, &QuickLauncher::rebuild);
 }
 
+void QuickLauncher::releaseEntry(const QPair<AbstractContainer *, AbstractRuntime *> &car)
+{
+    car.first->disconnect(this);
+    if (car.second) {
+        car.second->disconnect(this);
+        m_pendingStarts.remove(car.second);
+        m_preloads.remove(car.second);
+        car.second->stop();
+    } else {
+        car.first->deleteLater();
+    }
+}
+
 void QuickLauncher::removeEntry(AbstractContainer *container, AbstractRuntime *runtime)
 {
     int carCount = 0;
@@ -206,12 +585,20 @@ void QuickLauncher::removeEntry(AbstractContainer *container, AbstractRuntime *r
                     || (runtime && car.second == runtime)) {
                 qCDebug(LogSystem) << "Removed quicklaunch entry for container/runtime" << container << runtime;
 
+                // the refill will not be triggered by this pending start anymore
+                if (car.second && m_pendingStarts.remove(car.second) && !m_shuttingDown)
+                    triggerRebuild(1000);
+                if (car.second)
+                    m_preloads.remove(car.second);
                 entry->m_containersAndRuntimes.removeAt(i--);
                 carRemoved++;
             }
             carCount += entry->m_containersAndRuntimes.count();
         }
     }
+    if (carRemoved > 0)
+        emit occupancyChanged();
+
     // make sure to only emit shutDownFinished once: when the list gets empty for the first time.
     // (removeEntry could be called again afterwards and it wouldn't actually remove anything, but
     // without this guard, it would emit the signal multiple times)
@@ -219,10 +606,14 @@ void QuickLauncher::removeEntry(AbstractContainer *container, AbstractRuntime *r
         emit shutDownFinished();
 }
 
-QPair<AbstractContainer *, AbstractRuntime *> QuickLauncher::take(const QString &containerId, const QString &runtimeId)
+QPair<AbstractContainer *, AbstractRuntime *> QuickLauncher::take(const QString &containerId, const QString &runtimeId,
+                                                                  const QString &appId)
 {
     QPair<AbstractContainer *, AbstractRuntime *> result(nullptr, nullptr);
 
+    // the entry that should have served this request, used for the launch history
+    const QuickLaunchEntry *demandEntry = nullptr;
+
     // 1st pass: find entry with matching container and runtime
     // 2nd pass: find entry with matching container and no runtime
     for (int pass = 1; pass <= 2; ++pass) {
@@ -230,11 +621,36 @@ QPair<AbstractContainer *, AbstractRuntime *> QuickLauncher::take(const QString
             if (entry->m_containerId == containerId) {
                 if (((pass == 1) && (entry->m_runtimeId == runtimeId))
                         || ((pass == 2) && (entry->m_runtimeId.isEmpty()))) {
+                    if (!demandEntry)
+                        demandEntry = entry;
+
                     if (!entry->m_containersAndRuntimes.isEmpty()) {
-                        result = entry->m_containersAndRuntimes.takeFirst();
+                        // prefer the launcher that was preloaded for this app, then the ones that
+                        // have not been preloaded for any other app
+                        int index = 0;
+                        int bestMatch = -1;
+                        for (int i = 0; i < entry->m_containersAndRuntimes.size(); ++i) {
+                            const QString preloadedId = m_preloads.value(entry->m_containersAndRuntimes.at(i).second);
+                            const int match = (preloadedId.isEmpty() ? 1 : 0) + ((preloadedId == appId) ? 2 : 0);
+                            if (match > bestMatch) {
+                                bestMatch = match;
+                                index = i;
+                            }
+                        }
+
+                        result = entry->m_containersAndRuntimes.takeAt(index);
                         result.first->disconnect(this);
-                        if (result.second)
+                        if (result.second) {
                             result.second->disconnect(this);
+                            m_pendingStarts.remove(result.second);
+                            const QString preloadedId = m_preloads.take(result.second);
+                            if (!preloadedId.isEmpty()) {
+                                qCDebug(LogSystem) << "Using a quick-launcher that was preloaded for"
+                                                   << preloadedId << "to start" << appId;
+                            }
+                        }
+                        emit occupancyChanged();
+                        demandEntry = entry;
                         triggerRebuild();
 
                         pass = 2;
@@ -245,17 +661,62 @@ QPair<AbstractContainer *, AbstractRuntime *> QuickLauncher::take(const QString
         }
     }
 
+    if (demandEntry)
+        recordTake(*demandEntry, result.first != nullptr);
+
     return result;
 }
 
-void QuickLauncher::shutDown()
+bool QuickLauncher::preload(const QString &containerId, Application *app)
+{
+    if (!app || m_shuttingDown)
+        return false;
+
+    const QString appId = app->id();
+    const QString runtimeId = app->nonAliasedInfo()->runtimeName();
+
+    for (auto entry = m_quickLaunchPool.cbegin(); entry != m_quickLaunchPool.cend(); ++entry) {
+        if ((entry->m_containerId != containerId) || (entry->m_runtimeId != runtimeId))
+            continue;
+
+        // if no idle launcher is left, one that was preloaded for another app is re-used
+        AbstractRuntime *candidate = nullptr;
+        for (const auto &car : entry->m_containersAndRuntimes) {
+            AbstractRuntime *runtime = car.second;
+            if (!runtime || m_pendingStarts.contains(runtime))
+                continue;
+
+            const QString preloadedId = m_preloads.value(runtime);
+            if (preloadedId == appId)
+                return true;
+            if (preloadedId.isEmpty()) {
+                candidate = runtime;
+                break;
+            }
+            if (!candidate)
+                candidate = runtime;
+        }
+        if (candidate && candidate->preloadApplication(app)) {
+            qCDebug(LogSystem) << "Preloading application" << appId << "in quick-launcher" << candidate;
+            m_preloads.insert(candidate, appId);
+            return true;
+        }
+    }
+    return false;
+}
+
+void QuickLauncher::shutDown(StopCoordinator *coordinator)
 {
     m_shuttingDown = true;
+    if (m_adaptive)
+        saveHistory();
     bool waitForRemove = false;
 
     for (auto entry = m_quickLaunchPool.begin(); entry != m_quickLaunchPool.end(); ++entry) {
         for (const auto &car : qAsConst(entry->m_containersAndRuntimes)) {
-            if (car.second)
+            if (car.second && coordinator)
+                coordinator->addRuntime(car.second, qSL("quick-launcher: ") + entry->m_runtimeId);
+            else if (car.second)
                 car.second->stop();
             else if (car.first)
                 car.first->deleteLater();
@@ -45,33 +45,77 @@
 #include <QObject>
 #include <QPair>
 #include <QVector>
+#include <QMap>
+#include <QHash>
+#include <QElapsedTimer>
 #include <QtAppManCommon/global.h>
+#include <QtAppManManager/quicklaunchhistory.h>
+
+QT_FORWARD_DECLARE_CLASS(QQmlEngine)
+QT_FORWARD_DECLARE_CLASS(QJSEngine)
 
 QT_BEGIN_NAMESPACE_AM
 
 class AbstractContainer;
 class AbstractRuntime;
+class Application;
 class CpuReader;
+class MemoryPressureTracker;
+class StopCoordinator;
 
 class QuickLauncher : public QObject
 {
     Q_OBJECT
+    Q_CLASSINFO("AM-QmlType", "QtApplicationManager.SystemUI/QuickLauncher 2.0 SINGLETON")
+    Q_PROPERTY(int poolSize READ poolSize NOTIFY occupancyChanged)
+    Q_PROPERTY(int occupancy READ occupancy NOTIFY occupancyChanged)
+    Q_PROPERTY(int pendingStarts READ pendingStarts NOTIFY occupancyChanged)
+    Q_PROPERTY(int lastRefillLatency READ lastRefillLatency NOTIFY refillLatencyChanged)
+    Q_PROPERTY(qreal averageRefillLatency READ averageRefillLatency NOTIFY refillLatencyChanged)
 
 public:
     static QuickLauncher *instance();
+    static QObject *instanceForQml(QQmlEngine *qmlEngine, QJSEngine *);
     ~QuickLauncher() override;
 
     void initialize(int runtimesPerContainer, qreal idleLoad = 0);
 
-    QPair<AbstractContainer *, AbstractRuntime *> take(const QString &containerId, const QString &runtimeId);
+    // Instead of keeping runtimesPerContainer quick-launchers ready for every container/runtime
+    // combination, the targets are derived from the persisted launch history. Needs to be
+    // called before initialize().
+    void enableAdaptiveSizing(const QString &historyFile, int memoryBudget, int memoryPerRuntime);
+
+    // how many quick-launchers can be starting up in parallel, while the system is idle
+    void setMaximumConcurrentStarts(int maximumConcurrentStarts);
+
+    // The pool is shrunk, while the system memory usage is above lowThreshold (in percent) and
+    // no new quick-launchers are started until it has fallen below this threshold again.
+    void enableMemoryPressureHandling(qreal lowThreshold, qreal criticalThreshold);
+
+    int poolSize() const;
+    int occupancy() const;
+    int pendingStarts() const;
+    int lastRefillLatency() const;
+    qreal averageRefillLatency() const;
+
+    // Entries that have been preloaded for appId are preferred. If appId is not given, entries
+    // that have not been preloaded for another app are preferred.
+    QPair<AbstractContainer *, AbstractRuntime *> take(const QString &containerId, const QString &runtimeId,
+                                                       const QString &appId = QString());
+
+    // Asks an idle quick-launcher to preload app, because it will most likely be started next
+    bool preload(const QString &containerId, Application *app);
 
-    void shutDown();
+    // If a coordinator is given, the runtimes are stopped together with the ones it already has
+    void shutDown(StopCoordinator *coordinator = nullptr);
 
 public slots:
     void rebuild();
 
 signals:
     void shutDownFinished();
+    void occupancyChanged();
+    void refillLatencyChanged();
 
 protected:
     void timerEvent(QTimerEvent *te) override;
@@ -84,21 +128,59 @@ private:
 
     void triggerRebuild(int delay = 0);
     void removeEntry(AbstractContainer *container, AbstractRuntime *runtime);
+    void releaseEntry(const QPair<AbstractContainer *, AbstractRuntime *> &car);
+    void addPendingStart(AbstractRuntime *runtime);
+    void finishPendingStart(AbstractRuntime *runtime, bool ready);
+
+    bool isUnderMemoryPressure() const;
+    void reclaim();
 
     struct QuickLaunchEntry
     {
         QString m_containerId;
         QString m_runtimeId;
         int m_maximum = 1;
+        int m_target = 1;
         QList<QPair<AbstractContainer *, AbstractRuntime *>> m_containersAndRuntimes;
     };
 
     QVector<QuickLaunchEntry> m_quickLaunchPool;
+
+    // the launch history is bucketed into phases, based on the time since initialize()
+    int currentPhase() const;
+    static QuickLaunchHistory::Key historyKey(const QuickLaunchEntry &entry);
+
+    void recordTake(const QuickLaunchEntry &entry, bool hit);
+    void updateTargets();
+    void loadHistory();
+    void saveHistory();
+
+    bool m_adaptive = false;
+    QString m_historyFile;
+    int m_memoryBudget = 0;
+    int m_memoryPerRuntime = 0;
+    QuickLaunchHistory m_history;
+    bool m_historySavePending = false;
+    QElapsedTimer m_uptime;
+
     int m_idleTimerId = 0;
     CpuReader *m_idleCpu = nullptr;
     bool m_isIdle = false;
     qreal m_idleThreshold;
     bool m_shuttingDown = false;
+
+    // quick-launchers that have been started, but did not report back yet: id and start time
+    QHash<AbstractRuntime *, QPair<quint64, qint64>> m_pendingStarts;
+    // quick-launchers that are preloading an application: the application's id
+    QHash<AbstractRuntime *, QString> m_preloads;
+    quint64 m_lastStartId = 0;
+    int m_maximumConcurrentStarts = 1;
+    int m_lastRefillLatency = -1;
+    qreal m_averageRefillLatency = 0;
+    int m_refillCount = 0;
+
+    MemoryPressureTracker *m_memoryPressure = nullptr;
+    qint64 m_refillHoldOffEnd = 0;
 };
 
 QT_END_NAMESPACE_AM
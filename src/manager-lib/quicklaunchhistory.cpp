@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include <QIODevice>
+#include <QDataStream>
+#include <QtMath>
+
+#include <limits>
+
+#include "quicklaunchhistory.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+// the ends of the phases in msec after start-up
+static const qint64 PhaseEnds[QuickLaunchHistory::PhaseCount - 1] = { 30 * 1000, 2 * 60 * 1000, 10 * 60 * 1000 };
+
+// bump this, whenever the format of the history changes
+static const quint32 HistoryVersion = 1;
+
+// older sessions are less relevant than the current one
+static const qreal HistoryDecay = 0.9;
+
+// launches in all other phases than the current one only count partially
+static const qreal OtherPhaseWeight = 0.25;
+
+int QuickLaunchHistory::phaseAt(qint64 msecsSinceStartup)
+{
+    int phase = 0;
+    while ((phase < (PhaseCount - 1)) && (msecsSinceStartup >= PhaseEnds[phase]))
+        ++phase;
+    return phase;
+}
+
+qint64 QuickLaunchHistory::phaseEnd(int phase)
+{
+    return ((phase >= 0) && (phase < (PhaseCount - 1))) ? PhaseEnds[phase] : -1;
+}
+
+bool QuickLaunchHistory::isEmpty() const
+{
+    return m_history.isEmpty();
+}
+
+int QuickLaunchHistory::size() const
+{
+    return m_history.size();
+}
+
+void QuickLaunchHistory::recordTake(const Key &key, int phase)
+{
+    if ((phase >= 0) && (phase < PhaseCount))
+        m_history[key].m_takes[phase] += 1;
+}
+
+qreal QuickLaunchHistory::takes(const Key &key, int phase) const
+{
+    if ((phase < 0) || (phase >= PhaseCount))
+        return 0;
+    auto it = m_history.constFind(key);
+    return (it != m_history.cend()) ? it->m_takes[phase] : 0;
+}
+
+qreal QuickLaunchHistory::demand(const Key &key, int phase) const
+{
+    qreal result = 0;
+    for (int i = 0; i < PhaseCount; ++i)
+        result += takes(key, i) * ((i == phase) ? 1 : OtherPhaseWeight);
+    return result;
+}
+
+QVector<int> QuickLaunchHistory::targets(const QVector<Key> &keys, const QVector<int> &maximums,
+                                         int phase, int budget) const
+{
+    Q_ASSERT(keys.size() == maximums.size());
+
+    if (budget < 0)
+        budget = std::numeric_limits<int>::max();
+
+    QVector<qreal> demands;
+    demands.reserve(keys.size());
+    qreal totalDemand = 0;
+    int totalMaximum = 0;
+    for (int i = 0; i < keys.size(); ++i) {
+        demands << demand(keys.at(i), phase);
+        totalDemand += demands.constLast();
+        totalMaximum += maximums.at(i);
+    }
+
+    // without any history, we have to start with the configured maximum
+    const int slots = qMin(budget, totalMaximum);
+    QVector<int> result;
+    result.reserve(keys.size());
+    int used = 0;
+    for (int i = 0; i < keys.size(); ++i) {
+        int target = maximums.at(i);
+        if (totalDemand > 0)
+            target = qBound(0, qCeil(slots * demands.at(i) / totalDemand), maximums.at(i));
+        result << target;
+        used += target;
+    }
+
+    // rounding up could have exceeded the budget: take the excess from the least used entries
+    while (used > budget) {
+        int victim = -1;
+        for (int i = 0; i < result.size(); ++i) {
+            if (result.at(i) && ((victim < 0) || (demands.at(i) < demands.at(victim))))
+                victim = i;
+        }
+        if (victim < 0)
+            break;
+        --result[victim];
+        --used;
+    }
+    return result;
+}
+
+bool QuickLaunchHistory::load(QIODevice *device)
+{
+    QDataStream ds(device);
+    quint32 version = 0;
+    int count = 0;
+    ds >> version >> count;
+    if ((ds.status() != QDataStream::Ok) || (version != HistoryVersion) || (count < 0))
+        return false;
+
+    QMap<Key, Entry> history;
+    for (int i = 0; (i < count) && (ds.status() == QDataStream::Ok); ++i) {
+        Key key;
+        Entry entry;
+        ds >> key.first >> key.second;
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            ds >> entry.m_takes[phase];
+            entry.m_takes[phase] *= HistoryDecay;
+        }
+        history.insert(key, entry);
+    }
+    if (ds.status() != QDataStream::Ok)
+        return false;
+
+    m_history = history;
+    return true;
+}
+
+bool QuickLaunchHistory::save(QIODevice *device) const
+{
+    QDataStream ds(device);
+    ds << HistoryVersion << m_history.size();
+    for (auto it = m_history.cbegin(); it != m_history.cend(); ++it) {
+        ds << it.key().first << it.key().second;
+        for (int phase = 0; phase < PhaseCount; ++phase)
+            ds << it->m_takes[phase];
+    }
+    return ds.status() == QDataStream::Ok;
+}
+
+QT_END_NAMESPACE_AM
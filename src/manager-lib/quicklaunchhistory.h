@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QtAppManCommon/global.h>
+
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+
+QT_BEGIN_NAMESPACE_AM
+
+// The launch history of the quick-launch pool: how often each container/runtime combination
+// was taken from the pool, bucketed into phases based on the time since start-up. The pool
+// size for each combination is derived from this history.
+class QuickLaunchHistory
+{
+public:
+    typedef QPair<QString, QString> Key; // container id and runtime id
+
+    // users typically start a different set of applications right after boot than later on
+    enum { PhaseCount = 4 };
+    static int phaseAt(qint64 msecsSinceStartup);
+    static qint64 phaseEnd(int phase); // -1 for the last phase
+
+    bool isEmpty() const;
+    int size() const;
+
+    void recordTake(const Key &key, int phase);
+    qreal takes(const Key &key, int phase) const;
+    qreal demand(const Key &key, int phase) const;
+
+    // Distributes the budget (a number of runtimes, or -1 for no limit) over the given entries,
+    // proportional to their demand in phase, but never more than their respective maximum.
+    // Without any history, the maximums are used as targets.
+    QVector<int> targets(const QVector<Key> &keys, const QVector<int> &maximums, int phase,
+                         int budget = -1) const;
+
+    // Older sessions are less relevant than the current one: loading decays the history.
+    // Both return false on I/O errors, loading also for incompatible or corrupt data.
+    bool load(QIODevice *device);
+    bool save(QIODevice *device) const;
+
+private:
+    struct Entry
+    {
+        qreal m_takes[PhaseCount] = { };
+    };
+    QMap<Key, Entry> m_history;
+};
+
+QT_END_NAMESPACE_AM
@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include <algorithm>
+
+#include "logging.h"
+#include "abstractruntime.h"
+#include "stopcoordinator.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+StopCoordinator::StopCoordinator(int gracePeriod, QObject *parent)
+    : QObject(parent)
+    , m_gracePeriod(qMax(0, gracePeriod))
+{
+    m_graceTimer.setSingleShot(true);
+    connect(&m_graceTimer, &QTimer::timeout, this, &StopCoordinator::escalate);
+}
+
+int StopCoordinator::gracePeriod() const
+{
+    return m_gracePeriod;
+}
+
+void StopCoordinator::addRuntime(AbstractRuntime *runtime, const QString &name)
+{
+    if (!runtime || m_started)
+        return;
+
+    auto isUsed = [this](AbstractRuntime *rt, const QString &n) {
+        return std::any_of(m_entries.cbegin(), m_entries.cend(), [rt, n](const Entry &entry) {
+            return (rt && (entry.m_runtime == rt)) || (entry.m_name == n);
+        });
+    };
+
+    // the same runtime can be referenced by an application and its aliases
+    if (isUsed(runtime, QString()))
+        return;
+
+    Entry entry;
+    entry.m_runtime = runtime;
+    entry.m_name = name;
+    for (int i = 2; isUsed(nullptr, entry.m_name); ++i)
+        entry.m_name = name + qSL(" #") + QString::number(i);
+    m_entries.append(entry);
+}
+
+void StopCoordinator::start(bool forceKill)
+{
+    if (m_started)
+        return;
+    m_started = true;
+    m_timer.start();
+
+    // connect to all runtimes first, since stopping a runtime might report its state synchronously
+    for (int i = 0; i < m_entries.size(); ++i) {
+        AbstractRuntime *rt = m_entries.at(i).m_runtime;
+        if (!rt) {
+            m_entries[i].m_stopTime = 0;
+            continue;
+        }
+        ++m_pending;
+        connect(rt, &AbstractRuntime::stateChanged, this, [this, i](Am::RunState newState) {
+            if (newState == Am::NotRunning)
+                onRuntimeStopped(i);
+        });
+        connect(rt, &QObject::destroyed, this, [this, i]() { onRuntimeStopped(i); });
+    }
+
+    if ((m_gracePeriod > 0) && !forceKill && m_pending)
+        m_graceTimer.start(m_gracePeriod);
+
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (AbstractRuntime *rt = m_entries.at(i).m_runtime)
+            rt->stop(forceKill);
+    }
+    checkFinished();
+}
+
+void StopCoordinator::onRuntimeStopped(int index)
+{
+    Entry &entry = m_entries[index];
+    if (entry.m_stopTime >= 0)
+        return;
+
+    entry.m_stopTime = m_timer.elapsed();
+    --m_pending;
+    qCDebug(LogSystem) << "Runtime for" << entry.m_name << "stopped after" << entry.m_stopTime << "msec"
+                       << (entry.m_killed ? "(killed)" : "");
+    checkFinished();
+}
+
+void StopCoordinator::escalate()
+{
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if ((m_entries.at(i).m_stopTime >= 0) || !m_entries.at(i).m_runtime)
+            continue;
+
+        qCWarning(LogSystem) << "WARNING: the runtime for" << m_entries.at(i).m_name << "did not stop within"
+                             << m_gracePeriod << "msec - killing it";
+        m_entries[i].m_killed = true;
+        m_entries.at(i).m_runtime->stop(true);
+    }
+}
+
+void StopCoordinator::checkFinished()
+{
+    if (!m_started || (m_pending > 0))
+        return;
+    m_started = false;
+    m_graceTimer.stop();
+
+    QVariantMap results;
+    const Entry *slowest = nullptr;
+    for (const Entry &entry : qAsConst(m_entries)) {
+        results.insert(entry.m_name, QVariantMap {
+                           { qSL("stopTime"), int(entry.m_stopTime) },
+                           { qSL("killed"), entry.m_killed }
+                       });
+        if (!slowest || (entry.m_stopTime > slowest->m_stopTime))
+            slowest = &entry;
+    }
+    if (slowest) {
+        qCDebug(LogSystem) << "Stopped" << m_entries.size() << "runtime(s) in" << m_timer.elapsed()
+                           << "msec, slowest:" << slowest->m_name << "after" << slowest->m_stopTime << "msec";
+    }
+
+    emit finished(results);
+    deleteLater();
+}
+
+QT_END_NAMESPACE_AM
@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QPointer>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QtAppManCommon/global.h>
+
+QT_BEGIN_NAMESPACE_AM
+
+class AbstractRuntime;
+
+// Stops a set of runtimes in parallel: all of them are asked to stop at the same time and every
+// runtime that is still alive after the grace period is killed. Used by
+// ApplicationManager::stopAllApplications() and when shutting down.
+class StopCoordinator : public QObject
+{
+    Q_OBJECT
+
+public:
+    // a gracePeriod of 0 disables the escalation to a forced kill
+    StopCoordinator(int gracePeriod, QObject *parent = nullptr);
+
+    int gracePeriod() const;
+
+    // name identifies the runtime in the results and log output: normally the application id
+    void addRuntime(AbstractRuntime *runtime, const QString &name);
+    void start(bool forceKill = false);
+
+signals:
+    // results maps every name to a map with the stopTime (in msec) and a killed flag
+    void finished(const QVariantMap &results);
+
+private:
+    void onRuntimeStopped(int index);
+    void escalate();
+    void checkFinished();
+
+    struct Entry
+    {
+        QPointer<AbstractRuntime> m_runtime;
+        QString m_name;
+        qint64 m_stopTime = -1;
+        bool m_killed = false;
+    };
+
+    QVector<Entry> m_entries;
+    int m_gracePeriod;
+    int m_pending = 0;
+    bool m_started = false;
+    QElapsedTimer m_timer;
+    QTimer m_graceTimer;
+};
+
+QT_END_NAMESPACE_AM
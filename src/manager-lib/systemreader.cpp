@@ -69,6 +69,7 @@ QT_END_NAMESPACE_AM
 #  include <QElapsedTimer>
 #  include <QFile>
 #  include <QSocketNotifier>
+#  include <QTimer>
 #  include <QProcess>
 #  include <QCoreApplication>
 #  if !defined(AM_HEADLESS)
@@ -84,6 +85,7 @@ QT_END_NAMESPACE_AM
 #  include <sys/ioctl.h>
 #  include <errno.h>
 #  include <stdio.h>
+#  include <algorithm>
 
 QT_BEGIN_NAMESPACE_AM
 
@@ -332,17 +334,42 @@ qreal GpuReader::readLoadValue()
 }
 
 // TODO: can we always expect cgroup FS to be mounted on /sys/fs/cgroup?
+static const QString cGroupsBaseDir = qSL("/sys/fs/cgroup/");
 static const QString cGroupsMemoryBaseDir = qSL("/sys/fs/cgroup/memory/");
 
+bool isCGroupV2()
+{
+    // only the unified hierarchy lists the available controllers in its root
+    return QFile::exists(g_systemRootDir + cGroupsBaseDir + qSL("cgroup.controllers"));
+}
+
+// returns the value of a "<key> <value>" line in memory.stat or /proc/meminfo
+static quint64 readStatValue(const QByteArray &buffer, const char *key)
+{
+    const int keyLength = int(qstrlen(key));
+    for (int i = buffer.indexOf(key); i != -1; i = buffer.indexOf(key, i + 1)) {
+        if ((i == 0) || (buffer.at(i - 1) == '\n'))
+            return ::strtoull(buffer.constData() + i + keyLength, nullptr, 10);
+    }
+    return 0;
+}
+
 MemoryReader::MemoryReader() : MemoryReader(QString())
 { }
 
 MemoryReader::MemoryReader(const QString &groupPath)
     : m_groupPath(groupPath)
+    , m_cGroupV2(isCGroupV2())
 {
-    const QString path = g_systemRootDir + cGroupsMemoryBaseDir + m_groupPath + qSL("/memory.stat");
+    QString path;
+    if (!m_cGroupV2)
+        path = g_systemRootDir + cGroupsMemoryBaseDir + m_groupPath + qSL("/memory.stat");
+    else if (m_groupPath.isEmpty()) // the v2 root group has no memory statistics
+        path = g_systemRootDir + qSL("/proc/meminfo");
+    else
+        path = g_systemRootDir + cGroupsBaseDir + m_groupPath + qSL("/memory.stat");
 
-    m_sysFs.reset(new SysFsReader(path.toLocal8Bit(), 1500));
+    m_sysFs.reset(new SysFsReader(path.toLocal8Bit(), m_cGroupV2 ? 4096 : 1500));
     if (!m_sysFs->isOpen()) {
         qCWarning(LogSystem) << "WARNING: could not read memory statistics from" << m_sysFs->fileName()
                              << "(make sure that the memory cgroup is mounted)";
@@ -364,6 +391,20 @@ MemoryReader::MemoryReader(const QString &groupPath)
 
 quint64 MemoryReader::groupLimit()
 {
+    if (m_cGroupV2) {
+        // memory.high is where the kernel starts to throttle the group, memory.max is the hard
+        // limit. Both can be "max", in which case the group is only limited by the physical RAM.
+        quint64 limit = s_totalValue;
+        if (!m_groupPath.isEmpty()) {
+            for (const QString &file : { qSL("/memory.high"), qSL("/memory.max") }) {
+                const QString path = g_systemRootDir + cGroupsBaseDir + m_groupPath + file;
+                const QByteArray ba = SysFsReader(path.toLocal8Bit(), 41).readValue().trimmed();
+                if (!ba.isEmpty() && (ba != "max"))
+                    limit = qMin(limit, quint64(::strtoull(ba, nullptr, 10)));
+            }
+        }
+        return limit;
+    }
     QString path = g_systemRootDir + cGroupsMemoryBaseDir + m_groupPath + qSL("/memory.limit_in_bytes");
     QByteArray ba = SysFsReader(path.toLocal8Bit(), 41).readValue();
     return ::strtoull(ba, nullptr, 10);
@@ -373,10 +414,16 @@ quint64 MemoryReader::readUsedValue() const
 {
     QByteArray buffer = m_sysFs->readValue();
 
-    int i = buffer.indexOf("total_rss ");
-    if (i == -1)
-        return 0;
-    return ::strtoull(buffer.data() + i + sizeof("total_rss ")-1, nullptr, 10);
+    if (!m_cGroupV2)
+        return readStatValue(buffer, "total_rss ");
+
+    if (m_groupPath.isEmpty()) {
+        const quint64 total = readStatValue(buffer, "MemTotal:");
+        const quint64 available = readStatValue(buffer, "MemAvailable:");
+        return (total > available) ? (total - available) * 1024 : 0;
+    }
+    // the equivalent of v1's total_rss: memory.current would also include the page cache
+    return readStatValue(buffer, "anon ");
 }
 
 
@@ -438,6 +485,8 @@ MemoryThreshold::MemoryThreshold(const QList<qreal> &thresholds)
 
 MemoryThreshold::~MemoryThreshold()
 {
+    if (m_eventsFd != -1)
+        QT_CLOSE(m_eventsFd);
     if (m_usageFd != -1)
         QT_CLOSE(m_usageFd);
     if (m_controlFd != -1)
@@ -467,7 +516,9 @@ bool MemoryThreshold::setEnabled(bool enabled, const QString &groupPath, MemoryR
     if (m_enabled == enabled)
         return true;
 
-    if (enabled && !m_initialized) {
+    if (enabled && !m_initialized && isCGroupV2()) {
+        return m_initialized = m_enabled = initializeCGroupV2(groupPath);
+    } else if (enabled && !m_initialized) {
         quint64 limit = groupPath.isEmpty() ? reader->totalValue() : reader->groupLimit();
         const QString cGroup = cGroupsMemoryBaseDir + groupPath;
 
@@ -518,12 +569,78 @@ bool MemoryThreshold::setEnabled(bool enabled, const QString &groupPath, MemoryR
         return false;
     } else {
         m_enabled = enabled;
-        m_notifier->setEnabled(enabled);
-
+        if (m_notifier)
+            m_notifier->setEnabled(enabled);
+        if (m_pollTimer) {
+            if (enabled)
+                m_pollTimer->start();
+            else
+                m_pollTimer->stop();
+        }
         return true;
     }
 }
 
+bool MemoryThreshold::initializeCGroupV2(const QString &groupPath)
+{
+    // There are no usage thresholds with eventfd notifications in cgroup v2, so we poll the
+    // usage. The memory.events file of a group additionally notifies us immediately, whenever
+    // the group hits its memory.high or memory.max limit.
+
+    m_reader.reset(new MemoryReader(groupPath));
+    m_limit = m_reader->groupLimit();
+    if (!m_limit) {
+        qWarning() << "Cannot determine the memory limit of cgroup" << groupPath;
+        return false;
+    }
+
+    if (!groupPath.isEmpty()) {
+        const QString eventsPath = g_systemRootDir + cGroupsBaseDir + groupPath + qSL("/memory.events");
+        m_eventsFd = QT_OPEN(eventsPath.toLocal8Bit().constData(), QT_OPEN_RDONLY);
+
+        if (m_eventsFd >= 0) {
+            ::fcntl(m_eventsFd, F_SETFD, FD_CLOEXEC);
+            // changes to cgroup files are signaled as POLLPRI
+            m_notifier = new QSocketNotifier(m_eventsFd, QSocketNotifier::Exception, this);
+            connect(m_notifier, &QSocketNotifier::activated, this, &MemoryThreshold::readEventsFile);
+            readEventsFile();
+        } else {
+            qWarning() << "Cannot open" << eventsPath;
+        }
+    }
+
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setInterval(1000);
+    connect(m_pollTimer, &QTimer::timeout, this, &MemoryThreshold::pollUsage);
+    m_pollTimer->start();
+    pollUsage();
+    return true;
+}
+
+void MemoryThreshold::readEventsFile()
+{
+    // the notification is only re-armed after the file has been read again
+    char buffer[512];
+    if ((QT_LSEEK(m_eventsFd, 0, SEEK_SET) == 0) && (QT_READ(m_eventsFd, buffer, sizeof(buffer)) > 0)
+            && m_initialized) {
+        emit thresholdTriggered();
+    }
+}
+
+void MemoryThreshold::pollUsage()
+{
+    const qreal percentUsed = qreal(m_reader->readUsedValue()) / m_limit * 100.0;
+    const int exceeded = int(std::count_if(m_thresholds.cbegin(), m_thresholds.cend(),
+                                           [percentUsed](qreal threshold) { return percentUsed >= threshold; }));
+
+    // just like the v1 eventfd, notify about crossing a threshold in either direction
+    if (exceeded != m_thresholdsExceeded) {
+        m_thresholdsExceeded = exceeded;
+        if (m_initialized)
+            emit thresholdTriggered();
+    }
+}
+
 void MemoryThreshold::readEventFd()
 {
     if (m_eventFd >= 0) {
@@ -578,14 +695,26 @@ bool MemoryWatcher::startWatching(const QString &groupPath)
 void MemoryWatcher::checkMemoryConsumption()
 {
     qreal percentUsed = m_reader->readUsedValue() / m_memLimit * 100.0;
-    bool nowMemoryCritical = (percentUsed >= m_critical);
-    bool nowMemoryLow = (percentUsed >= m_warning);
-    if (nowMemoryCritical  && !hasMemoryCriticalWarning)
+    const bool wasMemoryCritical = hasMemoryCriticalWarning;
+    const bool wasMemoryLow = hasMemoryLowWarning;
+
+    // the receivers query isMemoryLow() and isMemoryCritical(), so update the state first
+    hasMemoryCriticalWarning = (percentUsed >= m_critical);
+    hasMemoryLowWarning = (percentUsed >= m_warning);
+    if (hasMemoryCriticalWarning && !wasMemoryCritical)
         emit memoryCritical();
-    if (nowMemoryLow && !hasMemoryLowWarning)
+    if (hasMemoryLowWarning && !wasMemoryLow)
         emit memoryLow();
-    hasMemoryCriticalWarning = nowMemoryCritical;
-    hasMemoryLowWarning = nowMemoryLow;
+}
+
+bool MemoryWatcher::isMemoryLow() const
+{
+    return hasMemoryLowWarning;
+}
+
+bool MemoryWatcher::isMemoryCritical() const
+{
+    return hasMemoryCriticalWarning;
 }
 
 QMap<QByteArray, QByteArray> fetchCGroupProcessInfo(qint64 pid)
@@ -848,6 +977,16 @@ bool MemoryWatcher::startWatching(const QString &groupPath)
 void MemoryWatcher::checkMemoryConsumption()
 { }
 
+bool MemoryWatcher::isMemoryLow() const
+{
+    return false;
+}
+
+bool MemoryWatcher::isMemoryCritical() const
+{
+    return false;
+}
+
 QT_END_NAMESPACE_AM
 
 #endif // !defined(Q_OS_LINUX)
@@ -52,6 +52,7 @@
 #  include <QScopedPointer>
 #  include <QtAppManManager/sysfsreader.h>
 QT_FORWARD_DECLARE_CLASS(QSocketNotifier)
+QT_FORWARD_DECLARE_CLASS(QTimer)
 #endif
 
 QT_BEGIN_NAMESPACE_AM
@@ -120,6 +121,7 @@ private:
 #if defined(Q_OS_LINUX)
     QScopedPointer<SysFsReader> m_sysFs;
     const QString m_groupPath;
+    const bool m_cGroupV2;
 #elif defined(Q_OS_MACOS) || defined(Q_OS_IOS)
     static int s_pageSize;
 #endif
@@ -169,12 +171,23 @@ private:
 #if defined(Q_OS_LINUX)
 private slots:
     void readEventFd();
+    void readEventsFile();
+    void pollUsage();
 
 private:
+    bool initializeCGroupV2(const QString &groupPath);
+
     int m_eventFd = -1;
     int m_controlFd = -1;
     int m_usageFd = -1;
     QSocketNotifier *m_notifier = nullptr;
+
+    // cgroup v2 has no usage thresholds, so the usage is polled
+    int m_eventsFd = -1;
+    QTimer *m_pollTimer = nullptr;
+    QScopedPointer<MemoryReader> m_reader;
+    quint64 m_limit = 0;
+    int m_thresholdsExceeded = 0;
 #endif
 };
 
@@ -188,6 +201,9 @@ public:
     bool startWatching(const QString &groupPath = QString());
     void checkMemoryConsumption();
 
+    bool isMemoryLow() const;
+    bool isMemoryCritical() const;
+
 signals:
     void memoryLow();
     void memoryCritical();
@@ -203,6 +219,9 @@ private:
 };
 
 #if defined(Q_OS_LINUX)
+// Whether the cgroup file-system is mounted as the unified (v2) hierarchy
+bool isCGroupV2();
+
 // Parses the file /proc/$PID/cgroup, returning a map groupName->path
 // eg: map["memory"] == "/user.slice"
 QMap<QByteArray, QByteArray> fetchCGroupProcessInfo(qint64 pid);
@@ -0,0 +1,261 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#include "logging.h"
+#include "utilities.h"
+#include "applicationmanager.h"
+#include "application.h"
+#include "abstractruntime.h"
+#include "memorypressuretracker.h"
+#include "processreader.h"
+#include "memoryevictionpolicy.h"
+
+QT_BEGIN_NAMESPACE_AM
+
+// the time a victim gets to actually free its memory, before the next one is picked
+static const int LowPressureEvictionInterval = 3000;
+static const int CriticalPressureEvictionInterval = 1000;
+
+MemoryEvictionPolicy::MemoryEvictionPolicy(const QVariantMap &configuration, QObject *parent)
+    : QObject(parent)
+{
+    m_lowThreshold = qBound(qreal(0), configuration.value(qSL("lowThreshold")).toReal(), qreal(100));
+    m_criticalThreshold = configuration.value(qSL("criticalThreshold")).toReal();
+    if (m_criticalThreshold <= 0)
+        m_criticalThreshold = 90;
+    m_criticalThreshold = qBound(m_lowThreshold, m_criticalThreshold, qreal(100));
+
+    const QString action = configuration.value(qSL("action")).toString();
+    if (!action.isEmpty() && (action != qSL("stop")) && (action != qSL("suspend")))
+        qCWarning(LogSystem) << "WARNING: unknown memory eviction action" << action << "- using 'stop' instead";
+    m_suspend = (action == qSL("suspend"));
+
+    bool ok;
+    const int maximumSuspended = configuration.value(qSL("maximumSuspended")).toInt(&ok);
+    if (ok)
+        m_maximumSuspended = qMax(0, maximumSuspended);
+
+    m_exempt = variantToStringList(configuration.value(qSL("exempt")));
+
+    const QVariantMap priorities = configuration.value(qSL("priorities")).toMap();
+    for (auto it = priorities.cbegin(); it != priorities.cend(); ++it)
+        m_priorities.insert(it.key(), it.value().toInt());
+
+    m_uptime.start();
+}
+
+bool MemoryEvictionPolicy::isEnabled() const
+{
+    return m_lowThreshold > 0;
+}
+
+void MemoryEvictionPolicy::start()
+{
+    if (!isEnabled() || m_memoryPressure)
+        return;
+
+    ApplicationManager *am = ApplicationManager::instance();
+    connect(am, &ApplicationManager::applicationWasActivated,
+            this, &MemoryEvictionPolicy::applicationActivated);
+    connect(am, &ApplicationManager::applicationAboutToBeRemoved,
+            this, [this](const QString &id) {
+        m_activationOrder.removeOne(id);
+        m_lastActivated.remove(id);
+    });
+
+    m_memoryPressure = new MemoryPressureTracker(qSL("eviction policy"), this);
+    m_memoryPressure->setReclaimIntervals(LowPressureEvictionInterval, CriticalPressureEvictionInterval);
+    connect(m_memoryPressure, &MemoryPressureTracker::reclaimRequested, this, &MemoryEvictionPolicy::evict);
+    m_memoryPressure->start(m_lowThreshold, m_criticalThreshold);
+
+    qCDebug(LogSystem) << "Memory eviction policy enabled: low threshold" << m_lowThreshold
+                       << "%, critical threshold" << m_criticalThreshold << "%, action"
+                       << (m_suspend ? "suspend" : "stop") << ", maximum suspended" << m_maximumSuspended
+                       << ", exempt" << m_exempt;
+}
+
+void MemoryEvictionPolicy::applicationActivated(const QString &id)
+{
+    m_activationOrder.removeOne(id);
+    m_activationOrder.append(id);
+    m_lastActivated.insert(id, m_uptime.elapsed());
+}
+
+int MemoryEvictionPolicy::selectVictim(const QVector<Candidate> &candidates, bool critical,
+                                       bool *suspend) const
+{
+    // Suspending does not free any memory, so it is not an option on critical memory. It is also
+    // limited to m_maximumSuspended applications: above that, the suspended applications are
+    // stopped instead, least recently activated first.
+    bool suspending = m_suspend && !critical;
+    bool onlySuspended = false;
+    if (suspending) {
+        int suspendedCount = 0;
+        for (const Candidate &c : candidates) {
+            if (c.state == Am::Suspended)
+                ++suspendedCount;
+        }
+        if (suspendedCount >= m_maximumSuspended) {
+            suspending = false;
+            onlySuspended = true;
+        }
+    }
+
+    // the application that has been activated last is most likely the one in the foreground
+    const QString foregroundId = m_activationOrder.isEmpty() ? QString() : m_activationOrder.constLast();
+
+    auto pick = [&](bool suspendedOnly) -> int {
+        int victim = -1;
+        int victimPriority = 0;
+        int victimActivationIndex = -1;
+
+        for (int i = 0; i < candidates.size(); ++i) {
+            const Candidate &c = candidates.at(i);
+            if ((c.id == foregroundId) || m_exempt.contains(c.id))
+                continue;
+            if (suspendedOnly && (c.state != Am::Suspended))
+                continue;
+            if ((c.state != Am::Running) && ((c.state != Am::Suspended) || suspending))
+                continue;
+            if (suspending && c.inProcess)
+                continue;
+
+            const int priority = m_priorities.value(c.id, 0);
+            // applications that were never activated yield -1, so they go first
+            const int activationIndex = m_activationOrder.indexOf(c.id);
+
+            bool better = (victim < 0) || (priority < victimPriority);
+            if ((victim >= 0) && (priority == victimPriority)) {
+                better = critical ? (c.pss > candidates.at(victim).pss)
+                                  : (activationIndex < victimActivationIndex);
+            }
+            if (better) {
+                victim = i;
+                victimPriority = priority;
+                victimActivationIndex = activationIndex;
+            }
+        }
+        return victim;
+    };
+
+    int victim = pick(onlySuspended);
+    if ((victim < 0) && onlySuspended)
+        victim = pick(false);
+
+    if (suspend)
+        *suspend = suspending;
+    return victim;
+}
+
+void MemoryEvictionPolicy::evict()
+{
+    // One victim is picked per round, so that it has time to free its memory. Applications with a
+    // lower priority are always picked first. On low memory, the least recently activated one of
+    // these goes, since this has the least visible impact. On critical memory, the one with the
+    // highest PSS is killed instead, since this frees the most memory the fastest.
+    ApplicationManager *am = ApplicationManager::instance();
+    const MemoryPressureTracker::Pressure pressure = m_memoryPressure->pressure();
+    if (!am || am->isShuttingDown() || (pressure == MemoryPressureTracker::NoPressure))
+        return;
+
+    const bool critical = (pressure == MemoryPressureTracker::CriticalPressure);
+
+    auto readPss = [](AbstractRuntime *rt) -> quint64 {
+        // the PSS of in-process applications cannot be told apart from the application-manager's
+        if (rt->manager()->inProcess())
+            return 0;
+        ProcessReader reader;
+        reader.setProcessId(rt->applicationProcessId());
+        reader.update();
+        return quint64(reader.totalPss.load()) << 10;
+    };
+
+    QVector<Candidate> candidates;
+    QVector<AbstractRuntime *> runtimes;
+
+    const auto apps = am->applications();
+    for (AbstractApplication *app : apps) {
+        if (app->isAlias())
+            continue;
+        AbstractRuntime *rt = app->currentRuntime();
+        if (!rt)
+            continue;
+        const Am::RunState state = rt->state();
+        if ((state != Am::Running) && (state != Am::Suspended))
+            continue;
+
+        candidates.append({ app->id(), state, rt->manager()->inProcess(), critical ? readPss(rt) : 0 });
+        runtimes.append(rt);
+    }
+
+    bool suspend = false;
+    const int victim = selectVictim(candidates, critical, &suspend);
+    if (victim < 0) {
+        qCDebug(LogSystem) << "Memory eviction: no application left that could be evicted";
+        return;
+    }
+
+    const Candidate &c = candidates.at(victim);
+    AbstractRuntime *rt = runtimes.at(victim);
+    const quint64 pss = critical ? c.pss : readPss(rt);
+    const qint64 lastActivated = m_lastActivated.value(c.id, -1);
+
+    bool suspended = false;
+    if (suspend) {
+        suspended = rt->suspend();
+        if (!suspended)
+            qCDebug(LogSystem) << "Memory eviction: could not suspend" << c.id << "- stopping it instead";
+    }
+
+    qCInfo(LogSystem).nospace().noquote()
+            << "Memory eviction (" << (critical ? "critical" : "low") << " memory): "
+            << (suspended ? "suspended " : (critical ? "killing " : "stopping ")) << c.id
+            << " [priority: " << m_priorities.value(c.id, 0) << ", last activated: "
+            << ((lastActivated < 0) ? qSL("never")
+                                    : qSL("%1s ago").arg((m_uptime.elapsed() - lastActivated) / 1000))
+            << ", PSS: " << (pss >> 20) << "MB]";
+
+    if (!suspended)
+        rt->stop(critical);
+}
+
+QT_END_NAMESPACE_AM
@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:LGPL-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+** SPDX-License-Identifier: LGPL-3.0
+**
+****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QtAppManCommon/global.h>
+#include <QtAppManManager/amnamespace.h>
+
+QT_BEGIN_NAMESPACE_AM
+
+class MemoryPressureTracker;
+
+// Stops (or suspends) running applications while the system's memory usage is above the
+// configured thresholds, so that the kernel's OOM killer does not have to step in. The victims
+// are picked by their configured priority first: on low memory the least recently activated
+// application goes first, while on critical memory the one with the highest PSS is picked.
+class MemoryEvictionPolicy : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Candidate
+    {
+        QString id;
+        Am::RunState state;
+        bool inProcess;
+        quint64 pss; // only needed on critical memory
+    };
+
+    MemoryEvictionPolicy(const QVariantMap &configuration, QObject *parent = nullptr);
+
+    bool isEnabled() const;
+    void start();
+
+    void applicationActivated(const QString &id);
+
+    // Returns the index of the candidate to evict (or -1) and whether it should be suspended
+    // instead of being stopped.
+    int selectVictim(const QVector<Candidate> &candidates, bool critical, bool *suspend) const;
+
+private:
+    void evict();
+
+    qreal m_lowThreshold = 0;
+    qreal m_criticalThreshold = 0;
+    bool m_suspend = false;
+    int m_maximumSuspended = 3;
+    QStringList m_exempt;
+    QHash<QString, int> m_priorities;
+
+    QElapsedTimer m_uptime;
+    QStringList m_activationOrder; // least recently activated first
+    QHash<QString, qint64> m_lastActivated; // relative to m_uptime
+
+    MemoryPressureTracker *m_memoryPressure = nullptr;
+};
+
+QT_END_NAMESPACE_AM
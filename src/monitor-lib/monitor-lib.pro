@@ -20,6 +20,7 @@ HEADERS += \
     gpustatus.h \
     iostatus.h \
     memorystatus.h \
+    memoryevictionpolicy.h \
     monitormodel.h \
     processreader.h \
     processstatus.h \
@@ -30,6 +31,7 @@ SOURCES += \
     gpustatus.cpp \
     iostatus.cpp \
     memorystatus.cpp \
+    memoryevictionpolicy.cpp \
     monitormodel.cpp \
     processreader.cpp \
     processstatus.cpp \
@@ -137,6 +137,7 @@ enum Command {
     StopAllApplications,
     ListApplications,
     ShowApplication,
+    ShowLaunchStatistics,
     InstallPackage,
     RemovePackage,
     ListInstallationTasks,
@@ -157,6 +158,7 @@ static struct {
     { StopAllApplications,  "stop-all-applications",  "Stop all applications." },
     { ListApplications, "list-applications", "List all installed applications." },
     { ShowApplication,  "show-application",  "Show application meta-data." },
+    { ShowLaunchStatistics, "show-launch-statistics", "Show the launch timing statistics of an application." },
     { InstallPackage,   "install-package",   "Install a package." },
     { RemovePackage,    "remove-package",    "Remove a package." },
     { ListInstallationTasks,     "list-installation-tasks",     "List all active installation tasks." },
@@ -188,6 +190,7 @@ static void stopApplication(const QString &appId, bool forceKill = false) Q_DECL
 static void stopAllApplications() Q_DECL_NOEXCEPT_EXPR(false);
 static void listApplications() Q_DECL_NOEXCEPT_EXPR(false);
 static void showApplication(const QString &appId, bool asJson = false) Q_DECL_NOEXCEPT_EXPR(false);
+static void showLaunchStatistics(const QString &appId, bool asJson = false) Q_DECL_NOEXCEPT_EXPR(false);
 static void installPackage(const QString &package, const QString &location, bool acknowledge) Q_DECL_NOEXCEPT_EXPR(false);
 static void removePackage(const QString &package, bool keepDocuments, bool force) Q_DECL_NOEXCEPT_EXPR(false);
 static void listInstallationTasks() Q_DECL_NOEXCEPT_EXPR(false);
@@ -379,6 +382,19 @@ int main(int argc, char *argv[])
                                  clp.isSet(qSL("json"))));
             break;
 
+        case ShowLaunchStatistics:
+            clp.addOption({ qSL("json"), qSL("Output in JSON format instead of YAML.") });
+            clp.addPositionalArgument(qSL("application-id"), qSL("The id of an installed application."));
+            clp.process(a);
+
+            if (clp.positionalArguments().size() != 2)
+                clp.showHelp(1);
+
+            a.runLater(std::bind(showLaunchStatistics,
+                                 clp.positionalArguments().at(1),
+                                 clp.isSet(qSL("json"))));
+            break;
+
         case InstallPackage:
             clp.addOption({ { qSL("l"), qSL("location") }, qSL("Set a custom installation location."), qSL("installation-location"), qSL("internal-0") });
             clp.addOption({ { qSL("a"), qSL("acknowledge") }, qSL("Automatically acknowledge the installation (unattended mode).") });
@@ -599,6 +615,21 @@ void showApplication(const QString &appId, bool asJson) Q_DECL_NOEXCEPT_EXPR(fal
     qApp->quit();
 }
 
+void showLaunchStatistics(const QString &appId, bool asJson) Q_DECL_NOEXCEPT_EXPR(false)
+{
+    dbus.connectToManager();
+
+    auto reply = dbus.manager()->launchStatistics(appId);
+    reply.waitForFinished();
+    if (reply.isError())
+        throw Exception(Error::IO, "failed to get launch statistics via DBus: %1").arg(reply.error().message());
+
+    QVariant statistics = convertFromDBusVariant(reply.value());
+    fprintf(stdout, "%s\n", asJson ? QJsonDocument::fromVariant(statistics).toJson().constData()
+                                   : QtYaml::yamlFromVariantDocuments({ statistics }).constData());
+    qApp->quit();
+}
+
 void installPackage(const QString &package, const QString &location, bool acknowledge) Q_DECL_NOEXCEPT_EXPR(false)
 {
     QString packageFile = package;
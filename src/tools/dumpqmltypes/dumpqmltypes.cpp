@@ -36,6 +36,8 @@
 #include <QtAppManManager/application.h>
 #include <QtAppManManager/abstractruntime.h>
 #include <QtAppManManager/abstractcontainer.h>
+#include <QtAppManManager/launchstatistics.h>
+#include <QtAppManManager/quicklauncher.h>
 #include <QtAppManManager/notificationmanager.h>
 #include <QtAppManNotification/notification.h>
 #include <QtAppManManager/notificationmanager.h>
@@ -73,6 +75,8 @@ static const QVector<const QMetaObject *> all = {
     &ApplicationManager::staticMetaObject,
     &ApplicationInstaller::staticMetaObject,
     &NotificationManager::staticMetaObject,
+    &LaunchStatistics::staticMetaObject,
+    &QuickLauncher::staticMetaObject,
     &ApplicationIPCManager::staticMetaObject,
     &AbstractApplication::staticMetaObject,
     &AbstractRuntime::staticMetaObject,
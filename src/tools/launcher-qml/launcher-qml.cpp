@@ -61,6 +61,9 @@
 #include <qplatformdefs.h>
 
 #include <QtAppManLauncher/launchermain.h>
+#if defined(Q_OS_LINUX)
+#  include <QtAppManLauncher/zygoteserver.h>
+#endif
 
 #if !defined(AM_HEADLESS)
 #  include <QGuiApplication>
@@ -103,8 +106,47 @@
 QT_USE_NAMESPACE_AM
 
 
+static void registerQmlTypes()
+{
+    static bool registered = false;
+    if (registered)
+        return;
+    registered = true;
+
+#if !defined(AM_HEADLESS)
+    qmlRegisterType<ApplicationManagerWindow>("QtApplicationManager.Application", 2, 0, "ApplicationManagerWindow");
+#endif
+    qmlRegisterType<QmlNotification>("QtApplicationManager", 2, 0, "Notification");
+    qmlRegisterType<QmlApplicationInterfaceExtension>("QtApplicationManager.Application", 2, 0, "ApplicationInterfaceExtension");
+
+    // monitor-lib
+    qmlRegisterType<CpuStatus>("QtApplicationManager", 2, 0, "CpuStatus");
+    qmlRegisterType<FrameTimer>("QtApplicationManager", 2, 0, "FrameTimer");
+    qmlRegisterType<GpuStatus>("QtApplicationManager", 2, 0, "GpuStatus");
+    qmlRegisterType<IoStatus>("QtApplicationManager", 2, 0, "IoStatus");
+    qmlRegisterType<MemoryStatus>("QtApplicationManager", 2, 0, "MemoryStatus");
+    qmlRegisterType<MonitorModel>("QtApplicationManager", 2, 0, "MonitorModel");
+}
+
 int main(int argc, char *argv[])
 {
+#if defined(Q_OS_LINUX)
+    if (const char *zygoteSocketPath = ZygoteServer::socketPathFromArguments(argc, argv)) {
+        // Everything done before forking is shared copy-on-write between all children. This
+        // has to stop short of constructing the Q*Application though: the connection to the
+        // Wayland compositor cannot be shared. The QML engine, the fonts and the scene graph
+        // all need the application object or threads (which do not survive a fork), so they
+        // cannot be warmed up here either.
+        ZygoteServer::preloadLibraries();
+        registerQmlTypes();
+
+        int result = ZygoteServer::run(zygoteSocketPath, argc, argv);
+        if (result >= 0)
+            return result;
+        // we are a forked child now, with a new command line and environment
+    }
+#endif
+
     StartupTimer::instance()->checkpoint("entered main");
 
     QCoreApplication::setApplicationName(qSL("ApplicationManager QML Launcher"));
@@ -177,19 +219,7 @@ Controller::Controller(LauncherMain *a, bool quickLaunched, const QString &direc
     connect(&m_engine, &QObject::destroyed, a, &QCoreApplication::quit);
     CrashHandler::setQmlEngine(&m_engine);
 
-#if !defined(AM_HEADLESS)
-    qmlRegisterType<ApplicationManagerWindow>("QtApplicationManager.Application", 2, 0, "ApplicationManagerWindow");
-#endif
-    qmlRegisterType<QmlNotification>("QtApplicationManager", 2, 0, "Notification");
-    qmlRegisterType<QmlApplicationInterfaceExtension>("QtApplicationManager.Application", 2, 0, "ApplicationInterfaceExtension");
-
-    // monitor-lib
-    qmlRegisterType<CpuStatus>("QtApplicationManager", 2, 0, "CpuStatus");
-    qmlRegisterType<FrameTimer>("QtApplicationManager", 2, 0, "FrameTimer");
-    qmlRegisterType<GpuStatus>("QtApplicationManager", 2, 0, "GpuStatus");
-    qmlRegisterType<IoStatus>("QtApplicationManager", 2, 0, "IoStatus");
-    qmlRegisterType<MemoryStatus>("QtApplicationManager", 2, 0, "MemoryStatus");
-    qmlRegisterType<MonitorModel>("QtApplicationManager", 2, 0, "MonitorModel");
+    registerQmlTypes();
 
     m_configuration = a->runtimeConfiguration();
 
@@ -245,6 +275,8 @@ Controller::Controller(LauncherMain *a, bool quickLaunched, const QString &direc
         m_applicationInterface = new QmlApplicationInterface(a->p2pDBusName(), a->notificationDBusName(), this);
         connect(m_applicationInterface, &QmlApplicationInterface::startApplication,
                 this, &Controller::startApplication);
+        connect(m_applicationInterface, &QmlApplicationInterface::preloadApplication,
+                this, &Controller::preloadApplication);
         if (!m_applicationInterface->initialize())
             throw Exception("Could not connect to the application manager's ApplicationInterface on the peer D-Bus");
 
@@ -264,6 +296,61 @@ Controller::Controller(LauncherMain *a, bool quickLaunched, const QString &direc
     StartupTimer::instance()->checkpoint("after application interface initialization");
 }
 
+void Controller::preloadApplication(const QString &baseDir, const QString &qmlFile,
+                                    const QVariantMap &application)
+{
+    if (m_launched || !m_quickLaunched || (qmlFile == m_preloadQmlFile))
+        return;
+
+    discardPreload();
+
+    if (!QFile::exists(qmlFile)) {
+        qCWarning(LogQmlRuntime) << "could not preload" << qmlFile << ": file does not exist";
+        return;
+    }
+
+    qCDebug(LogQmlRuntime) << "preloading" << application.value(qSL("id")).toString() << "- main:" << qmlFile;
+
+    // the import paths are needed to resolve the imports while compiling. They are the same ones
+    // that startApplication() will add, but we cannot rely on the current directory yet
+    m_preloadImportPathList = m_engine.importPathList();
+    QVariantMap runtimeParameters = qdbus_cast<QVariantMap>(application.value(qSL("runtimeParameters")));
+    QVariant imports = runtimeParameters.value(qSL("importPaths"));
+    const QVariantList vl = (imports.type() == QVariant::String) ? QVariantList{imports}
+                                                                 : qdbus_cast<QVariantList>(imports);
+    for (const QVariant &v : vl) {
+        const QString path = v.toString();
+        if (QFileInfo(path).isRelative())
+            m_engine.addImportPath(QDir(baseDir).absoluteFilePath(path));
+    }
+
+    m_preloadQmlFile = qmlFile;
+    m_preloadComponent = new QQmlComponent(&m_engine, QUrl::fromLocalFile(qmlFile),
+                                           QQmlComponent::Asynchronous, this);
+    connect(m_preloadComponent.data(), &QQmlComponent::statusChanged,
+            this, [this](QQmlComponent::Status status) {
+        if (status == QQmlComponent::Ready) {
+            qCDebug(LogQmlRuntime) << "finished preloading" << m_preloadQmlFile;
+        } else if (status == QQmlComponent::Error) {
+            // the real load() will report these errors again, if this app is started
+            qCDebug(LogQmlRuntime) << "preloading" << m_preloadQmlFile << "failed:" << m_preloadComponent->errors();
+        }
+    });
+}
+
+void Controller::discardPreload()
+{
+    if (m_preloadQmlFile.isEmpty())
+        return;
+
+    // get rid of the other app's import paths and compiled types
+    delete m_preloadComponent.data();
+    m_engine.setImportPathList(m_preloadImportPathList);
+    m_engine.trimComponentCache();
+    m_preloadQmlFile.clear();
+    m_preloadImportPathList.clear();
+}
+
 void Controller::startApplication(const QString &baseDir, const QString &qmlFile, const QString &document,
                                   const QString &mimeType, const QVariantMap &application,
                                   const QVariantMap &systemProperties)
@@ -272,8 +359,13 @@ void Controller::startApplication(const QString &baseDir, const QString &qmlFile
         return;
     m_launched = true;
 
+    const bool preloaded = !m_preloadQmlFile.isEmpty() && (m_preloadQmlFile == qmlFile);
+    if (!preloaded)
+        discardPreload();
+
     static QString applicationId = application.value(qSL("id")).toString();
     LauncherMain::instance()->setApplicationId(applicationId);
+    StartupTimer::instance()->setTraceProcessName(applicationId);
 
     if (m_quickLaunched) {
         //StartupTimer::instance()->createReport(applicationId  + qSL(" [process launch]"));
@@ -406,7 +498,15 @@ void Controller::startApplication(const QString &baseDir, const QString &qmlFile
     m_engine.rootContext()->setContextProperty(qSL("StartupTimer"), StartupTimer::instance());
     m_engine.load(qmlFileUrl);
 
-    StartupTimer::instance()->checkpoint("after engine loading main qml file");
+    if (preloaded) {
+        // the engine holds on to the compiled type, as long as the root object is alive
+        delete m_preloadComponent.data();
+        m_preloadQmlFile.clear();
+        m_preloadImportPathList.clear();
+    }
+
+    StartupTimer::instance()->checkpoint(preloaded ? "after engine loading preloaded main qml file"
+                                                   : "after engine loading main qml file");
 
     auto topLevels = m_engine.rootObjects();
 
@@ -48,6 +48,7 @@
 #include <QPointer>
 #include <QQmlIncubationController>
 #include <QQmlApplicationEngine>
+#include <QQmlComponent>
 #include <QtAppManCommon/global.h>
 
 QT_FORWARD_DECLARE_CLASS(QTimerEvent)
@@ -80,13 +81,23 @@ public slots:
     void startApplication(const QString &baseDir, const QString &qmlFile, const QString &document,
                           const QString &mimeType, const QVariantMap &application,
                           const QVariantMap &systemProperties);
+    void preloadApplication(const QString &baseDir, const QString &qmlFile,
+                            const QVariantMap &application);
 
 private:
+    void discardPreload();
+
     QQmlApplicationEngine m_engine;
     QmlApplicationInterface *m_applicationInterface = nullptr;
     QVariantMap m_configuration;
     bool m_launched = false;
     bool m_quickLaunched;
+
+    // the main component of the app that will most likely be started next: it is only compiled,
+    // but never instantiated. The engine's type cache makes sure that it is reused in load().
+    QPointer<QQmlComponent> m_preloadComponent;
+    QString m_preloadQmlFile;
+    QStringList m_preloadImportPathList;
 #if !defined(AM_HEADLESS)
     QQuickWindow *m_window = nullptr;
     QVector<QPointer<QQuickWindow>> m_allWindows;
@@ -78,6 +78,12 @@ WaylandWindow::WaylandWindow(AbstractApplication *app, WindowSurface *surf)
         m_pongTimer->setSingleShot(true);
         connect(m_pongTimer, &QTimer::timeout, this, &WaylandWindow::pongTimeout);
 
+        // a suspended application cannot answer pings
+        if (app) {
+            connect(app->nonAliased(), &AbstractApplication::runStateChanged,
+                    this, &WaylandWindow::enableOrDisablePing);
+        }
+
         connect(surf->compositor()->amExtension(), &WaylandQtAMServerExtension::windowPropertyChanged,
                 this, [this](QWaylandSurface *surface, const QString &name, const QVariant &value) {
             if (surface == m_surface) {
@@ -109,7 +115,7 @@ void WaylandWindow::pongReceived()
 
 void WaylandWindow::pongTimeout()
 {
-    if (!application())
+    if (!application() || isApplicationSuspended())
         return;
 
     qCCritical(LogGraphics) << "Stopping application" << application()->id() << "because we did not receive a Wayland-Pong for" << m_pongTimer->interval() << "msec";
@@ -155,11 +161,16 @@ void WaylandWindow::enableOrDisablePing()
         m_pingTimer->stop();
         m_pongTimer->stop();
 
-        if (m_surface && m_surface->hasContent())
+        if (m_surface && m_surface->hasContent() && !isApplicationSuspended())
             pingTimeout();
     }
 }
 
+bool WaylandWindow::isApplicationSuspended() const
+{
+    return application() && (application()->runState() == Am::Suspended);
+}
+
 void WaylandWindow::onContentStateChanged()
 {
     qCDebug(LogGraphics) << this << "of" << applicationId() << "contentState changed to" << contentState();
@@ -94,6 +94,7 @@ private:
     QString applicationId() const;
 
     void enableOrDisablePing();
+    bool isApplicationSuspended() const;
     QTimer *m_pingTimer;
     QTimer *m_pongTimer;
     WindowSurface *m_surface;
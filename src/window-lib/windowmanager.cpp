@@ -61,6 +61,7 @@
 #include "applicationmanager.h"
 #include "abstractruntime.h"
 #include "runtimefactory.h"
+#include "launchstatistics.h"
 #include "window.h"
 #include "windowitem.h"
 #include "windowmanager.h"
@@ -606,6 +607,8 @@ void WindowManager::inProcessSurfaceItemCreated(QSharedPointer<InProcessSurfaceI
         return;
     }
 
+    recordLaunchSurfaceMapped(app);
+
     //Only create a new Window if we don't have it already in the window list, as the user controls whether windows are removed or not
     int index = d->findWindowBySurfaceItem(surfaceItem.data());
     if (index == -1) {
@@ -616,6 +619,32 @@ void WindowManager::inProcessSurfaceItemCreated(QSharedPointer<InProcessSurfaceI
     }
 }
 
+/*! \internal
+    Records the launch phases of the given app, which depend on its first window surface
+*/
+void WindowManager::recordLaunchSurfaceMapped(AbstractApplication *app)
+{
+    LaunchStatistics *launchStatistics = LaunchStatistics::instance();
+    const QString appId = app->nonAliased()->id();
+    if (!launchStatistics->isLaunching(appId))
+        return;
+
+    launchStatistics->mark(appId, LaunchStatistics::SurfaceMapped);
+
+    // the next frame rendered by any of the compositor views is the first one showing the app
+    auto connections = QSharedPointer<QVector<QMetaObject::Connection>>::create();
+    for (QQuickWindow *view : qAsConst(d->views)) {
+        connections->append(connect(view, &QQuickWindow::frameSwapped, this, [appId, connections]() {
+            LaunchStatistics::instance()->mark(appId, LaunchStatistics::FirstFrame);
+            for (const auto &connection : qAsConst(*connections))
+                QObject::disconnect(connection);
+        }));
+    }
+    // without any views, there will never be a frame
+    if (d->views.isEmpty())
+        launchStatistics->mark(appId, LaunchStatistics::FirstFrame);
+}
+
 /*! \internal
     Used to create the Window objects for a surface
     This is called for both wayland and in-process surfaces
@@ -688,6 +717,9 @@ void WindowManager::waylandSurfaceMapped(WindowSurface *surface)
 
     qCDebug(LogGraphics) << "Mapping Wayland surface" << surface << "of" << d->applicationId(app, surface);
 
+    if (app)
+        recordLaunchSurfaceMapped(app);
+
     // Only create a new Window if we don't have it already in the window list, as the user controls
     // whether windows are removed or not
     int index = d->findWindowByWaylandSurface(surface->surface());
@@ -63,6 +63,7 @@ class Window;
 class WindowSurface;
 class WindowManagerPrivate;
 class Application;
+class AbstractApplication;
 class AbstractRuntime;
 class WaylandCompositor;
 
@@ -151,6 +152,7 @@ private:
     void removeWindow(Window *window);
     void releaseWindow(Window *window);
     void updateViewSlowMode(QQuickWindow *view);
+    void recordLaunchSurfaceMapped(AbstractApplication *app);
     WindowManager(QQmlEngine *qmlEngine, const QString &waylandSocketName);
     WindowManager(const WindowManager &);
     WindowManager &operator=(const WindowManager &);
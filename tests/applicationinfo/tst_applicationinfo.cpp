@@ -126,12 +126,88 @@ void tst_ApplicationInfo::database()
         try {
             QVector<AbstractApplication *> appsInDb = adb.read();
             QCOMPARE(appsInDb.size(), apps.size());
+
+            for (int i = 0; i < appsInDb.size(); ++i) {
+                const AbstractApplicationInfo *info = appsInDb.at(i)->info();
+
+                // the id is available without having to deserialize the rest
+                QVERIFY(info->isDeferred());
+                QCOMPARE(info->id(), apps.at(i)->id());
+                QCOMPARE(info->uniqueNumber(), apps.at(i)->uniqueNumber());
+                QVERIFY(info->isDeferred());
+
+                QCOMPARE(info->names(), apps.at(i)->names());
+                QVERIFY(!info->isDeferred());
+                QCOMPARE(info->toVariantMap(), apps.at(i)->toVariantMap());
+            }
+
+            // writing deferred objects back has to yield the same database again
+            QVector<AbstractApplication *> appsInDb2 = adb.read();
+            adb.write(appsInDb2);
+
+            // ... without touching the data the old, still deferred objects are referencing
+            QVERIFY(appsInDb2.constLast()->info()->isDeferred());
+            QCOMPARE(appsInDb2.constLast()->info()->toVariantMap(), apps.constLast()->toVariantMap());
+            qDeleteAll(appsInDb2);
+            appsInDb2 = adb.read();
+            QCOMPARE(appsInDb2.size(), apps.size());
+            QCOMPARE(appsInDb2.constLast()->info()->toVariantMap(), apps.constLast()->toVariantMap());
+
+            qDeleteAll(appsInDb2);
             qDeleteAll(appsInDb);
         } catch (Exception &e) {
             QVERIFY2(false, e.what());
         }
     }
 
+    {
+        QFile f(tmpDbPath);
+        QVERIFY(f.open(QFile::WriteOnly | QFile::Truncate));
+        QVERIFY(f.write("not an application database") > 0);
+    }
+
+    {
+        ApplicationDatabase adb(tmpDbPath);
+        QVERIFY(adb.isValid());
+        QVERIFY(adb.isOutdated());
+
+        try {
+            adb.read();
+            QVERIFY(false);
+        } catch (const Exception &) {
+        }
+    }
+    QFile::remove(tmpDbPath);
+
+    {
+        QString tmpDbName;
+        {
+            ApplicationDatabase adb;
+            QVERIFY(adb.isValid());
+            QVERIFY(adb.isTemporary());
+            tmpDbName = adb.name();
+
+            try {
+                adb.write(apps);
+                adb.write(apps);
+                QVector<AbstractApplication *> appsInDb = adb.read();
+                QCOMPARE(appsInDb.size(), apps.size());
+                qDeleteAll(appsInDb);
+            } catch (const Exception &e) {
+                QVERIFY2(false, e.what());
+            }
+
+            // the database has to refer to the replaced file, not to the original temporary one
+            QVERIFY(!adb.isOutdated());
+            QFile f(tmpDbName);
+            QVERIFY(f.open(QFile::WriteOnly | QFile::Truncate));
+            QVERIFY(f.write("not an application database") > 0);
+            f.close();
+            QVERIFY(adb.isOutdated());
+        }
+        QVERIFY(!QFile::exists(tmpDbName));
+    }
+
     {
 #if defined(Q_OS_WIN)
         QString nullDb(qSL("\\\\.\\NUL"));
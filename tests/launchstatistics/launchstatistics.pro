@@ -0,0 +1,10 @@
+TARGET = tst_launchstatistics
+
+include($$PWD/../tests.pri)
+
+QT *= \
+    appman_common-private \
+    appman_application-private \
+    appman_manager-private \
+
+SOURCES += tst_launchstatistics.cpp
@@ -0,0 +1,215 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore>
+#include <QtTest>
+#include <QtAppManManager/launchstatistics.h>
+
+QT_USE_NAMESPACE_AM
+
+class tst_LaunchStatistics : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_LaunchStatistics();
+
+private slots:
+    void cleanup();
+
+    void launch();
+    void firstOccurrenceOnly();
+    void notLaunching();
+    void abort();
+    void statistics();
+
+private:
+    void completeLaunch(const QString &appId, bool quickLaunched = false);
+};
+
+tst_LaunchStatistics::tst_LaunchStatistics()
+{ }
+
+void tst_LaunchStatistics::cleanup()
+{
+    delete LaunchStatistics::instance();
+}
+
+void tst_LaunchStatistics::completeLaunch(const QString &appId, bool quickLaunched)
+{
+    LaunchStatistics *ls = LaunchStatistics::instance();
+    ls->beginLaunch(appId);
+    ls->setQuickLaunched(appId, quickLaunched);
+    ls->mark(appId, LaunchStatistics::ContainerSelection);
+    ls->mark(appId, LaunchStatistics::RuntimeStart);
+    ls->mark(appId, LaunchStatistics::SurfaceMapped);
+    ls->mark(appId, LaunchStatistics::FirstFrame);
+}
+
+void tst_LaunchStatistics::launch()
+{
+    LaunchStatistics *ls = LaunchStatistics::instance();
+    QSignalSpy finishedSpy(ls, &LaunchStatistics::launchFinished);
+
+    ls->beginLaunch(qSL("app"));
+    QVERIFY(ls->isLaunching(qSL("app")));
+    ls->setQuickLaunched(qSL("app"), true);
+    ls->mark(qSL("app"), LaunchStatistics::ContainerSelection);
+    ls->mark(qSL("app"), LaunchStatistics::RuntimeStart);
+    ls->mark(qSL("app"), LaunchStatistics::SurfaceMapped);
+
+    // nothing is recorded before the first frame
+    QVERIFY(ls->applicationIds().isEmpty());
+    QVERIFY(ls->lastLaunch(qSL("app")).isEmpty());
+    QCOMPARE(finishedSpy.count(), 0);
+
+    ls->mark(qSL("app"), LaunchStatistics::FirstFrame);
+    QVERIFY(!ls->isLaunching(qSL("app")));
+    QCOMPARE(ls->applicationIds(), QStringList { qSL("app") });
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.at(0).at(0).toString(), qSL("app"));
+
+    const QVariantMap lastLaunch = ls->lastLaunch(qSL("app"));
+    QCOMPARE(finishedSpy.at(0).at(1).toMap(), lastLaunch);
+    QCOMPARE(lastLaunch.value(qSL("quickLaunched")).toBool(), true);
+    QCOMPARE(lastLaunch.keys(), (QStringList { qSL("containerSelection"), qSL("firstFrame"),
+                                               qSL("quickLaunched"), qSL("runtimeStart"),
+                                               qSL("surfaceMapped") }));
+
+    // the timestamps are relative to the start of the launch and in the order of the phases
+    const qint64 containerSelection = lastLaunch.value(qSL("containerSelection")).toLongLong();
+    const qint64 runtimeStart = lastLaunch.value(qSL("runtimeStart")).toLongLong();
+    const qint64 surfaceMapped = lastLaunch.value(qSL("surfaceMapped")).toLongLong();
+    const qint64 firstFrame = lastLaunch.value(qSL("firstFrame")).toLongLong();
+    QVERIFY(containerSelection >= 0);
+    QVERIFY(runtimeStart >= containerSelection);
+    QVERIFY(surfaceMapped >= runtimeStart);
+    QVERIFY(firstFrame >= surfaceMapped);
+}
+
+void tst_LaunchStatistics::firstOccurrenceOnly()
+{
+    LaunchStatistics *ls = LaunchStatistics::instance();
+
+    ls->beginLaunch(qSL("app"));
+    ls->mark(qSL("app"), LaunchStatistics::SurfaceMapped);
+    QThread::msleep(50);
+    // e.g. a second window of the same application
+    ls->mark(qSL("app"), LaunchStatistics::SurfaceMapped);
+    ls->mark(qSL("app"), LaunchStatistics::FirstFrame);
+
+    const QVariantMap lastLaunch = ls->lastLaunch(qSL("app"));
+    QVERIFY(lastLaunch.value(qSL("firstFrame")).toLongLong()
+            >= lastLaunch.value(qSL("surfaceMapped")).toLongLong() + 50);
+}
+
+void tst_LaunchStatistics::notLaunching()
+{
+    LaunchStatistics *ls = LaunchStatistics::instance();
+    QSignalSpy finishedSpy(ls, &LaunchStatistics::launchFinished);
+
+    // phases of applications that are not being launched (anymore) are ignored
+    ls->mark(qSL("app"), LaunchStatistics::SurfaceMapped);
+    ls->mark(qSL("app"), LaunchStatistics::FirstFrame);
+    QVERIFY(!ls->isLaunching(qSL("app")));
+    QVERIFY(ls->applicationIds().isEmpty());
+
+    completeLaunch(qSL("app"));
+    ls->mark(qSL("app"), LaunchStatistics::FirstFrame);
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(ls->statistics(qSL("app")).value(qSL("launches")).toInt(), 1);
+}
+
+void tst_LaunchStatistics::abort()
+{
+    LaunchStatistics *ls = LaunchStatistics::instance();
+
+    ls->beginLaunch(qSL("app"));
+    ls->mark(qSL("app"), LaunchStatistics::ContainerSelection);
+    ls->abortLaunch(qSL("app"));
+    QVERIFY(!ls->isLaunching(qSL("app")));
+
+    ls->mark(qSL("app"), LaunchStatistics::FirstFrame);
+    QVERIFY(ls->applicationIds().isEmpty());
+
+    // a new launch replaces one that never reached the first frame
+    ls->beginLaunch(qSL("app"));
+    ls->mark(qSL("app"), LaunchStatistics::ContainerSelection);
+    ls->setQuickLaunched(qSL("app"), true);
+    ls->beginLaunch(qSL("app"));
+    ls->mark(qSL("app"), LaunchStatistics::FirstFrame);
+
+    const QVariantMap lastLaunch = ls->lastLaunch(qSL("app"));
+    QCOMPARE(lastLaunch.keys(), (QStringList { qSL("firstFrame"), qSL("quickLaunched") }));
+    QCOMPARE(lastLaunch.value(qSL("quickLaunched")).toBool(), false);
+}
+
+void tst_LaunchStatistics::statistics()
+{
+    LaunchStatistics *ls = LaunchStatistics::instance();
+
+    QCOMPARE(ls->statistics(qSL("app")), (QVariantMap { { qSL("launches"), 0 } }));
+
+    // only the last 32 launches are kept
+    for (int i = 0; i < 40; ++i)
+        completeLaunch(qSL("app"), (i % 4) == 0);
+
+    const QVariantMap stats = ls->statistics(qSL("app"));
+    QCOMPARE(stats.value(qSL("launches")).toInt(), 32);
+    QCOMPARE(stats.value(qSL("quickLaunches")).toInt(), 8);
+    QCOMPARE(stats.value(qSL("lastLaunch")).toMap(), ls->lastLaunch(qSL("app")));
+
+    const QVariantMap phases = stats.value(qSL("phases")).toMap();
+    QCOMPARE(phases.keys(), (QStringList { qSL("containerSelection"), qSL("firstFrame"),
+                                           qSL("runtimeStart"), qSL("surfaceMapped") }));
+    for (const QVariant &phase : phases) {
+        const QVariantMap phaseStats = phase.toMap();
+        QCOMPARE(phaseStats.value(qSL("count")).toInt(), 32);
+        QVERIFY(phaseStats.value(qSL("min")).toLongLong() <= phaseStats.value(qSL("median")).toLongLong());
+        QVERIFY(phaseStats.value(qSL("median")).toLongLong() <= phaseStats.value(qSL("p90")).toLongLong());
+        QVERIFY(phaseStats.value(qSL("p90")).toLongLong() <= phaseStats.value(qSL("max")).toLongLong());
+    }
+    QCOMPARE(stats.value(qSL("timeToFirstFrame")).toMap().value(qSL("count")).toInt(), 32);
+
+    // these launches are fast enough to all end up in the first bucket
+    const QVariantMap histogram = stats.value(qSL("histogram")).toMap();
+    const QVariantList bounds = histogram.value(qSL("bounds")).toList();
+    const QVariantList counts = histogram.value(qSL("counts")).toList();
+    QCOMPARE(bounds.size() + 1, counts.size());
+    QCOMPARE(bounds.constFirst().toInt(), 100);
+    QCOMPARE(counts.constFirst().toInt(), 32);
+
+    ls->clear();
+    QVERIFY(ls->applicationIds().isEmpty());
+    QCOMPARE(ls->statistics(qSL("app")).value(qSL("launches")).toInt(), 0);
+}
+
+QTEST_APPLESS_MAIN(tst_LaunchStatistics)
+
+#include "tst_launchstatistics.moc"
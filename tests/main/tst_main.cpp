@@ -57,6 +57,7 @@ private slots:
     void installAndRemoveUpdateForBuiltIn();
     void updateForBuiltInAlreadyInstalled();
     void loadDatabaseWithUpdatedBuiltInApp();
+    void refreshDatabaseAfterManifestRemoval();
     void nonExistentMainQmlFile();
 
 private:
@@ -240,6 +241,11 @@ void tst_Main::installAndRemoveUpdateForBuiltIn()
     QCOMPARE(appMan->count(), 1);
     QCOMPARE(appMan->application(0), app);
     QCOMPARE(app->name(qSL("en")), qSL("Hello Red"));
+
+    // the id lookups have to survive the update and its removal
+    QCOMPARE(appMan->indexOfApplication(qSL("hello-world.red")), 0);
+    QCOMPARE(appMan->fromId(qSL("hello-world.red")), app);
+    QCOMPARE(appMan->fromId(qSL("hello-world.blue")), nullptr);
 }
 
 /*
@@ -289,6 +295,31 @@ void tst_Main::loadDatabaseWithUpdatedBuiltInApp()
     QCOMPARE(app->name(qSL("en")), qSL("Hello Updated Red"));
 }
 
+/*
+   Install an update for a built-in app and quit Main. Then remove the installed manifest
+   behind the application manager's back.
+
+   On next iteration of Main, the database has to be refreshed incrementally: only the
+   built-in version of the app should be left.
+ */
+void tst_Main::refreshDatabaseAfterManifestRemoval()
+{
+    initMain();
+    installPackage(qL1S(AM_TESTDATA_DIR "packages/hello-world.red.appkg"));
+    destroyMain();
+
+    QVERIFY(QDir(qSL("/tmp/am-test-main/manifests/hello-world.red")).removeRecursively());
+
+    initMain();
+
+    auto appMan = ApplicationManager::instance();
+    QCOMPARE(appMan->count(), 1);
+
+    auto app = appMan->application(0);
+    QCOMPARE(app->name(qSL("en")), qSL("Hello Red"));
+    QVERIFY(app->isBuiltIn());
+}
+
 /*
    When the "main QML file" parameter contains a relative filepath like "foo/bar.qml",
    Main should treat it as a local file (instead of a remote url) and complain that it
@@ -0,0 +1,254 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore>
+#include <QtTest>
+#include <QtAppManMonitor/memoryevictionpolicy.h>
+
+QT_USE_NAMESPACE_AM
+
+typedef MemoryEvictionPolicy::Candidate Candidate;
+
+class tst_MemoryEvictionPolicy : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_MemoryEvictionPolicy();
+
+private slots:
+    void priority();
+    void leastRecentlyActivated();
+    void highestPss();
+    void exempt();
+    void foreground();
+    void suspend();
+    void suspendLimit();
+    void noVictim();
+
+private:
+    QString victim(const MemoryEvictionPolicy &policy, const QVector<Candidate> &candidates,
+                   bool critical, bool *suspend = nullptr);
+};
+
+tst_MemoryEvictionPolicy::tst_MemoryEvictionPolicy()
+{ }
+
+QString tst_MemoryEvictionPolicy::victim(const MemoryEvictionPolicy &policy,
+                                         const QVector<Candidate> &candidates, bool critical,
+                                         bool *suspend)
+{
+    int index = policy.selectVictim(candidates, critical, suspend);
+    return (index < 0) ? QString() : candidates.at(index).id;
+}
+
+void tst_MemoryEvictionPolicy::priority()
+{
+    MemoryEvictionPolicy policy(QVariantMap { { qSL("lowThreshold"), 80 },
+                                              { qSL("priorities"), QVariantMap { { qSL("a"), 1 },
+                                                                                 { qSL("c"), -1 } } } });
+    policy.applicationActivated(qSL("a"));
+    policy.applicationActivated(qSL("b"));
+    policy.applicationActivated(qSL("c"));
+    policy.applicationActivated(qSL("fg"));
+
+    const QVector<Candidate> candidates {
+        { qSL("a"), Am::Running, false, 300 },
+        { qSL("b"), Am::Running, false, 200 },
+        { qSL("c"), Am::Running, false, 100 },
+    };
+    // the lowest priority wins over both LRU and PSS
+    QCOMPARE(victim(policy, candidates, false), qSL("c"));
+    QCOMPARE(victim(policy, candidates, true), qSL("c"));
+
+    // the highest priority goes last
+    QCOMPARE(victim(policy, candidates.mid(0, 2), false), qSL("b"));
+    QCOMPARE(victim(policy, candidates.mid(0, 2), true), qSL("b"));
+}
+
+void tst_MemoryEvictionPolicy::leastRecentlyActivated()
+{
+    MemoryEvictionPolicy policy(QVariantMap { { qSL("lowThreshold"), 80 } });
+    policy.applicationActivated(qSL("a"));
+    policy.applicationActivated(qSL("b"));
+    policy.applicationActivated(qSL("c"));
+    policy.applicationActivated(qSL("fg"));
+
+    QVector<Candidate> candidates {
+        { qSL("c"), Am::Running, false, 0 },
+        { qSL("b"), Am::Running, false, 0 },
+        { qSL("a"), Am::Running, false, 0 },
+    };
+    QCOMPARE(victim(policy, candidates, false), qSL("a"));
+
+    // re-activating moves an application to the back of the queue
+    policy.applicationActivated(qSL("a"));
+    policy.applicationActivated(qSL("fg"));
+    QCOMPARE(victim(policy, candidates, false), qSL("b"));
+
+    // applications that were never activated go first
+    candidates.append({ qSL("never"), Am::Running, false, 0 });
+    QCOMPARE(victim(policy, candidates, false), qSL("never"));
+}
+
+void tst_MemoryEvictionPolicy::highestPss()
+{
+    MemoryEvictionPolicy policy(QVariantMap { { qSL("lowThreshold"), 80 } });
+    policy.applicationActivated(qSL("a"));
+    policy.applicationActivated(qSL("b"));
+    policy.applicationActivated(qSL("c"));
+    policy.applicationActivated(qSL("fg"));
+
+    const QVector<Candidate> candidates {
+        { qSL("a"), Am::Running, false, 100 },
+        { qSL("b"), Am::Suspended, false, 300 },
+        { qSL("c"), Am::Running, false, 200 },
+    };
+    QCOMPARE(victim(policy, candidates, true), qSL("b"));
+    QCOMPARE(victim(policy, candidates, false), qSL("a"));
+}
+
+void tst_MemoryEvictionPolicy::exempt()
+{
+    MemoryEvictionPolicy policy(QVariantMap { { qSL("lowThreshold"), 80 },
+                                              { qSL("exempt"), QStringList { qSL("a"), qSL("b") } },
+                                              { qSL("priorities"), QVariantMap { { qSL("b"), -1 } } } });
+    policy.applicationActivated(qSL("a"));
+    policy.applicationActivated(qSL("b"));
+    policy.applicationActivated(qSL("c"));
+    policy.applicationActivated(qSL("fg"));
+
+    const QVector<Candidate> candidates {
+        { qSL("a"), Am::Running, false, 300 },
+        { qSL("b"), Am::Running, false, 200 },
+        { qSL("c"), Am::Running, false, 100 },
+    };
+    QCOMPARE(victim(policy, candidates, false), qSL("c"));
+    QCOMPARE(victim(policy, candidates, true), qSL("c"));
+}
+
+void tst_MemoryEvictionPolicy::foreground()
+{
+    MemoryEvictionPolicy policy(QVariantMap { { qSL("lowThreshold"), 80 },
+                                              { qSL("priorities"), QVariantMap { { qSL("fg"), -1 } } } });
+    policy.applicationActivated(qSL("fg"));
+    policy.applicationActivated(qSL("a"));
+    policy.applicationActivated(qSL("fg"));
+
+    const QVector<Candidate> candidates {
+        { qSL("fg"), Am::Running, false, 300 },
+        { qSL("a"), Am::Running, false, 100 },
+    };
+    QCOMPARE(victim(policy, candidates, false), qSL("a"));
+    QCOMPARE(victim(policy, candidates, true), qSL("a"));
+
+    // once another application is activated, the former foreground one is fair game again
+    policy.applicationActivated(qSL("a"));
+    QCOMPARE(victim(policy, candidates, false), qSL("fg"));
+}
+
+void tst_MemoryEvictionPolicy::suspend()
+{
+    MemoryEvictionPolicy policy(QVariantMap { { qSL("lowThreshold"), 80 },
+                                              { qSL("action"), qSL("suspend") } });
+    policy.applicationActivated(qSL("a"));
+    policy.applicationActivated(qSL("b"));
+    policy.applicationActivated(qSL("c"));
+    policy.applicationActivated(qSL("fg"));
+
+    const QVector<Candidate> candidates {
+        { qSL("a"), Am::Suspended, false, 300 },
+        { qSL("b"), Am::Running, true, 200 },
+        { qSL("c"), Am::Running, false, 100 },
+    };
+    bool suspend = false;
+    // already suspended and in-process applications cannot be suspended
+    QCOMPARE(victim(policy, candidates, false, &suspend), qSL("c"));
+    QVERIFY(suspend);
+
+    // suspending does not free any memory, so critical memory always stops
+    QCOMPARE(victim(policy, candidates, true, &suspend), qSL("a"));
+    QVERIFY(!suspend);
+}
+
+void tst_MemoryEvictionPolicy::suspendLimit()
+{
+    MemoryEvictionPolicy policy(QVariantMap { { qSL("lowThreshold"), 80 },
+                                              { qSL("action"), qSL("suspend") },
+                                              { qSL("maximumSuspended"), 2 } });
+    policy.applicationActivated(qSL("a"));
+    policy.applicationActivated(qSL("b"));
+    policy.applicationActivated(qSL("c"));
+    policy.applicationActivated(qSL("d"));
+    policy.applicationActivated(qSL("fg"));
+
+    QVector<Candidate> candidates {
+        { qSL("a"), Am::Running, false, 0 },
+        { qSL("b"), Am::Suspended, false, 0 },
+        { qSL("c"), Am::Running, false, 0 },
+        { qSL("d"), Am::Suspended, false, 0 },
+    };
+    bool suspend = false;
+    // the limit is reached: the least recently activated suspended application is stopped
+    QCOMPARE(victim(policy, candidates, false, &suspend), qSL("b"));
+    QVERIFY(!suspend);
+
+    // below the limit, running applications are suspended again
+    candidates[1].state = Am::NotRunning;
+    QCOMPARE(victim(policy, candidates, false, &suspend), qSL("a"));
+    QVERIFY(suspend);
+
+    // if all the suspended applications are exempt, a running one is stopped instead
+    MemoryEvictionPolicy exemptPolicy(QVariantMap { { qSL("lowThreshold"), 80 },
+                                                    { qSL("action"), qSL("suspend") },
+                                                    { qSL("maximumSuspended"), 1 },
+                                                    { qSL("exempt"), QStringList { qSL("d") } } });
+    QCOMPARE(victim(exemptPolicy, candidates, false, &suspend), qSL("a"));
+    QVERIFY(!suspend);
+}
+
+void tst_MemoryEvictionPolicy::noVictim()
+{
+    MemoryEvictionPolicy policy(QVariantMap { { qSL("lowThreshold"), 80 },
+                                              { qSL("exempt"), QStringList { qSL("a") } } });
+    policy.applicationActivated(qSL("b"));
+
+    const QVector<Candidate> candidates {
+        { qSL("a"), Am::Running, false, 0 },
+        { qSL("b"), Am::Running, false, 0 },
+        { qSL("c"), Am::StartingUp, false, 0 },
+        { qSL("d"), Am::ShuttingDown, false, 0 },
+    };
+    QCOMPARE(victim(policy, candidates, false), QString());
+    QCOMPARE(victim(policy, candidates, true), QString());
+}
+
+QTEST_APPLESS_MAIN(tst_MemoryEvictionPolicy)
+
+#include "tst_memoryevictionpolicy.moc"
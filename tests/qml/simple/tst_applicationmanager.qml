@@ -198,6 +198,7 @@ TestCase {
         compare(listView.currentItem.modelData.isRunning, false)
         compare(listView.currentItem.modelData.isStartingUp, false)
         compare(listView.currentItem.modelData.isShuttingDown, false)
+        compare(listView.currentItem.modelData.isSuspended, false)
         compare(listView.currentItem.modelData.isBlocked, false)
         compare(listView.currentItem.modelData.isUpdating, false)
         compare(listView.currentItem.modelData.isRemovable, false)
@@ -278,6 +279,7 @@ TestCase {
         compare(appData.isRunning, false)
         compare(appData.isStartingUp, false)
         compare(appData.isShuttingDown, false)
+        compare(appData.isSuspended, false)
         compare(appData.isBlocked, false)
         compare(appData.isUpdating, false)
         compare(appData.isRemovable, false)
@@ -428,6 +430,66 @@ TestCase {
         runStateChangedSpy.clear()
     }
 
+    SignalSpy {
+        id: applicationsStartedSpy
+        target: ApplicationManager
+        signalName: "applicationsStarted"
+    }
+
+    SignalSpy {
+        id: applicationsStoppedSpy
+        target: ApplicationManager
+        signalName: "applicationsStopped"
+    }
+
+    function test_startApplications() {
+        compare(ApplicationManager.application("tld.test.simple1").runState, Am.NotRunning);
+        compare(ApplicationManager.application("tld.test.simple2").runState, Am.NotRunning);
+
+        var batchId = ApplicationManager.startApplications([ "tld.test.simple1",
+                                                             { id: "tld.test.simple2", priority: 1 },
+                                                             "invalidApplication" ],
+                                                           { maximumConcurrentStarts: 1 });
+        verify(batchId !== "");
+
+        applicationsStartedSpy.wait(20000);
+        compare(applicationsStartedSpy.count, 1);
+        compare(applicationsStartedSpy.signalArguments[0][0], batchId);
+        var results = applicationsStartedSpy.signalArguments[0][1];
+        verify(results["tld.test.simple1"].started);
+        verify(results["tld.test.simple2"].started);
+        verify(!results["invalidApplication"].started);
+        applicationsStartedSpy.clear();
+
+        // only one app at a time was starting up, the one with the higher priority first
+        var args = runStateChangedSpy.signalArguments
+        compare(args.length, 4);
+        compare(args[0][0], "tld.test.simple2");
+        compare(args[0][1], Am.StartingUp);
+        compare(args[1][0], "tld.test.simple2");
+        compare(args[1][1], Am.Running);
+        compare(args[2][0], "tld.test.simple1");
+        compare(args[2][1], Am.StartingUp);
+        compare(args[3][0], "tld.test.simple1");
+        compare(args[3][1], Am.Running);
+        runStateChangedSpy.clear();
+
+        ApplicationManager.stopAllApplications(true);
+        while (runStateChangedSpy.count < 4)
+            runStateChangedSpy.wait(10000);
+        runStateChangedSpy.clear();
+
+        if (!applicationsStoppedSpy.count)
+            applicationsStoppedSpy.wait(10000);
+        compare(applicationsStoppedSpy.count, 1);
+        results = applicationsStoppedSpy.signalArguments[0][0];
+        verify(results["tld.test.simple1"].stopTime >= 0);
+        verify(results["tld.test.simple2"].stopTime >= 0);
+        verify(!results["tld.test.simple1"].killed);
+        verify(!results["tld.test.simple2"].killed);
+        applicationsStoppedSpy.clear();
+    }
+
     function test_errors() {
         ignoreWarning("ApplicationManager::application(index): invalid index: -1");
         verify(!ApplicationManager.application(-1));
@@ -436,6 +498,9 @@ TestCase {
         compare(ApplicationManager.get(-1), {});
         compare(ApplicationManager.get("invalidApplication"), {});
         compare(ApplicationManager.applicationRunState("invalidApplication"), Am.NotRunning);
+        verify(!ApplicationManager.suspendApplication("invalidApplication"));
+        verify(!ApplicationManager.resumeApplication("invalidApplication"));
+        verify(!ApplicationManager.suspendApplication(simpleApplication.id));
 
         ignoreWarning("Cannot start an invalid application");
         verify(!ApplicationManager.startApplication("invalidApplication"))
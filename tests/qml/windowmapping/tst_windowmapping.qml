@@ -289,6 +289,33 @@ TestCase {
         compare(runStateChangedSpy.signalArguments[1][1], Am.NotRunning);
     }
 
+    function test_wayland_ping_pong_suspended() {
+        var app = ApplicationManager.application("test.winmap.amwin");
+
+        if (ApplicationManager.singleProcess)
+            skip("Wayland ping-pong is only supported in multi-process mode");
+
+        app.start("show-main");
+        tryCompare(app, "runState", Am.Running);
+        tryCompare(windowAddedSpy, "count", 1);
+
+        if (!ApplicationManager.suspendApplication(app.id))
+            skip("Suspending applications needs a writable cgroup freezer");
+        compare(app.runState, Am.Suspended);
+
+        // a frozen client cannot answer pings, but must not be killed for it
+        runStateChangedSpy.clear();
+        wait(4000);
+        compare(runStateChangedSpy.count, 0);
+        compare(app.runState, Am.Suspended);
+
+        // ... while the watchdog is active again after resuming
+        verify(ApplicationManager.resumeApplication(app.id));
+        compare(app.runState, Am.Running);
+        wait(4000);
+        compare(app.runState, Am.Running);
+    }
+
     function test_window_properties() {
         var app = ApplicationManager.application("test.winmap.amwin");
 
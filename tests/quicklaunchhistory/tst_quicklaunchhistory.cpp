@@ -0,0 +1,224 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore>
+#include <QtTest>
+#include <QtAppManManager/quicklaunchhistory.h>
+
+QT_USE_NAMESPACE_AM
+
+typedef QuickLaunchHistory::Key Key;
+
+static const Key qml { qSL("process"), qSL("qml") };
+static const Key native { qSL("process"), qSL("native") };
+
+class tst_QuickLaunchHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QuickLaunchHistory();
+
+private slots:
+    void phases();
+    void demand();
+    void noHistory();
+    void perPhaseTargets();
+    void budget();
+    void persistence();
+    void invalidData();
+
+private:
+    QuickLaunchHistory history(int qmlTakes, int qmlPhase, int nativeTakes, int nativePhase);
+};
+
+tst_QuickLaunchHistory::tst_QuickLaunchHistory()
+{ }
+
+QuickLaunchHistory tst_QuickLaunchHistory::history(int qmlTakes, int qmlPhase, int nativeTakes,
+                                                   int nativePhase)
+{
+    QuickLaunchHistory h;
+    for (int i = 0; i < qmlTakes; ++i)
+        h.recordTake(qml, qmlPhase);
+    for (int i = 0; i < nativeTakes; ++i)
+        h.recordTake(native, nativePhase);
+    return h;
+}
+
+void tst_QuickLaunchHistory::phases()
+{
+    QCOMPARE(QuickLaunchHistory::phaseAt(0), 0);
+    QCOMPARE(QuickLaunchHistory::phaseAt(QuickLaunchHistory::phaseEnd(0) - 1), 0);
+    QCOMPARE(QuickLaunchHistory::phaseAt(QuickLaunchHistory::phaseEnd(0)), 1);
+    QCOMPARE(QuickLaunchHistory::phaseAt(QuickLaunchHistory::phaseEnd(1)), 2);
+    QCOMPARE(QuickLaunchHistory::phaseAt(QuickLaunchHistory::phaseEnd(2)), 3);
+    QCOMPARE(QuickLaunchHistory::phaseAt(24 * 60 * 60 * 1000), QuickLaunchHistory::PhaseCount - 1);
+    QCOMPARE(QuickLaunchHistory::phaseEnd(QuickLaunchHistory::PhaseCount - 1), qint64(-1));
+
+    for (int phase = 1; phase < QuickLaunchHistory::PhaseCount - 1; ++phase)
+        QVERIFY(QuickLaunchHistory::phaseEnd(phase) > QuickLaunchHistory::phaseEnd(phase - 1));
+}
+
+void tst_QuickLaunchHistory::demand()
+{
+    const QuickLaunchHistory h = history(4, 0, 0, 0);
+    QCOMPARE(h.size(), 1);
+    QCOMPARE(h.takes(qml, 0), qreal(4));
+    QCOMPARE(h.takes(qml, 1), qreal(0));
+    QCOMPARE(h.takes(native, 0), qreal(0));
+
+    // launches in other phases only count partially
+    QCOMPARE(h.demand(qml, 0), qreal(4));
+    QCOMPARE(h.demand(qml, 1), qreal(1));
+    QCOMPARE(h.demand(native, 0), qreal(0));
+}
+
+void tst_QuickLaunchHistory::noHistory()
+{
+    const QuickLaunchHistory h;
+    QVERIFY(h.isEmpty());
+
+    // without any history, the configured maximums are used
+    QCOMPARE(h.targets({ qml, native }, { 3, 2 }, 0), QVector<int>({ 3, 2 }));
+
+    // ... unless they exceed the budget
+    const QVector<int> targets = h.targets({ qml, native }, { 3, 2 }, 0, 4);
+    QCOMPARE(targets.size(), 2);
+    QCOMPARE(targets.at(0) + targets.at(1), 4);
+}
+
+void tst_QuickLaunchHistory::perPhaseTargets()
+{
+    // qml apps are started right after boot, native ones a bit later
+    const QuickLaunchHistory h = history(4, 0, 4, 1);
+    const QVector<Key> keys { qml, native };
+    const QVector<int> maximums { 3, 3 };
+
+    QCOMPARE(h.targets(keys, maximums, 0), QVector<int>({ 3, 2 }));
+    QCOMPARE(h.targets(keys, maximums, 1), QVector<int>({ 2, 3 }));
+    QCOMPARE(h.targets(keys, maximums, 2), QVector<int>({ 3, 3 }));
+
+    // the maximum is never exceeded, even if the demand is much higher
+    QCOMPARE(h.targets(keys, { 1, 3 }, 0), QVector<int>({ 1, 1 }));
+
+    // combinations that were never used do not get any runtimes
+    QCOMPARE(history(4, 0, 0, 0).targets(keys, maximums, 0), QVector<int>({ 3, 0 }));
+}
+
+void tst_QuickLaunchHistory::budget()
+{
+    const QuickLaunchHistory h = history(4, 0, 4, 1);
+    const QVector<Key> keys { qml, native };
+    const QVector<int> maximums { 3, 3 };
+
+    // the rounding excess is taken from the least used combination
+    QCOMPARE(h.targets(keys, maximums, 0, 2), QVector<int>({ 2, 0 }));
+    QCOMPARE(h.targets(keys, maximums, 1, 2), QVector<int>({ 0, 2 }));
+    QCOMPARE(h.targets(keys, maximums, 0, 4), QVector<int>({ 3, 1 }));
+    QCOMPARE(h.targets(keys, maximums, 0, 0), QVector<int>({ 0, 0 }));
+
+    // a budget above the sum of the maximums does not change anything
+    QCOMPARE(h.targets(keys, maximums, 0, 100), h.targets(keys, maximums, 0));
+}
+
+void tst_QuickLaunchHistory::persistence()
+{
+    const QuickLaunchHistory h = history(4, 0, 2, 3);
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    QVERIFY(h.save(&buffer));
+
+    // every load decays the history of the previous sessions
+    QuickLaunchHistory loaded;
+    QVERIFY(buffer.seek(0));
+    QVERIFY(loaded.load(&buffer));
+    QCOMPARE(loaded.size(), 2);
+    QCOMPARE(loaded.takes(qml, 0), qreal(4 * 0.9));
+    QCOMPARE(loaded.takes(native, 3), qreal(2 * 0.9));
+    QCOMPARE(loaded.takes(native, 0), qreal(0));
+
+    // the targets only depend on the relative demands, which are not affected by the decay
+    const QVector<Key> keys { qml, native };
+    QCOMPARE(loaded.targets(keys, { 3, 3 }, 0), h.targets(keys, { 3, 3 }, 0));
+
+    loaded.recordTake(qml, 0);
+    buffer.buffer().clear();
+    QVERIFY(buffer.seek(0));
+    QVERIFY(loaded.save(&buffer));
+
+    QuickLaunchHistory reloaded;
+    QVERIFY(buffer.seek(0));
+    QVERIFY(reloaded.load(&buffer));
+    QCOMPARE(reloaded.takes(qml, 0), qreal((4 * 0.9 + 1) * 0.9));
+    QCOMPARE(reloaded.takes(native, 3), qreal(2 * 0.9 * 0.9));
+}
+
+void tst_QuickLaunchHistory::invalidData()
+{
+    QByteArray data;
+    {
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::WriteOnly));
+        QVERIFY(history(4, 0, 2, 3).save(&buffer));
+    }
+
+    QuickLaunchHistory h = history(1, 1, 0, 0);
+
+    // truncated data must not change the existing history
+    QByteArray truncated = data.left(data.size() - 1);
+    QBuffer truncatedBuffer(&truncated);
+    QVERIFY(truncatedBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(!h.load(&truncatedBuffer));
+    QCOMPARE(h.size(), 1);
+    QCOMPARE(h.takes(qml, 1), qreal(1));
+
+    // neither must data of a different version
+    QByteArray otherVersion = data;
+    {
+        QBuffer buffer(&otherVersion);
+        QVERIFY(buffer.open(QIODevice::ReadWrite));
+        QDataStream ds(&buffer);
+        ds << quint32(0);
+    }
+    QBuffer otherVersionBuffer(&otherVersion);
+    QVERIFY(otherVersionBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(!h.load(&otherVersionBuffer));
+    QCOMPARE(h.size(), 1);
+
+    QBuffer emptyBuffer;
+    QVERIFY(emptyBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(!h.load(&emptyBuffer));
+    QCOMPARE(h.size(), 1);
+}
+
+QTEST_APPLESS_MAIN(tst_QuickLaunchHistory)
+
+#include "tst_quicklaunchhistory.moc"
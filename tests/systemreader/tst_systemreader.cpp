@@ -45,6 +45,10 @@ private slots:
     void cgroupProcessInfo();
     void memoryReaderReadUsedValue();
     void memoryReaderGroupLimit();
+    void cgroupV2ProcessInfo();
+    void cgroupV2MemoryReaderReadUsedValue();
+    void cgroupV2MemoryReaderGroupLimit();
+    void memoryWatcherRisingEdge();
 };
 
 tst_SystemReader::tst_SystemReader()
@@ -72,6 +76,76 @@ void tst_SystemReader::memoryReaderGroupLimit()
     QCOMPARE(value, Q_UINT64_C(524288000));
 }
 
-QTEST_APPLESS_MAIN(tst_SystemReader)
+void tst_SystemReader::cgroupV2ProcessInfo()
+{
+    g_systemRootDir = QFINDTESTDATA("root-v2");
+    QVERIFY(isCGroupV2());
+    auto map = fetchCGroupProcessInfo(1234);
+    QCOMPARE(map[""], QByteArray("/app.slice/app-1.scope"));
+    g_systemRootDir = QFINDTESTDATA("root");
+    QVERIFY(!isCGroupV2());
+}
+
+void tst_SystemReader::cgroupV2MemoryReaderReadUsedValue()
+{
+    g_systemRootDir = QFINDTESTDATA("root-v2");
+    MemoryReader groupReader(qSL("/app.slice/app-1.scope"));
+    QCOMPARE(groupReader.readUsedValue(), Q_UINT64_C(41943040));
+
+    // the root group falls back to /proc/meminfo
+    MemoryReader rootReader;
+    QCOMPARE(rootReader.readUsedValue(), Q_UINT64_C(2000000) * 1024);
+    g_systemRootDir = QFINDTESTDATA("root");
+}
+
+void tst_SystemReader::cgroupV2MemoryReaderGroupLimit()
+{
+    g_systemRootDir = QFINDTESTDATA("root-v2");
+    MemoryReader memoryReader(qSL("/app.slice/app-1.scope"));
+    quint64 value = memoryReader.groupLimit();
+    QCOMPARE(value, qMin(Q_UINT64_C(268435456), memoryReader.totalValue()));
+    g_systemRootDir = QFINDTESTDATA("root");
+}
+
+void tst_SystemReader::memoryWatcherRisingEdge()
+{
+    g_systemRootDir = QFINDTESTDATA("root-v2");
+    MemoryReader memoryReader(qSL("/app.slice/app-1.scope"));
+    const qreal percentUsed = qreal(memoryReader.readUsedValue()) / memoryReader.groupLimit() * 100;
+
+    MemoryWatcher watcher(nullptr);
+    watcher.setThresholds(percentUsed / 2, qMin(percentUsed * 2, qreal(100)));
+    watcher.startWatching(qSL("/app.slice/app-1.scope"));
+
+    // the state has to be up-to-date already, when the signals are emitted
+    int lowCount = 0;
+    int criticalCount = 0;
+    connect(&watcher, &MemoryWatcher::memoryLow, this, [&]() {
+        ++lowCount;
+        QVERIFY(watcher.isMemoryLow());
+        QVERIFY(!watcher.isMemoryCritical());
+    });
+    connect(&watcher, &MemoryWatcher::memoryCritical, this, [&]() {
+        ++criticalCount;
+        QVERIFY(watcher.isMemoryCritical());
+    });
+
+    watcher.checkMemoryConsumption();
+    QCOMPARE(lowCount, 1);
+    QCOMPARE(criticalCount, 0);
+
+    // no new signal without a new crossing
+    watcher.checkMemoryConsumption();
+    QCOMPARE(lowCount, 1);
+
+    watcher.setThresholds(percentUsed / 4, percentUsed / 2);
+    watcher.checkMemoryConsumption();
+    QCOMPARE(lowCount, 1);
+    QCOMPARE(criticalCount, 1);
+
+    g_systemRootDir = QFINDTESTDATA("root");
+}
+
+QTEST_GUILESS_MAIN(tst_SystemReader)
 
 #include "tst_systemreader.moc"
@@ -5,9 +5,12 @@ SUBDIRS = \
     applicationinfo \
     main \
     runtime \
+    launchstatistics \
+    quicklaunchhistory \
     cryptography \
     signature \
     utilities \
+    yaml \
     installationreport \
     packagecreator \
     packageextractor \
@@ -20,6 +23,7 @@ linux*:SUBDIRS += \
     sudo \
     processreader \
     systemreader \
+    memoryevictionpolicy \
 
 OTHER_FILES += \
     tests.pri \
@@ -0,0 +1,382 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 Luxoft Sweden AB
+** Copyright (C) 2018 Pelagicore AG
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Luxoft Application Manager.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT-QTAS$
+** Commercial License Usage
+** Licensees holding valid commercial Qt Automotive Suite licenses may use
+** this file in accordance with the commercial license agreement provided
+** with the Software or, alternatively, in accordance with the terms
+** contained in a written agreement between you and The Qt Company.  For
+** licensing terms and conditions see https://www.qt.io/terms-conditions.
+** For further information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore>
+#include <QtTest>
+
+#include "global.h"
+#include "qtyaml.h"
+#include "exception.h"
+
+QT_USE_NAMESPACE_AM
+
+class tst_Yaml : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_Yaml();
+
+private:
+    QTemporaryDir m_cacheDir;
+
+private slots:
+    void scalars_data();
+    void scalars();
+    void numbersMatchReference();
+    void benchmarkNumbers();
+    void parser();
+    void parserFields();
+    void parserAliases();
+    void parserCacheVerification();
+};
+
+
+// this is the regexp based number conversion that was used before the hand-written parser:
+// the parser must produce exactly the same results
+static QVariant referenceScalar(const QByteArray &ba)
+{
+    QString str = QString::fromUtf8(ba);
+    QVariant result = str;
+    char firstChar = ba.isEmpty() ? 0 : ba.at(0);
+
+    if ((firstChar >= '0' && firstChar <= '9') || firstChar == '+' || firstChar == '-' || firstChar == '.') {
+        static const QRegExp numberRegExps[] = {
+            QRegExp(qSL("[-+]?0b[0-1_]+")),        // binary
+            QRegExp(qSL("[-+]?0x[0-9a-fA-F_]+")),  // hexadecimal
+            QRegExp(qSL("[-+]?0[0-7_]+")),         // octal
+            QRegExp(qSL("[-+]?(0|[1-9][0-9_]*)")), // decimal
+            QRegExp(qSL("[-+]?([0-9][0-9_]*)?\\.[0-9.]*([eE][-+][0-9]+)?")), // float
+            QRegExp()
+        };
+
+        for (int numberIndex = 0; !numberRegExps[numberIndex].isEmpty(); ++numberIndex) {
+            if (numberRegExps[numberIndex].exactMatch(str)) {
+                bool ok = false;
+                QVariant val;
+
+                if (str.contains(qL1C('_')))
+                    str = str.replace(qL1C('_'), qSL(""));
+
+                if (numberIndex == 4) {
+                    val = str.toDouble(&ok);
+                } else {
+                    int base = 10;
+
+                    switch (numberIndex) {
+                    case 0: base = 2; str.replace(qSL("0b"), qSL("")); break;
+                    case 1: base = 16; break;
+                    case 2: base = 8; break;
+                    case 3: base = 10; break;
+                    }
+
+                    qint64 s64 = str.toLongLong(&ok, base);
+                    if (ok && (s64 <= std::numeric_limits<qint32>::max())) {
+                        val = qint32(s64);
+                    } else if (ok) {
+                        val = s64;
+                    } else {
+                        quint64 u64 = str.toULongLong(&ok, base);
+
+                        if (ok && (u64 <= std::numeric_limits<quint32>::max()))
+                            val = quint32(u64);
+                        else if (ok)
+                            val = u64;
+                    }
+                }
+                if (ok) {
+                    result = val;
+                    break;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static QVariant parseScalar(const QByteArray &scalar)
+{
+    QtYaml::ParseError error;
+    auto docs = QtYaml::variantDocumentsFromYaml("value: " + scalar, &error);
+    if ((error.error != QJsonParseError::NoError) || (docs.size() != 1))
+        return QVariant(qSL("<parse error>"));
+    return docs.constFirst().toMap().value(qSL("value"));
+}
+
+static QByteArray numbersDocument(int count)
+{
+    static const char *scalars[] = {
+        "0", "-1", "+42", "1_000_000", "0b1010_1010", "-0b11", "0x7fFF_ffff", "0xdeadbeef",
+        "017", "-0_777", "3.1415", "-.5", "1.5e+10", "2147483648", "-9223372036854775808",
+        "18446744073709551615", "1.2.3", "08", "0x", "1e5", "string", "v1.0"
+    };
+    const int scalarCount = int(sizeof(scalars) / sizeof(scalars[0]));
+
+    QByteArray yaml = "formatVersion: 1\nformatType: am-application\n---\nnumbers:\n";
+    for (int i = 0; i < count; ++i)
+        yaml = yaml + "- " + scalars[i % scalarCount] + '\n';
+    return yaml;
+}
+
+
+tst_Yaml::tst_Yaml()
+{
+    // the YamlParser event cache must not end up in the user's cache directory
+    qputenv("XDG_CACHE_HOME", m_cacheDir.path().toLocal8Bit());
+}
+
+void tst_Yaml::scalars_data()
+{
+    QTest::addColumn<QByteArray>("scalar");
+    QTest::addColumn<QVariant>("value");
+
+    QTest::newRow("zero")       << QByteArray("0")            << QVariant(qint32(0));
+    QTest::newRow("negative")   << QByteArray("-12")          << QVariant(qint32(-12));
+    QTest::newRow("grouping")   << QByteArray("+1_000")       << QVariant(qint32(1000));
+    QTest::newRow("binary")     << QByteArray("0b1_01")       << QVariant(qint32(5));
+    QTest::newRow("neg-binary") << QByteArray("-0b11")        << QVariant(qint32(-3));
+    QTest::newRow("octal")      << QByteArray("017")          << QVariant(qint32(15));
+    QTest::newRow("hex")        << QByteArray("0xfF")         << QVariant(qint32(255));
+    QTest::newRow("int64")      << QByteArray("2147483648")   << QVariant(qint64(2147483648LL));
+    QTest::newRow("uint64")     << QByteArray("0xffffffffffffffff") << QVariant(std::numeric_limits<quint64>::max());
+    QTest::newRow("overflow")   << QByteArray("18446744073709551616") << QVariant(qSL("18446744073709551616"));
+    QTest::newRow("float")      << QByteArray("1_0.25")       << QVariant(10.25);
+    QTest::newRow("float-dot")  << QByteArray("-.5")          << QVariant(-0.5);
+    QTest::newRow("float-exp")  << QByteArray("1.5e+3")       << QVariant(1500.);
+    QTest::newRow("no-exp-sign") << QByteArray("1.5e3")       << QVariant(qSL("1.5e3"));
+    QTest::newRow("bad-octal")  << QByteArray("08")           << QVariant(qSL("08"));
+    QTest::newRow("bad-hex")    << QByteArray("0x_")          << QVariant(qSL("0x_"));
+    QTest::newRow("version")    << QByteArray("1.2.3")        << QVariant(qSL("1.2.3"));
+    QTest::newRow("true")       << QByteArray("yes")          << QVariant(true);
+    QTest::newRow("quoted")     << QByteArray("'42'")         << QVariant(qSL("42"));
+}
+
+void tst_Yaml::scalars()
+{
+    QFETCH(QByteArray, scalar);
+    QFETCH(QVariant, value);
+
+    QVariant parsed = parseScalar(scalar);
+    QCOMPARE(parsed.userType(), value.userType());
+    QCOMPARE(parsed, value);
+}
+
+void tst_Yaml::numbersMatchReference()
+{
+    // all combinations of up to 4 characters that are significant for numbers
+    static const char chars[] = "0178_abfxX.eE+-";
+    const int charCount = int(sizeof(chars)) - 1;
+
+    QByteArray scalar;
+    QString mismatch;
+    std::function<void(int)> check = [&](int depth) {
+        if (!scalar.isEmpty() && mismatch.isEmpty()) {
+            QVariant expected = referenceScalar(scalar);
+            QVariant parsed = parseScalar(scalar);
+
+            // libyaml itself refuses some of these (e.g. a single '-')
+            if ((parsed != QVariant(qSL("<parse error>")))
+                    && ((parsed.userType() != expected.userType()) || (parsed != expected))) {
+                mismatch = QString::fromLatin1("scalar %1 was converted to %2 (%3) instead of %4 (%5)")
+                        .arg(QString::fromLatin1(scalar))
+                        .arg(parsed.toString()).arg(qL1S(parsed.typeName()))
+                        .arg(expected.toString()).arg(qL1S(expected.typeName()));
+            }
+        }
+        if (depth == 0)
+            return;
+        for (int i = 0; i < charCount; ++i) {
+            scalar.append(chars[i]);
+            check(depth - 1);
+            scalar.chop(1);
+        }
+    };
+    check(4);
+    QVERIFY2(mismatch.isEmpty(), qPrintable(mismatch));
+
+    const char *bigNumbers[] = {
+        "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296",
+        "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+        "18446744073709551615", "18446744073709551616", "0x7fffffffffffffff", "0x8000000000000000",
+        "-0x8000000000000000", "0b" "1111111111111111111111111111111111111111111111111111111111111111",
+        "0b" "10000000000000000000000000000000000000000000000000000000000000000",
+        "01777777777777777777777", "02000000000000000000000", "1_2_3.4_5", "123456789.123456789e+300"
+    };
+    for (const char *bigNumber : bigNumbers) {
+        QVariant expected = referenceScalar(bigNumber);
+        QVariant parsed = parseScalar(bigNumber);
+        QCOMPARE(parsed.userType(), expected.userType());
+        QCOMPARE(parsed, expected);
+    }
+}
+
+void tst_Yaml::benchmarkNumbers()
+{
+    QByteArray yaml = numbersDocument(200);
+
+    QBENCHMARK {
+        QtYaml::variantDocumentsFromYaml(yaml);
+    }
+}
+
+void tst_Yaml::parser()
+{
+    QByteArray yaml = numbersDocument(50)
+            + "nested:\n  list: [ 1, 'two', { three: 3 } ]\n  empty:\n"
+            + "---\nsecond: 'document'\n";
+    const QVector<QVariant> expected = QtYaml::variantDocumentsFromYaml(yaml);
+    QCOMPARE(expected.size(), 3);
+
+    // the first run goes through libyaml, the second one replays the cached events
+    for (int run = 0; run < 2; ++run) {
+        YamlParser p(yaml);
+        QVector<QVariant> docs;
+        while (p.nextDocument())
+            docs << p.parseVariant();
+        QCOMPARE(docs, expected);
+    }
+
+    try {
+        YamlParser p("key: [ 1, 2");
+        while (p.nextDocument())
+            p.parseVariant();
+        QFAIL("expected a parse error");
+    } catch (const Exception &e) {
+        QVERIFY(e.errorString().startsWith(qSL("YAML parse error at line")));
+    }
+}
+
+void tst_Yaml::parserFields()
+{
+    QString name;
+    QStringList list;
+    auto parseFields = [&name, &list](const QByteArray &yaml) {
+        YamlParser p(yaml);
+        p.checkHeader({ "test" }, 1);
+        if (!p.nextDocument())
+            throw Exception("missing document");
+        p.parseFields({
+            { "name", true, YamlParser::Scalar, [&name](YamlParser *p) {
+                name = p->parseString(); } },
+            { "list", false, YamlParser::Scalar | YamlParser::List, [&list](YamlParser *p) {
+                list = p->parseStringOrStringList(); } }
+        });
+        if (p.nextDocument())
+            throw Exception("too many documents");
+    };
+
+    parseFields("formatType: test\nformatVersion: 1\n---\nname: foo\nlist: [ a, b ]\n");
+    QCOMPARE(name, qSL("foo"));
+    QCOMPARE(list, QStringList({ qSL("a"), qSL("b") }));
+
+    parseFields("formatType: test\nformatVersion: 1\n---\nname: bar\nlist: c\n");
+    QCOMPARE(name, qSL("bar"));
+    QCOMPARE(list, QStringList({ qSL("c") }));
+
+    QVERIFY_EXCEPTION_THROWN(parseFields("formatType: test\nformatVersion: 2\n---\nname: foo\n"), Exception);
+    QVERIFY_EXCEPTION_THROWN(parseFields("formatType: test\nformatVersion: 1\n---\nlist: a\n"), Exception);
+    QVERIFY_EXCEPTION_THROWN(parseFields("formatType: test\nformatVersion: 1\n---\nname: foo\nfoo: bar\n"), Exception);
+    QVERIFY_EXCEPTION_THROWN(parseFields("formatType: test\nformatVersion: 1\n---\nname: [ foo ]\n"), Exception);
+}
+
+void tst_Yaml::parserAliases()
+{
+    QByteArray yaml = "defaults: &defaults\n  name: &name 'foo'\n  list: &list [ a, { b: *name } ]\n"
+                      "copy: *defaults\nname: *name\nlists: [ *list, *list ]\n"
+                      "---\nredefined: &name 42\nname: *name\n";
+    const QVector<QVariant> expected = QtYaml::variantDocumentsFromYaml(yaml);
+    QCOMPARE(expected.size(), 2);
+
+    // the cached events have the aliases resolved already
+    for (int run = 0; run < 2; ++run) {
+        YamlParser p(yaml);
+        QVector<QVariant> docs;
+        while (p.nextDocument())
+            docs << p.parseVariant();
+        QCOMPARE(docs, expected);
+    }
+
+    try {
+        YamlParser p("a: &a [ 1 ]\n---\nb: *a\n");
+        while (p.nextDocument())
+            p.parseVariant();
+        QFAIL("expected a parse error");
+    } catch (const Exception &e) {
+        QVERIFY(e.errorString().contains(qSL("unknown YAML alias 'a'")));
+    }
+
+    // "billion laughs": 10 levels of 10 aliases each
+    QByteArray bomb = "l0: &l0 [ 'lol' ]\n";
+    for (int i = 1; i < 10; ++i) {
+        bomb += "l" + QByteArray::number(i) + ": &l" + QByteArray::number(i) + " [ ";
+        for (int j = 0; j < 10; ++j)
+            bomb += "*l" + QByteArray::number(i - 1) + (j < 9 ? ", " : " ]\n");
+    }
+    try {
+        YamlParser p(bomb, QString(), YamlParser::NoCache);
+        while (p.nextDocument())
+            p.parseVariant();
+        QFAIL("expected a parse error");
+    } catch (const Exception &e) {
+        QVERIFY(e.errorString().contains(qSL("YAML aliases expand to more than")));
+    }
+}
+
+void tst_Yaml::parserCacheVerification()
+{
+    const QByteArray yaml1 = "capabilities: [ 'none' ]\n";
+    const QByteArray yaml2 = "capabilities: [ 'all' ]\n";
+    const QString cacheDir = m_cacheDir.path() + qSL("/qtapplicationmanager/yaml/");
+    auto cacheFileName = [cacheDir](const QByteArray &yaml) {
+        return cacheDir + QString::fromLatin1(QCryptographicHash::hash(yaml, QCryptographicHash::Sha1).toHex());
+    };
+    auto parse = [](const QByteArray &yaml) {
+        YamlParser p(yaml);
+        return p.nextDocument() ? p.parseVariant() : QVariant();
+    };
+
+    const QVariant expected2 = parse(yaml2);
+    parse(yaml1);
+    QVERIFY(QFile::exists(cacheFileName(yaml1)));
+    QVERIFY(QFile::exists(cacheFileName(yaml2)));
+
+    // nobody else may write to the cache
+    QCOMPARE(QFileInfo(cacheDir).permissions() & (QFileDevice::WriteGroup | QFileDevice::WriteOther),
+             QFileDevice::Permissions());
+
+    // an entry that was parsed from different content must not be replayed
+    QVERIFY(QFile::remove(cacheFileName(yaml2)));
+    QVERIFY(QFile::copy(cacheFileName(yaml1), cacheFileName(yaml2)));
+    QCOMPARE(parse(yaml2), expected2);
+}
+
+QTEST_APPLESS_MAIN(tst_Yaml)
+
+#include "tst_yaml.moc"